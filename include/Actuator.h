@@ -6,23 +6,65 @@
 #ifndef ACTUATOR_H
 #define ACTUATOR_H
 
-#include <ESP32Servo.h>
+#include "DataStructures.h"
+#include "DShotESC.h"
+#include <driver/ledc.h>
+#include <memory>
 
+/**
+ * @brief Classe per la gestione di un attuatore tramite la periferica LEDC.
+ *
+ * Genera direttamente il segnale di comando alla frequenza del protocollo scelto
+ * (servo a 50/333/560 Hz, ESC OneShot125 o Multishot). I valori PWM restano espressi
+ * nella scala standard 1000-2000 µs e vengono convertiti nella durata reale dell'impulso.
+ * Con i protocolli DShot il segnale viene invece generato da un `DShotESC`.
+ */
 class Actuator
 {
 protected:
-    Servo actuator; ///< Oggetto Servo associato all'attuatore.
-    int pin;        ///< Pin associato all'attuatore.
+    int pin;                    ///< Pin associato all'attuatore.
+    ledc_channel_t channel;     ///< Canale LEDC associato all'attuatore.
+    ledc_timer_t timer;         ///< Timer LEDC che genera il periodo PWM.
+    ACTUATOR_PROTOCOL protocol; ///< Protocollo di uscita.
     int pwm_min, pwm_max, pwm_null;
     double digital_min, digital_max;
 
+    float ticks_per_us; ///< Tick LEDC per microsecondo di impulso.
+    float pulse_scale;  ///< Fattore di scala dalla scala standard alla durata reale dell'impulso.
+    float pulse_offset; ///< Offset (µs) dalla scala standard alla durata reale dell'impulso.
+    float pwm_per_unit; ///< Fattore di conversione da valore digitale a PWM, precalcolato.
+
+    std::unique_ptr<DShotESC> dshot; ///< Driver DShot (solo per i protocolli DShot).
+
+    uint32_t applied_duty = UINT32_MAX; ///< Duty attualmente caricato nel canale LEDC.
+    uint32_t staged_duty = 0;           ///< Duty preparato per il prossimo commit.
+    uint16_t staged_dshot = 0;          ///< Valore DShot preparato per il prossimo commit.
+    bool valid = false;                 ///< Configurazione riuscita: altrimenti le scritture vengono ignorate.
+
+    /**
+     * @brief Memorizza i limiti e precalcola la conversione da valore digitale a PWM.
+     */
+    void set_limits(int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max);
+
 public:
     /**
-     * @brief Costruttore della classe Actuator.
+     * @brief Costruttore di un attuatore comandato dalla periferica LEDC.
      *
      * @param pin Pin associato all'attuatore.
+     * @param channel Canale LEDC associato all'attuatore.
+     * @param timer Timer LEDC; attuatori che condividono un timer devono usare lo stesso protocollo.
+     * @param protocol Protocollo di uscita (servo, OneShot125 o Multishot).
      */
-    explicit Actuator(int pin, int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max);
+    explicit Actuator(int pin, int channel, int timer, ACTUATOR_PROTOCOL protocol, int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max);
+
+    /**
+     * @brief Costruttore di un ESC comandato in DShot dalla periferica RMT.
+     *
+     * @param pin Pin associato all'ESC.
+     * @param rmt Canali RMT di trasmissione e di ricezione della telemetria.
+     * @param protocol Protocollo DShot (DSHOT300 o DSHOT600).
+     */
+    explicit Actuator(int pin, RmtChannels rmt, ACTUATOR_PROTOCOL protocol, int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max);
 
     /**
      * @brief Imposta il valore del segnale PWM per l'attuatore.
@@ -30,6 +72,61 @@ public:
      * @param value Valore del segnale PWM (0-1).
      */
     void write(double value);
+
+    /**
+     * @brief Scrive un impulso espresso nella scala standard 1000-2000 µs.
+     *
+     * @param pwm_value Valore PWM nella scala standard.
+     */
+    void write_pwm(int pwm_value);
+
+    /**
+     * @brief Prepara un impulso senza scriverlo sulla periferica.
+     *
+     * @param pwm_value Valore PWM nella scala standard.
+     * @return true Se il valore richiede una scrittura (sempre vero per DShot, che va trasmesso a
+     *         ogni ciclo; mai per un attuatore non configurato).
+     */
+    bool stage(int pwm_value);
+
+    /**
+     * @brief Carica nel registro di confronto il duty preparato con `stage`.
+     *
+     * Per i canali LEDC scrive solo i registri del canale (nessuna chiamata al driver), quindi
+     * può essere usata in una sezione critica; il valore non è ancora attivo finché non viene
+     * chiamato `latch`. Per DShot trasmette il frame.
+     */
+    void apply();
+
+    /**
+     * @brief Rende attivo il duty caricato, a partire dal prossimo inizio periodo del timer del canale.
+     *
+     * Scrive solo i registri del canale, come `apply`.
+     */
+    void latch();
+
+    /**
+     * @brief Indica se l'attuatore è stato configurato (protocollo adatto all'uscita, periferica pronta).
+     */
+    bool is_valid() const { return valid; }
+
+    /**
+     * @brief Indica se l'attuatore usa il protocollo DShot.
+     */
+    bool is_dshot() const { return dshot != nullptr; }
+
+    /**
+     * @brief Legge i giri del motore dalla telemetria DShot.
+     *
+     * @param rpm Giri al minuto del motore.
+     * @return true Se è disponibile una lettura valida.
+     */
+    bool read_rpm(float &rpm) const;
+
+    /**
+     * @brief Indica se l'attuatore fornisce telemetria RPM.
+     */
+    bool has_telemetry() const { return dshot != nullptr && DSHOT_BIDIRECTIONAL; }
 };
 
 
@@ -11,6 +11,9 @@
 #include "Receiver.h"
 #include "LED.h"
 #include "Actuator.h"
+#include "Mixer.h"
+#include "OutputStage.h"
+#include "Telemetry.h"
 
 /**
  * @brief Classe principale per la gestione dell'aereo.
@@ -22,10 +25,22 @@ class Aircraft
 {
 private:
     Actuator esc, servo_x, servo_y, servo_z; ///< Servomotori per il controllo delle superfici di controllo.
+    Mixer mixer;                             ///< Mixer dagli output del controller agli attuatori.
+    OutputStage output_stage;                ///< Aggiornamento sincronizzato degli attuatori.
     Receiver receiver;                       ///< Ricevitore per i comandi del pilota.
     LED led_red, led_green;                  ///< LED per il feedback visivo dello stato del sistema.
     RGB_LED led_rgb;                         ///< LED RGB per il feedback visivo dello stato del sistema.
 
+    /**
+     * @brief Copia IMU, ricevitore, output e telemetria dell'ESC in un record di telemetria.
+     */
+    TelemetryRecord make_telemetry_record() const;
+
+    /**
+     * @brief Registra nel logger i canali della telemetria (`TELEMETRY_CHANNEL_TABLE`), con i divisori iniziali.
+     */
+    void register_telemetry_channels();
+
 public:
     /**
      * @brief Costruttore della classe Aircraft.
@@ -64,19 +79,40 @@ public:
     /**
      * @brief Scrive i valori sugli attuatori.
      *
-     * Utilizza i dati di output per controllare i servocomandi e l'ESC.
+     * Miscela i dati di output tramite il mixer e controlla i servocomandi e l'ESC.
      */
     void write_actuators();
 
     /**
      * @brief Aggiorna il logger dei dati.
      *
-     * Se sono state effettuate letture dati, incrementa il ciclo.
+     * Se sono state effettuate letture dati, copia IMU, ricevitore, output e telemetria dell'ESC
+     * in un record di telemetria e incrementa il ciclo. L'invio avviene nel task del logger.
      */
     void update_data_logger();
 
+    /**
+     * @brief Registra il ciclo nel blackbox.
+     *
+     * A differenza del logger dei dati registra ogni ciclo, con lo stato del controller e la
+     * durata del ciclo. Il blackbox accoda il record solo da armati.
+     *
+     * @param state Stato attuale del controller.
+     * @param assist_mode Modalità di assistenza attuale.
+     * @param controller_mode Modalità di controllo attuale.
+     * @param error Errori del sistema.
+     * @param cycle_start_us Istante di inizio del ciclo (µs).
+     */
+    void update_blackbox(CONTROLLER_STATE state, ASSIST_MODE assist_mode, CONTROLLER_MODE controller_mode, const Errors &error, uint32_t cycle_start_us);
+
+    /**
+     * @brief Restituisce i contatori delle scritture sugli attuatori.
+     */
+    const OutputStageStats &get_output_stats() const { return output_stage.get_stats(); }
+
     IMU imu;                    ///< Sensore inerziale (IMU).
     ImuData imu_data;           ///< Dati letti dall'IMU.
+    EscData esc_data;           ///< Telemetria dell'ESC (RPM).
     ReceiverData receiver_data; ///< Dati ricevuti dal pilota.
     Output output;              ///< Output per i servocomandi e l'ESC.
 };
@@ -0,0 +1,411 @@
+/**
+ * @file AirframeConfig.h
+ * @brief Configurazione tipizzata e validata in compilazione dei profili di velivolo.
+ *
+ * I valori di base restano in `HardwareParameters.h`, `FlightControllerConfig.h` e `pins.h`;
+ * qui vengono raccolti in strutture `constexpr` per profilo di velivolo, da cui si ricavano in
+ * compilazione le grandezze derivate (fattori di scala dei canali, soglie di armamento) e su cui
+ * si verificano i vincoli con `static_assert`. Una configurazione non valida non compila.
+ */
+
+#ifndef AIRFRAME_CONFIG_H
+#define AIRFRAME_CONFIG_H
+
+#include "DataStructures.h"
+#include "HardwareParameters.h"
+#include "FlightControllerConfig.h"
+#include "pins.h"
+#include <stddef.h>
+
+/**
+ * @struct Range
+ * @brief Intervallo chiuso [min, max].
+ */
+struct Range
+{
+    float min; ///< Estremo inferiore.
+    float max; ///< Estremo superiore.
+
+    /**
+     * @brief Ampiezza dell'intervallo.
+     */
+    constexpr float span() const { return max - min; }
+
+    /**
+     * @brief Verifica se un valore appartiene all'intervallo.
+     */
+    constexpr bool contains(float value) const { return value >= min && value <= max; }
+
+    /**
+     * @brief Limita un valore all'intervallo.
+     */
+    constexpr float clamp(float value) const { return value < min ? min : (value > max ? max : value); }
+};
+
+/**
+ * @struct ChannelMap
+ * @brief Conversione lineare precalcolata da impulso PWM a valore digitale.
+ *
+ * Sostituisce la divisione per l'ampiezza dell'intervallo PWM con un prodotto per un fattore
+ * calcolato in compilazione.
+ */
+struct ChannelMap
+{
+    float pwm_min; ///< Impulso minimo (µs).
+    float scale;   ///< Unità digitali per µs.
+    Range digital; ///< Intervallo digitale di uscita.
+
+    /**
+     * @brief Converte un impulso nel valore digitale, limitato all'intervallo.
+     *
+     * @param pwm_value Impulso ricevuto (µs).
+     * @return float Valore digitale.
+     */
+    constexpr float apply(int pwm_value) const
+    {
+        return digital.clamp((static_cast<float>(pwm_value) - pwm_min) * scale + digital.min);
+    }
+};
+
+/**
+ * @brief Costruisce la conversione tra un intervallo PWM e uno digitale.
+ */
+constexpr ChannelMap make_channel(Range pwm, Range digital)
+{
+    return {pwm.min, digital.span() / pwm.span(), digital};
+}
+
+/**
+ * @struct ArmingConfig
+ * @brief Finestre degli stick per armamento e disarmo, derivate dalla tolleranza.
+ */
+struct ArmingConfig
+{
+    Range throttle_gate; ///< Throttle ammesso per armare o disarmare.
+    Range pitch_gate;    ///< Beccheggio (invertito) ammesso per armare o disarmare.
+    Range yaw_arm;       ///< Yaw richiesto per armare.
+    Range roll_arm;      ///< Rollio richiesto per armare.
+    Range yaw_disarm;    ///< Yaw richiesto per disarmare.
+    Range roll_disarm;   ///< Rollio richiesto per disarmare.
+};
+
+/**
+ * @brief Indica se un protocollo è DShot (uscita tramite RMT invece che LEDC).
+ */
+constexpr bool is_dshot(ACTUATOR_PROTOCOL protocol)
+{
+    return protocol == ACTUATOR_PROTOCOL::DSHOT300 || protocol == ACTUATOR_PROTOCOL::DSHOT600;
+}
+
+/**
+ * @brief Indica se un protocollo è generato dalla periferica LEDC (servo, OneShot125, Multishot).
+ */
+constexpr bool is_ledc_protocol(ACTUATOR_PROTOCOL protocol)
+{
+    return protocol == ACTUATOR_PROTOCOL::SERVO_50HZ || protocol == ACTUATOR_PROTOCOL::SERVO_333HZ ||
+           protocol == ACTUATOR_PROTOCOL::SERVO_560HZ || protocol == ACTUATOR_PROTOCOL::ONESHOT125 ||
+           protocol == ACTUATOR_PROTOCOL::MULTISHOT;
+}
+
+/**
+ * @struct ActuatorConfig
+ * @brief Parametri di un'uscita, così come vengono passati al costruttore di `Actuator`.
+ */
+struct ActuatorConfig
+{
+    int pin;                    ///< Pin del segnale.
+    ACTUATOR_PROTOCOL protocol; ///< Protocollo di uscita.
+    int channel;                ///< Canale LEDC (non usato con DShot).
+    int timer;                  ///< Timer LEDC (non usato con DShot).
+    RmtChannels rmt;            ///< Canali RMT (solo DShot).
+    Range pwm;                  ///< Impulsi minimo e massimo.
+    int pwm_null;               ///< Impulso iniziale.
+    Range digital;              ///< Intervallo del comando in ingresso.
+
+    /**
+     * @brief Indica se l'uscita usa DShot.
+     */
+    constexpr bool dshot() const { return is_dshot(protocol); }
+};
+
+/**
+ * @brief Verifica che ogni uscita abbia un protocollo generato dalla sua periferica.
+ *
+ * Le uscite DShot vanno sui canali RMT, tutte le altre su canale e timer LEDC: un protocollo
+ * che nessuna delle due genera lascerebbe l'attuatore non configurato (`Actuator::is_valid`).
+ */
+template <size_t N>
+constexpr bool output_protocols_valid(const ActuatorConfig (&outputs)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+        if (outputs[i].dshot() == is_ledc_protocol(outputs[i].protocol))
+            return false;
+    return true;
+}
+
+/**
+ * @brief Verifica che le uscite LEDC usino canali distinti, non assegnati al LED RGB.
+ *
+ * I canali da `RGB_BLUE_PWM_CHANNEL` in su sono assegnati da `analogWrite` al LED RGB.
+ */
+template <size_t N>
+constexpr bool ledc_channels_valid(const ActuatorConfig (&outputs)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (outputs[i].dshot())
+            continue;
+        if (outputs[i].channel < 0 || outputs[i].channel >= RGB_BLUE_PWM_CHANNEL)
+            return false;
+        for (size_t j = i + 1; j < N; ++j)
+            if (!outputs[j].dshot() && outputs[j].channel == outputs[i].channel)
+                return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Verifica che le uscite LEDC usino i timer 0-1 e che un timer condiviso abbia un solo protocollo.
+ *
+ * I timer 2 e 3 sono usati da `analogWrite`; la frequenza è una proprietà del timer.
+ */
+template <size_t N>
+constexpr bool ledc_timers_valid(const ActuatorConfig (&outputs)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (outputs[i].dshot())
+            continue;
+        if (outputs[i].timer < 0 || outputs[i].timer >= 2)
+            return false;
+        for (size_t j = i + 1; j < N; ++j)
+            if (!outputs[j].dshot() && outputs[j].timer == outputs[i].timer && outputs[j].protocol != outputs[i].protocol)
+                return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Verifica i canali RMT delle uscite DShot: 0-3 trasmettono, 4-7 ricevono, senza duplicati.
+ */
+template <size_t N>
+constexpr bool rmt_channels_valid(const ActuatorConfig (&outputs)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (!outputs[i].dshot())
+            continue;
+        if (outputs[i].rmt.tx < 0 || outputs[i].rmt.tx >= 4 || outputs[i].rmt.rx < 4 || outputs[i].rmt.rx >= 8)
+            return false;
+        for (size_t j = i + 1; j < N; ++j)
+            if (outputs[j].dshot() && (outputs[j].rmt.tx == outputs[i].rmt.tx || outputs[j].rmt.rx == outputs[i].rmt.rx))
+                return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Verifica che i pin delle uscite siano distinti tra loro e dal pin del ricevitore.
+ */
+template <size_t N>
+constexpr bool output_pins_valid(const ActuatorConfig (&outputs)[N], int receiver_pin)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (outputs[i].pin == receiver_pin)
+            return false;
+        for (size_t j = i + 1; j < N; ++j)
+            if (outputs[j].pin == outputs[i].pin)
+                return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Verifica che ogni uscita abbia un intervallo PWM valido contenente l'impulso iniziale.
+ */
+template <size_t N>
+constexpr bool output_pulses_valid(const ActuatorConfig (&outputs)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+        if (!(outputs[i].pwm.min < outputs[i].pwm.max) || !outputs[i].pwm.contains(outputs[i].pwm_null) ||
+            !(outputs[i].digital.min < outputs[i].digital.max))
+            return false;
+    return true;
+}
+
+/** @defgroup Airframe_Profiles Profili di velivolo
+ *  @{
+ */
+
+/**
+ * @brief Profilo di base: ala con alettoni, equilibratore e timone separati.
+ */
+struct StandardAirframe
+{
+    static constexpr MIXER_LAYOUT mixer = MIXER_LAYOUT::STANDARD; ///< Configurazione del mixer.
+
+    static constexpr Range roll = {ROLL_MIN, ROLL_MAX};             ///< Intervallo del rollio.
+    static constexpr Range pitch = {PITCH_MIN, PITCH_MAX};          ///< Intervallo del beccheggio.
+    static constexpr Range yaw = {YAW_MIN, YAW_MAX};                ///< Intervallo dello yaw.
+    static constexpr Range throttle = {THROTTLE_MIN, THROTTLE_MAX}; ///< Intervallo del throttle.
+
+    static constexpr Range receiver_pwm = {PWM_MIN, PWM_MAX};    ///< Impulsi dei canali del ricevitore.
+    static constexpr Range esc_pwm = {PWM_MIN, PWM_MAX};         ///< Impulsi dell'ESC.
+    static constexpr Range servo_pwm = {PWM_MIN_SERVO, PWM_MAX_SERVO}; ///< Impulsi dei servomotori.
+    static constexpr float servo_pwm_neutral = PWM_NEUTRAL_SERVO;      ///< Impulso neutro dei servomotori.
+
+    static constexpr float arm_tolerance_percent = ARM_TOLERANCE; ///< Tolleranza degli stick per arm/disarm (%).
+
+    static constexpr int receiver_pin = IBUS_RX_PIN;                                        ///< Pin RX del ricevitore iBus.
+    static constexpr int esc_pin = ESC_PIN;                                                 ///< Pin dell'ESC.
+    static constexpr int servo_pin[3] = {SERVO_PIN_X, SERVO_PIN_Y, SERVO_PIN_Z};            ///< Pin delle uscite X, Y, Z.
+    static constexpr ACTUATOR_PROTOCOL esc_protocol = ESC_PROTOCOL;                         ///< Protocollo dell'ESC.
+    static constexpr ACTUATOR_PROTOCOL servo_protocol = SERVO_PROTOCOL;                     ///< Protocollo dei servomotori.
+    static constexpr int esc_channel = ESC_PWM_CHANNEL;                                     ///< Canale LEDC dell'ESC.
+    static constexpr int servo_channel[3] = {SERVO_X_PWM_CHANNEL, SERVO_Y_PWM_CHANNEL, SERVO_Z_PWM_CHANNEL}; ///< Canali LEDC delle uscite X, Y, Z.
+    static constexpr int esc_timer = ESC_PWM_TIMER;                                         ///< Timer LEDC dell'ESC.
+    static constexpr int servo_timer = SERVO_PWM_TIMER;                                     ///< Timer LEDC dei servomotori.
+    static constexpr RmtChannels esc_rmt = {ESC_RMT_TX_CHANNEL, ESC_RMT_RX_CHANNEL};        ///< Canali RMT dell'ESC DShot.
+    static constexpr RmtChannels esc2_rmt = {ESC2_RMT_TX_CHANNEL, ESC2_RMT_RX_CHANNEL};     ///< Canali RMT del secondo motore DShot.
+};
+
+/**
+ * @brief Ala volante con elevoni.
+ */
+struct FlyingWingAirframe : StandardAirframe
+{
+    static constexpr MIXER_LAYOUT mixer = MIXER_LAYOUT::ELEVON; ///< Configurazione del mixer.
+};
+
+/**
+ * @brief Coda a V.
+ */
+struct VTailAirframe : StandardAirframe
+{
+    static constexpr MIXER_LAYOUT mixer = MIXER_LAYOUT::V_TAIL; ///< Configurazione del mixer.
+};
+
+/**
+ * @brief Bimotore con controllo dello yaw a spinta differenziale.
+ */
+struct TwinMotorAirframe : StandardAirframe
+{
+    static constexpr MIXER_LAYOUT mixer = MIXER_LAYOUT::DIFFERENTIAL_THRUST; ///< Configurazione del mixer.
+};
+
+/** @} */
+
+/**
+ * @brief Configurazione completa di un profilo di velivolo, con grandezze derivate e verifiche.
+ *
+ * @tparam Profile Profilo di velivolo (vedi `Airframe_Profiles`).
+ */
+template <typename Profile>
+struct AirframeConfig
+{
+    using profile = Profile; ///< Profilo di origine.
+
+    static constexpr MIXER_LAYOUT mixer = Profile::mixer; ///< Configurazione del mixer.
+
+    /// Indica se il canale Z comanda il secondo motore (spinta differenziale) invece del timone.
+    static constexpr bool z_is_motor = mixer == MIXER_LAYOUT::DIFFERENTIAL_THRUST;
+
+    /// ESC: con DShot sui canali RMT, altrimenti su canale e timer LEDC.
+    static constexpr ActuatorConfig esc = {Profile::esc_pin, Profile::esc_protocol, Profile::esc_channel, Profile::esc_timer,
+                                           Profile::esc_rmt, Profile::esc_pwm, static_cast<int>(Profile::esc_pwm.min), Profile::throttle};
+
+    /// Servomotore X (rollio).
+    static constexpr ActuatorConfig servo_x = {Profile::servo_pin[0], Profile::servo_protocol, Profile::servo_channel[0], Profile::servo_timer,
+                                               {}, Profile::servo_pwm, static_cast<int>(Profile::servo_pwm_neutral), Profile::roll};
+
+    /// Servomotore Y (beccheggio).
+    static constexpr ActuatorConfig servo_y = {Profile::servo_pin[1], Profile::servo_protocol, Profile::servo_channel[1], Profile::servo_timer,
+                                               {}, Profile::servo_pwm, static_cast<int>(Profile::servo_pwm_neutral), Profile::pitch};
+
+    /// Uscita Z: in spinta differenziale comanda il secondo motore con protocollo, limiti e timer
+    /// LEDC dell'ESC (o la seconda coppia di canali RMT con DShot), altrimenti il timone.
+    static constexpr ActuatorConfig servo_z = z_is_motor
+        ? ActuatorConfig{Profile::servo_pin[2], Profile::esc_protocol, Profile::servo_channel[2], Profile::esc_timer,
+                         Profile::esc2_rmt, Profile::esc_pwm, static_cast<int>(Profile::esc_pwm.min), Profile::throttle}
+        : ActuatorConfig{Profile::servo_pin[2], Profile::servo_protocol, Profile::servo_channel[2], Profile::servo_timer,
+                         {}, Profile::servo_pwm, static_cast<int>(Profile::servo_pwm_neutral), Profile::yaw};
+
+    /// Tutte le uscite, per le verifiche sulle risorse condivise.
+    static constexpr ActuatorConfig outputs[] = {esc, servo_x, servo_y, servo_z};
+
+    /// Conversioni dei canali iBus, nell'ordine del pacchetto.
+    static constexpr ChannelMap receiver[] = {
+        make_channel(Profile::receiver_pwm, Profile::roll),
+        make_channel(Profile::receiver_pwm, Profile::pitch),
+        make_channel(Profile::receiver_pwm, Profile::throttle),
+        make_channel(Profile::receiver_pwm, Profile::yaw),
+        make_channel(Profile::receiver_pwm, {SWITCH_MIN, SWITCH_SW_ABD_MAX}),
+        make_channel(Profile::receiver_pwm, {SWITCH_MIN, SWITCH_SW_ABD_MAX}),
+        make_channel(Profile::receiver_pwm, {SWITCH_MIN, SWITCH_SW_C_MAX}),
+        make_channel(Profile::receiver_pwm, {SWITCH_MIN, SWITCH_SW_ABD_MAX}),
+        make_channel(Profile::receiver_pwm, {VRA_MIN, VRA_MAX}),
+        make_channel(Profile::receiver_pwm, {VRB_MIN, VRB_MAX}),
+    };
+
+    /// Frazione della corsa accettata intorno agli estremi degli stick.
+    static constexpr float arm_fraction = Profile::arm_tolerance_percent * 0.01f;
+
+    /// Finestre di armamento e disarmo.
+    static constexpr ArmingConfig arming = {
+        {Profile::throttle.min, Profile::throttle.min + Profile::throttle.max * arm_fraction},
+        {Profile::pitch.min, Profile::pitch.min + Profile::pitch.max * arm_fraction},
+        {Profile::yaw.min, Profile::yaw.min + Profile::yaw.max * arm_fraction},
+        {Profile::roll.max - Profile::roll.max * arm_fraction, Profile::roll.max},
+        {Profile::yaw.max - Profile::yaw.max * arm_fraction, Profile::yaw.max},
+        {Profile::roll.min, Profile::roll.min + Profile::roll.max * arm_fraction},
+    };
+
+    static_assert(Profile::roll.min < Profile::roll.max && Profile::pitch.min < Profile::pitch.max &&
+                      Profile::yaw.min < Profile::yaw.max && Profile::throttle.min < Profile::throttle.max,
+                  "Intervalli degli assi vuoti o invertiti");
+    static_assert(Profile::roll.contains(0) && Profile::pitch.contains(0) && Profile::yaw.contains(0),
+                  "Gli assi devono comprendere la posizione neutra 0");
+    static_assert(Profile::receiver_pwm.min < Profile::receiver_pwm.max && Profile::esc_pwm.min < Profile::esc_pwm.max &&
+                      Profile::servo_pwm.min < Profile::servo_pwm.max,
+                  "Intervalli PWM vuoti o invertiti");
+    static_assert(Profile::servo_pwm.contains(Profile::servo_pwm_neutral), "Impulso neutro dei servo fuori intervallo");
+    static_assert(Profile::arm_tolerance_percent > 0 && Profile::arm_tolerance_percent <= 50,
+                  "ARM_TOLERANCE deve essere in (0, 50]%");
+    static_assert(arming.yaw_arm.max < arming.yaw_disarm.min && arming.roll_disarm.max < arming.roll_arm.min,
+                  "Le finestre di armamento e disarmo si sovrappongono");
+    static_assert(!servo_x.dshot() && !servo_y.dshot() && (z_is_motor || !servo_z.dshot()),
+                  "I servomotori non possono usare DShot");
+    static_assert(output_protocols_valid(outputs), "Protocollo di uscita non generato né da LEDC né da RMT");
+    static_assert(ledc_channels_valid(outputs), "Canali LEDC degli attuatori duplicati o assegnati al LED RGB (5-7)");
+    static_assert(ledc_timers_valid(outputs),
+                  "Timer LEDC fuori da 0-1 (2 e 3 sono usati da analogWrite) o condiviso da protocolli diversi");
+    static_assert(rmt_channels_valid(outputs), "Canali RMT non validi (0-3 trasmettono, 4-7 ricevono) o duplicati");
+    static_assert(output_pins_valid(outputs, Profile::receiver_pin), "Pin di ricevitore e attuatori duplicati");
+    static_assert(output_pulses_valid(outputs), "Intervalli delle uscite vuoti o impulso iniziale fuori intervallo");
+};
+
+/**
+ * @brief Configurazione del profilo selezionato con `AIRFRAME_PROFILE`.
+ */
+using ActiveAirframe = AirframeConfig<AIRFRAME_PROFILE>;
+
+/** @defgroup Hardware_Checks Verifiche della configurazione hardware
+ *  @{
+ */
+static_assert(MOTOR_POLES > 0 && MOTOR_POLES % 2 == 0, "MOTOR_POLES deve essere un numero pari positivo");
+
+static_assert(TUNING_TARGET_AXIS >= 0 && TUNING_TARGET_AXIS <= 2, "TUNING_TARGET_AXIS deve essere 0, 1 o 2");
+static_assert(MAX_INTEGRAL_ATTITUDE >= 0 && MAX_INTEGRAL_GYRO >= 0, "I limiti degli integrali non possono essere negativi");
+static_assert(PID_OUTPUT_LIMIT_ATTITUDE > 0 && PID_OUTPUT_LIMIT_GYRO > 0, "I limiti degli output PID devono essere positivi");
+static_assert(PID_DTERM_FILTER == PID_DTERM_FILTER_NONE || PID_DTERM_FILTER == PID_DTERM_FILTER_PT1 ||
+                  PID_DTERM_FILTER == PID_DTERM_FILTER_BIQUAD,
+              "PID_DTERM_FILTER non valido");
+static_assert(PID_DTERM_CUTOFF_HZ > 0 && 2 * PID_DTERM_CUTOFF_HZ < PID_DTERM_SAMPLE_HZ,
+              "La frequenza di taglio del termine derivativo deve essere sotto Nyquist");
+static_assert(SERVO_REDUCTION_FACTOR > 0 && SERVO_REDUCTION_FACTOR <= 1, "SERVO_REDUCTION_FACTOR deve essere in (0, 1]");
+static_assert(FORWARD_SPEED_THRESHOLD > 0, "FORWARD_SPEED_THRESHOLD deve essere positivo");
+static_assert(AUTOTUNE_CYCLES > 0 && AUTOTUNE_TIMEOUT > 0, "Parametri di autotuning non validi");
+/** @} */
+
+#endif // AIRFRAME_CONFIG_H
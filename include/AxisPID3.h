@@ -0,0 +1,156 @@
+/**
+ * @file AxisPID3.h
+ * @brief Dichiarazione della classe AxisPID3 per il controllo PID dei tre assi in un'unica chiamata.
+ */
+
+#ifndef AXIS_PID3_H
+#define AXIS_PID3_H
+
+#include "FlightControllerConfig.h"
+
+#define AXIS_PID_LANES 4 ///< Elementi per array: tre assi più un elemento di padding per l'allineamento.
+
+/**
+ * @struct AxisGains3
+ * @brief Guadagni (o offset dei guadagni) PID per i tre assi, memorizzati per componente.
+ */
+template <typename T>
+struct AxisGains3
+{
+    T kp[AXIS_PID_LANES]; ///< Guadagni proporzionali (X, Y, Z).
+    T ki[AXIS_PID_LANES]; ///< Guadagni integrali (X, Y, Z).
+    T kd[AXIS_PID_LANES]; ///< Guadagni derivativi (X, Y, Z).
+    T kf[AXIS_PID_LANES]; ///< Guadagni di feedforward sul setpoint (X, Y, Z).
+};
+
+/**
+ * @brief Classe per il controllo PID dei tre assi.
+ *
+ * Stato e guadagni dei tre assi sono memorizzati in array contigui (structure-of-arrays) e
+ * i tre assi vengono aggiornati con un unico ciclo senza dipendenze tra iterazioni e senza
+ * divisioni. Sull'ESP32-S3 le istruzioni SIMD operano solo su interi, quindi il calcolo in
+ * virgola mobile resta scalare; `test/bench/axis_pid3_bench.cpp` lo confronta con tre PID
+ * scalari per asse.
+ *
+ * Le funzionalità opzionali (derivata sulla misura, filtro del termine derivativo, feedforward,
+ * anti-windup a back-calculation, trasferimento bumpless) si abilitano in `FlightControllerConfig.h`.
+ *
+ * @tparam T Tipo scalare del calcolo.
+ */
+template <typename T = CONTROL_SCALAR>
+class AxisPID3
+{
+private:
+    AxisGains3<T> gains; ///< Guadagni di base.
+    T maxIntegral;       ///< Limite massimo per il valore integrale.
+    T outputLimit;       ///< Limite simmetrico dell'output.
+    AxisGains3<T> scale; ///< Fattori di scala dei guadagni (gain scheduling).
+
+    T integral[AXIS_PID_LANES]; ///< Accumulatori per il valore integrale.
+#if PID_D_ON_MEASUREMENT
+    T lastMeasurement[AXIS_PID_LANES]; ///< Ultime misure registrate.
+#else
+    T lastError[AXIS_PID_LANES]; ///< Ultimi errori registrati.
+#endif
+
+#if PID_DTERM_FILTER == PID_DTERM_FILTER_PT1
+    T dtermState[AXIS_PID_LANES]; ///< Stato del filtro PT1 del termine derivativo.
+#elif PID_DTERM_FILTER == PID_DTERM_FILTER_BIQUAD
+    T b0, b1, b2, a1, a2;         ///< Coefficienti normalizzati del biquad.
+    T dtermX1[AXIS_PID_LANES];    ///< Ingresso precedente del biquad.
+    T dtermX2[AXIS_PID_LANES];    ///< Ingresso di due campioni prima.
+    T dtermY1[AXIS_PID_LANES];    ///< Uscita precedente del biquad.
+    T dtermY2[AXIS_PID_LANES];    ///< Uscita di due campioni prima.
+#endif
+
+    /**
+     * @brief Calcola gli output dei tre assi.
+     *
+     * @tparam KnownRate true se `source` è già la derivata dell'errore, false se è la misura da derivare.
+     * @param error Errori attuali (X, Y, Z).
+     * @param source Misure attuali o derivate degli errori (X, Y, Z).
+     * @param setpoint Setpoint attuali (X, Y, Z).
+     * @param dt Intervallo di tempo dall'ultimo calcolo.
+     * @param inv_dt Reciproco di `dt`.
+     * @param offsets Offset dinamici dei guadagni, per asse.
+     * @param output Valori di controllo calcolati (X, Y, Z).
+     */
+    template <bool KnownRate>
+    void compute(const T error[3], const T source[3], const T setpoint[3], T dt, T inv_dt,
+                 const AxisGains3<T> &offsets, T output[3]);
+
+public:
+    /**
+     * @brief Costruttore della classe AxisPID3.
+     *
+     * @param gains Guadagni iniziali per i tre assi.
+     * @param maxIntegral Limite massimo per il valore integrale.
+     * @param outputLimit Limite simmetrico dell'output, usato dall'anti-windup.
+     */
+    AxisPID3(const AxisGains3<T> &gains, T maxIntegral, T outputLimit);
+
+    /**
+     * @brief Calcola i valori di controllo PID dei tre assi.
+     *
+     * @param error Errori attuali (X, Y, Z).
+     * @param measurement Misure attuali (X, Y, Z), usate dal termine derivativo.
+     * @param setpoint Setpoint attuali (X, Y, Z), usati dal feedforward.
+     * @param dt Intervallo di tempo dall'ultimo calcolo.
+     * @param inv_dt Reciproco di `dt`, calcolato una volta per ciclo.
+     * @param offsets Offset dinamici dei guadagni, per asse.
+     * @param output Valori di controllo calcolati (X, Y, Z).
+     */
+    void update(const T error[3], const T measurement[3], const T setpoint[3], T dt, T inv_dt,
+                const AxisGains3<T> &offsets, T output[3]);
+
+    /**
+     * @brief Calcola i valori di controllo PID dei tre assi con la derivata dell'errore nota.
+     *
+     * Per gli anelli in cui la misura non si deriva con una differenza finita (ad esempio la
+     * parte vettoriale del quaternione di errore, ricavata dalle velocità angolari). Con
+     * `PID_D_ON_MEASUREMENT` il termine derivativo usa `error_rate`; altrimenti deriva `error`
+     * come `update`.
+     *
+     * @param error Errori attuali (X, Y, Z).
+     * @param error_rate Derivata degli errori dovuta al solo moto del velivolo (setpoint costante).
+     * @param setpoint Setpoint attuali (X, Y, Z), usati dal feedforward.
+     * @param dt Intervallo di tempo dall'ultimo calcolo.
+     * @param inv_dt Reciproco di `dt`, calcolato una volta per ciclo.
+     * @param offsets Offset dinamici dei guadagni, per asse.
+     * @param output Valori di controllo calcolati (X, Y, Z).
+     */
+    void update_rate(const T error[3], const T error_rate[3], const T setpoint[3], T dt, T inv_dt,
+                     const AxisGains3<T> &offsets, T output[3]);
+
+    /**
+     * @brief Riallinea lo stato del controller al cambio di modalità.
+     *
+     * Azzera i filtri e memorizza la misura corrente, così il primo ciclo non produce derivative
+     * kick. Con `PID_BUMPLESS_TRANSFER` l'integrale viene precaricato in modo che il primo output
+     * coincida con `output`; altrimenti viene azzerato.
+     *
+     * @param error Errori attuali (X, Y, Z).
+     * @param measurement Misure attuali (X, Y, Z).
+     * @param setpoint Setpoint attuali (X, Y, Z).
+     * @param offsets Offset dinamici dei guadagni, per asse.
+     * @param output Output applicato prima del cambio di modalità (X, Y, Z).
+     */
+    void transfer(const T error[3], const T measurement[3], const T setpoint[3],
+                  const AxisGains3<T> &offsets, const T output[3]);
+
+    /**
+     * @brief Imposta i fattori di scala dei guadagni, applicati alla somma di guadagni e offset.
+     *
+     * @param kp Fattori del guadagno proporzionale (X, Y, Z).
+     * @param ki Fattori del guadagno integrale (X, Y, Z).
+     * @param kd Fattori del guadagno derivativo (X, Y, Z).
+     */
+    void set_gain_scale(const float kp[3], const float ki[3], const float kd[3]);
+
+    /**
+     * @brief Azzera integrali, filtri e valori memorizzati.
+     */
+    void reset();
+};
+
+#endif // AXIS_PID3_H
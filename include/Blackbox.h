@@ -0,0 +1,173 @@
+/**
+ * @file Blackbox.h
+ * @brief Dichiarazione della classe Blackbox per la registrazione su flash di ogni ciclo di controllo.
+ */
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include "BlackboxStorage.h"
+#include "DataStructures.h"
+#include "SPSCQueue.h"
+#include "Telemetry.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#define BLACKBOX_STORAGE "blackbox" ///< Etichetta della partizione dati (vedi `partitions.csv`).
+#else
+#define BLACKBOX_STORAGE "blackbox.bin" ///< File che sostituisce la partizione su host.
+#endif
+#define BLACKBOX_HOST_SIZE (256 * 1024) ///< Dimensione del file creato su host.
+
+#define BLACKBOX_BLOCK_SIZE BLACKBOX_SECTOR_SIZE ///< Blocco di record: un settore, con l'header nel primo slot.
+#define BLACKBOX_QUEUE_SIZE 64                   ///< Record in coda verso il task di scrittura (potenza di 2).
+#define BLACKBOX_TASK_PERIOD_MS 20               ///< Periodo del task di scrittura.
+#define BLACKBOX_PREPARE_SECTORS 16              ///< Settori verificati per iterazione durante la preparazione.
+
+#define BLACKBOX_RECEIVER_ERROR 0x01 ///< Errore del ricevitore nel ciclo.
+#define BLACKBOX_IMU_ERROR 0x02      ///< Errore dell'IMU nel ciclo.
+
+#define BLACKBOX_BLOCK_RECOVERED 0x01 ///< Header ricostruito all'avvio dopo un'interruzione.
+
+#define BLACKBOX_COMMAND_INFO 0x01  ///< Comando `blackbox info` in attesa.
+#define BLACKBOX_COMMAND_DUMP 0x02  ///< Comando `blackbox dump` in attesa.
+#define BLACKBOX_COMMAND_ERASE 0x04 ///< Comando `blackbox erase` in attesa.
+
+/**
+ * @struct BlackboxRecord
+ * @brief Record del blackbox: dati, stato del controller e tempi di un ciclo.
+ */
+struct BlackboxRecord
+{
+    TelemetryRecord telemetry; ///< Dati del ciclo; timestamp di inizio ciclo e ciclo nella sessione.
+    uint32_t loop_us;          ///< Durata del ciclo di controllo fino alla registrazione (µs).
+    uint32_t dropped;          ///< Record scartati per coda piena dall'avvio.
+    int8_t state;              ///< Stato del controller (`CONTROLLER_STATE`).
+    uint8_t assist_mode;       ///< Modalità di assistenza (`ASSIST_MODE`).
+    uint8_t controller_mode;   ///< Modalità di controllo (`CONTROLLER_MODE`).
+    uint8_t errors;            ///< Errori del ciclo (`BLACKBOX_*_ERROR`).
+};
+
+static_assert(sizeof(BlackboxRecord) == 128, "I record devono dividere esattamente pagine e settori");
+
+/**
+ * @struct BlackboxBlockHeader
+ * @brief Header di un blocco, scritto alla chiusura del blocco nel primo slot.
+ */
+struct BlackboxBlockHeader
+{
+    char magic[4];        ///< Identificativo del formato ("BBX1").
+    uint32_t session;     ///< Sessione di registrazione (un armamento).
+    uint16_t count;       ///< Record nel blocco.
+    uint16_t record_size; ///< Dimensione di un record.
+    uint32_t crc;         ///< CRC-32 dei record.
+    uint32_t flags;       ///< Flag del blocco (`BLACKBOX_BLOCK_*`).
+};
+
+#define BLACKBOX_RECORDS_PER_BLOCK (BLACKBOX_BLOCK_SIZE / sizeof(BlackboxRecord) - 1) ///< Record per blocco.
+
+/**
+ * @struct BlackboxStats
+ * @brief Statistiche del blackbox (solo task di scrittura).
+ */
+struct BlackboxStats
+{
+    uint32_t records; ///< Record scritti dall'avvio.
+    uint32_t blocks;  ///< Blocchi chiusi dall'avvio.
+    uint32_t lost;    ///< Record persi per memoria piena o non ancora cancellata.
+    uint32_t errors;  ///< Operazioni sulla flash fallite.
+    uint32_t session; ///< Ultima sessione registrata.
+    size_t used;      ///< Byte occupati dai blocchi chiusi.
+    size_t prepared;  ///< Byte cancellati e pronti per la scrittura (dall'inizio della memoria).
+};
+
+/**
+ * @brief Registratore su flash di ogni ciclo di controllo.
+ *
+ * Il ciclo di controllo copia il record in una coda lock-free (`SPSCQueue`) e non accede mai
+ * alla flash. Il task di scrittura compone i blocchi in RAM e li scrive per pagine intere; la
+ * cancellazione avviene solo da disarmati, in anticipo sulla posizione di scrittura, così
+ * durante il volo la flash viene solo programmata.
+ *
+ * La registrazione parte all'armamento (una sessione per armamento) e si chiude al
+ * disarmo. Ogni blocco è un settore: header nel primo slot, scritto alla chiusura con
+ * conteggio e CRC, poi i record. Un blocco interrotto (reset in volo) viene ricostruito
+ * all'avvio. Con la memoria piena i record vengono scartati e contati.
+ *
+ * Comandi sulla seriale (`SerialCommands`), da disarmati: `blackbox dump` (lettura dei
+ * blocchi in binario), `blackbox erase` (cancellazione), `blackbox info`. Il gestore li passa
+ * al task di scrittura, che li esegue fuori dalle sessioni; da armati vengono rifiutati.
+ * Durante il dump la seriale è riservata (`Logger::acquireSerial`) e i log restano in coda.
+ * Decodifica: `tools/blackbox.py`.
+ * Implementata come Singleton.
+ */
+class Blackbox
+{
+private:
+    Blackbox(); ///< Costruttore privato per garantire il Singleton.
+
+    BlackboxStorage storage;                              ///< Memoria dei blocchi.
+    SPSCQueue<BlackboxRecord, BLACKBOX_QUEUE_SIZE> queue; ///< Record dal ciclo di controllo.
+    std::atomic<bool> armed{false};                       ///< Sessione richiesta dal ciclo di controllo.
+    bool recording = false;                               ///< Sessione in corso (solo task di controllo).
+    uint32_t cycle = 0;                                   ///< Ciclo nella sessione (solo task di controllo).
+
+    // Stato del task di scrittura
+    bool available = false;                 ///< Memoria aperta e analizzata.
+    bool sessionActive = false;             ///< Sessione in scrittura.
+    uint8_t block[BLACKBOX_BLOCK_SIZE];     ///< Blocco in composizione, o buffer di lettura da disarmati.
+    size_t writeOffset = 0;                 ///< Offset del blocco in composizione (o del prossimo).
+    size_t flushed = 0;                     ///< Byte del blocco già scritti.
+    uint16_t blockCount = 0;                ///< Record nel blocco in composizione.
+    uint32_t blockCrc = 0;                  ///< CRC-32 dei record del blocco in composizione.
+    uint32_t sessionRecords = 0;            ///< Record scritti nella sessione in corso.
+    BlackboxStats stats = {};               ///< Statistiche del blackbox.
+
+    std::atomic<uint8_t> pendingCommands{0}; ///< Comandi dal task della seriale (`BLACKBOX_COMMAND_*`).
+
+    static void blackboxTask(void *param); ///< Task FreeRTOS di scrittura.
+
+    static bool handleCommand(void *context, const char *arguments); ///< Gestore di `blackbox` (task della seriale).
+
+    void scan();                                    ///< Trova la posizione di scrittura e ricostruisce i blocchi interrotti.
+    void startSession();                            ///< Apre una sessione e il suo primo blocco.
+    void endSession();                              ///< Chiude il blocco e la sessione in corso.
+    void openBlock();                               ///< Apre un blocco alla posizione di scrittura.
+    void flush(bool close);                         ///< Scrive le pagine complete del blocco (tutto con `close`).
+    void closeBlock();                              ///< Scrive l'header e passa al blocco successivo.
+    void prepare();                                 ///< Cancella in anticipo i settori successivi (solo da disarmati).
+    bool isErased(size_t offset, size_t size);      ///< Verifica che un intervallo sia cancellato.
+    void runCommands();                             ///< Esegue i comandi in attesa (solo da disarmati).
+    void dump();                                    ///< Invia i blocchi registrati sulla seriale.
+
+public:
+    static Blackbox &getInstance(); ///< Ottiene l'istanza Singleton.
+
+    Blackbox(const Blackbox &) = delete;            ///< Elimina il costruttore di copia.
+    Blackbox &operator=(const Blackbox &) = delete; ///< Elimina l'operatore di assegnazione.
+
+    /**
+     * @brief Apre la memoria e individua la posizione di scrittura.
+     *
+     * @return true Se la memoria è disponibile.
+     */
+    bool begin();
+
+    void startBlackboxTask(); ///< Registra il comando `blackbox`, apre la memoria e avvia il task di scrittura.
+
+    /**
+     * @brief Registra il record di un ciclo (solo task di controllo).
+     *
+     * Il record viene accodato da armati e nel ciclo del disarmo, che chiude la sessione.
+     *
+     * @param record Record del ciclo; il numero del ciclo viene assegnato qui.
+     */
+    void record(const BlackboxRecord &record);
+
+    void update(); ///< Scrive i record in coda e prepara la flash da disarmati (solo task di scrittura).
+
+    const BlackboxStats &getStats() const { return stats; } ///< Statistiche del blackbox.
+};
+
+#endif // BLACKBOX_H
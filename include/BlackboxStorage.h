@@ -0,0 +1,84 @@
+/**
+ * @file BlackboxStorage.h
+ * @brief Dichiarazione della classe BlackboxStorage per l'accesso alla memoria del blackbox.
+ */
+#ifndef BLACKBOX_STORAGE_H
+#define BLACKBOX_STORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#ifdef ARDUINO
+#include <esp_partition.h>
+#else
+#include <stdio.h>
+#endif
+
+#define BLACKBOX_SECTOR_SIZE 4096 ///< Unità di cancellazione della flash (byte).
+#define BLACKBOX_PAGE_SIZE 256    ///< Unità di programmazione della flash (byte).
+
+/**
+ * @brief Memoria del blackbox con la semantica di una flash NOR.
+ *
+ * Sul target è una partizione dati della flash; su host è un file della stessa struttura, per
+ * provare scrittura e lettura senza hardware. In entrambi i casi la cancellazione porta i byte
+ * a 0xFF per settori interi e la scrittura può solo azzerare bit: ogni byte va scritto una
+ * sola volta tra due cancellazioni.
+ */
+class BlackboxStorage
+{
+private:
+#ifdef ARDUINO
+    const esp_partition_t *partition = nullptr; ///< Partizione dati della flash.
+#else
+    FILE *file = nullptr; ///< File che sostituisce la partizione.
+#endif
+    size_t capacity = 0; ///< Dimensione utilizzabile in byte (multiplo del settore).
+
+public:
+    ~BlackboxStorage(); ///< Distruttore: chiude il file su host.
+
+    /**
+     * @brief Apre la memoria.
+     *
+     * @param name Etichetta della partizione (target) o percorso del file (host).
+     * @param size Dimensione del file da creare su host se non esiste; ignorata sul target.
+     * @return true Se la memoria è disponibile.
+     */
+    bool begin(const char *name, size_t size = 0);
+
+    /**
+     * @brief Restituisce la dimensione utilizzabile in byte.
+     */
+    size_t size() const { return capacity; }
+
+    /**
+     * @brief Legge un intervallo di byte.
+     *
+     * @param offset Offset di inizio.
+     * @param data Buffer di destinazione.
+     * @param size Byte da leggere.
+     * @return true Se la lettura è riuscita.
+     */
+    bool read(size_t offset, void *data, size_t size);
+
+    /**
+     * @brief Scrive un intervallo di byte già cancellato.
+     *
+     * @param offset Offset di inizio.
+     * @param data Dati da scrivere.
+     * @param size Byte da scrivere.
+     * @return true Se la scrittura è riuscita.
+     */
+    bool write(size_t offset, const void *data, size_t size);
+
+    /**
+     * @brief Cancella un intervallo di settori interi.
+     *
+     * @param offset Offset di inizio, allineato al settore.
+     * @param size Byte da cancellare, multiplo del settore.
+     * @return true Se la cancellazione è riuscita.
+     */
+    bool erase(size_t offset, size_t size);
+};
+
+#endif // BLACKBOX_STORAGE_H
@@ -0,0 +1,141 @@
+/**
+ * @file DShot.h
+ * @brief Codifica dei frame DShot e decodifica della telemetria eRPM bidirezionale.
+ *
+ * Le funzioni non dipendono dall'hardware e possono essere compilate anche su host.
+ */
+
+#ifndef DSHOT_H
+#define DSHOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** @defgroup DShot_Values Valori DShot
+ *  @{
+ */
+#define DSHOT_CMD_MOTOR_STOP 0    ///< Comando di arresto motore.
+#define DSHOT_THROTTLE_MIN 48     ///< Valore minimo di throttle.
+#define DSHOT_THROTTLE_MAX 2047   ///< Valore massimo di throttle.
+#define DSHOT_FRAME_BITS 16       ///< Bit in un frame di comando.
+#define DSHOT_TELEMETRY_BITS 21   ///< Bit in una risposta di telemetria (bit di start incluso).
+#define DSHOT_ERPM_INVALID 0xFFFFFFFF ///< Valore eRPM restituito per risposte non valide.
+/** @} */
+
+/**
+ * @brief Costruisce un frame DShot a 16 bit.
+ *
+ * Il frame è composto da 11 bit di valore, 1 bit di richiesta telemetria e 4 bit di CRC.
+ * In modalità bidirezionale il CRC viene invertito, come richiesto dagli ESC.
+ *
+ * @param value Valore di throttle o comando (0-2047).
+ * @param telemetry Richiesta di telemetria.
+ * @param bidirectional Modalità bidirezionale.
+ * @return uint16_t Frame da trasmettere (MSB per primo).
+ */
+inline uint16_t dshot_make_frame(uint16_t value, bool telemetry, bool bidirectional)
+{
+    uint16_t packet = static_cast<uint16_t>(((value & 0x07FF) << 1) | (telemetry ? 1 : 0));
+    uint16_t crc = (packet ^ (packet >> 4) ^ (packet >> 8));
+    if (bidirectional)
+        crc = ~crc;
+    return static_cast<uint16_t>((packet << 4) | (crc & 0x0F));
+}
+
+/**
+ * @brief Converte un impulso nella scala standard 1000-2000 µs in un valore di throttle DShot.
+ *
+ * Valori uguali o inferiori al minimo producono il comando di arresto motore.
+ */
+inline uint16_t dshot_throttle_from_pwm(int pwm_value, int pwm_min, int pwm_max)
+{
+    if (pwm_value <= pwm_min)
+        return DSHOT_CMD_MOTOR_STOP;
+    if (pwm_value >= pwm_max)
+        return DSHOT_THROTTLE_MAX;
+    return static_cast<uint16_t>(DSHOT_THROTTLE_MIN +
+                                 (int32_t)(pwm_value - pwm_min) * (DSHOT_THROTTLE_MAX - DSHOT_THROTTLE_MIN) / (pwm_max - pwm_min));
+}
+
+/**
+ * @brief Ricostruisce il valore grezzo a 21 bit della telemetria dalle durate dei livelli.
+ *
+ * Ogni transizione della linea rappresenta un bit a 1, seguito da tanti bit a 0 quanti
+ * sono i periodi di bit aggiuntivi del livello. L'ultimo livello si estende fino al 21-esimo bit.
+ *
+ * @param durations Durate consecutive dei livelli, a partire dal fronte di start.
+ * @param count Numero di durate.
+ * @param bit_ticks Durata nominale di un bit di telemetria, nelle stesse unità delle durate.
+ * @param value Valore grezzo ricostruito.
+ * @return true Se sono stati ricostruiti esattamente 21 bit.
+ */
+inline bool dshot_decode_runs(const uint32_t *durations, size_t count, uint32_t bit_ticks, uint32_t &value)
+{
+    uint32_t raw = 0;
+    uint32_t bits = 0;
+
+    for (size_t i = 0; i < count && bits < DSHOT_TELEMETRY_BITS; ++i)
+    {
+        uint32_t len = (durations[i] + bit_ticks / 2) / bit_ticks;
+        if (len == 0)
+            return false;
+        if (bits + len > DSHOT_TELEMETRY_BITS || i == count - 1)
+            len = DSHOT_TELEMETRY_BITS - bits;
+
+        raw = (raw << len) | (1UL << (len - 1));
+        bits += len;
+    }
+
+    if (bits != DSHOT_TELEMETRY_BITS)
+        return false;
+
+    value = raw;
+    return true;
+}
+
+/**
+ * @brief Decodifica una risposta di telemetria GCR e restituisce gli eRPM.
+ *
+ * @param value Valore grezzo a 21 bit (vedi `dshot_decode_runs`).
+ * @return uint32_t eRPM, 0 a motore fermo, `DSHOT_ERPM_INVALID` se la risposta non è valida.
+ */
+inline uint32_t dshot_decode_erpm(uint32_t value)
+{
+    // Tabella GCR 5b -> 4b (0xFF = simbolo non valido)
+    static const uint8_t gcr_decode[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0x09, 0x0A, 0x0B, 0xFF, 0x0D, 0x0E, 0x0F,
+        0xFF, 0xFF, 0x02, 0x03, 0xFF, 0x05, 0x06, 0x07,
+        0xFF, 0x00, 0x08, 0x01, 0xFF, 0x04, 0x0C, 0xFF};
+
+    // Il bit di start viene scartato
+    value &= 0xFFFFF;
+
+    uint32_t decoded = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        uint8_t nibble = gcr_decode[(value >> (5 * i)) & 0x1F];
+        if (nibble == 0xFF)
+            return DSHOT_ERPM_INVALID;
+        decoded |= (uint32_t)nibble << (4 * i);
+    }
+
+    // Lo XOR dei quattro nibble deve valere 0xF
+    uint32_t crc = decoded ^ (decoded >> 8);
+    crc ^= crc >> 4;
+    if ((crc & 0x0F) != 0x0F)
+        return DSHOT_ERPM_INVALID;
+
+    // Periodo elettrico nel formato eee mmmmmmmmm (µs)
+    uint32_t payload = decoded >> 4;
+    if (payload == 0x0FFF)
+        return 0;
+
+    uint32_t period_us = (payload & 0x01FF) << (payload >> 9);
+    if (period_us == 0)
+        return DSHOT_ERPM_INVALID;
+
+    return (60000000UL + period_us / 2) / period_us;
+}
+
+#endif // DSHOT_H
@@ -0,0 +1,71 @@
+/**
+ * @file DShotESC.h
+ * @brief Dichiarazione della classe DShotESC per il comando digitale dell'ESC tramite RMT.
+ */
+#ifndef DSHOT_ESC_H
+#define DSHOT_ESC_H
+
+#include "DataStructures.h"
+#include "DShot.h"
+#include <driver/rmt.h>
+
+/**
+ * @brief Classe per il comando di un ESC tramite protocollo DShot.
+ *
+ * Il frame viene generato dalla periferica RMT. In modalità bidirezionale il segnale è invertito
+ * e, sullo stesso pin, un canale RMT in ricezione cattura la risposta eRPM dell'ESC.
+ */
+class DShotESC
+{
+private:
+    int pin;                   ///< Pin associato all'ESC.
+    rmt_channel_t tx_channel;  ///< Canale RMT di trasmissione.
+    rmt_channel_t rx_channel;  ///< Canale RMT di ricezione della telemetria.
+    bool bidirectional;        ///< Modalità bidirezionale (telemetria eRPM).
+    bool rx_active = false;    ///< Indica se la ricezione della risposta è in corso.
+    RingbufHandle_t rx_buffer; ///< Buffer della periferica RMT per le risposte.
+
+    uint16_t t0h, t1h, bit_ticks;  ///< Durate (tick RMT) degli impulsi 0, 1 e del bit di comando.
+    uint16_t telemetry_bit_ticks;  ///< Durata (tick RMT) di un bit di telemetria.
+
+    rmt_item32_t items[DSHOT_FRAME_BITS + 1]; ///< Frame codificato per la periferica RMT (16 bit e terminatore).
+
+    uint32_t erpm = 0;            ///< Ultimo valore eRPM valido.
+    bool telemetry_valid = false; ///< Indica se l'ultimo valore eRPM è valido.
+
+    /**
+     * @brief Legge e decodifica la risposta dell'ESC al frame precedente.
+     */
+    void read_telemetry();
+
+public:
+    /**
+     * @brief Costruttore della classe DShotESC.
+     *
+     * @param pin Pin associato all'ESC.
+     * @param tx_channel Canale RMT di trasmissione.
+     * @param rx_channel Canale RMT di ricezione.
+     * @param protocol Protocollo DShot (DSHOT300 o DSHOT600).
+     * @param bidirectional Abilita la telemetria eRPM bidirezionale.
+     */
+    DShotESC(int pin, int tx_channel, int rx_channel, ACTUATOR_PROTOCOL protocol, bool bidirectional);
+
+    /**
+     * @brief Trasmette un valore di throttle o un comando DShot.
+     *
+     * In modalità bidirezionale legge prima la risposta al frame precedente.
+     *
+     * @param value Valore DShot (0 = arresto, 48-2047 = throttle).
+     */
+    void write(uint16_t value);
+
+    /**
+     * @brief Restituisce l'ultimo valore eRPM ricevuto.
+     *
+     * @param erpm Valore eRPM.
+     * @return true Se il valore è valido.
+     */
+    bool get_erpm(uint32_t &erpm) const;
+};
+
+#endif // DSHOT_ESC_H
@@ -54,7 +54,8 @@ enum class CONTROLLER_MODE
     STANDARD = 0,   ///< Modalità standard.
     KP_CALIBRATION, ///< Calibrazione del guadagno proporzionale.
     KI_CALIBRATION, ///< Calibrazione del guadagno integrale.
-    KD_CALIBRATION  ///< Calibrazione del guadagno derivativo.
+    KD_CALIBRATION, ///< Calibrazione del guadagno derivativo.
+    AUTOTUNE        ///< Autotuning a relè sull'asse target della calibrazione.
 };
 
 /**
@@ -75,6 +76,42 @@ enum class ASSIST_MODE
     MANUAL = 0,           ///< Modalità manuale.
     GYRO_STABILIZED = 1,  ///< Stabilizzazione tramite giroscopio.
     ATTITUDE_CONTROL = 2, ///< Controllo dell'attitudine.
+    LQR_CONTROL = 3,      ///< Controllo dell'attitudine con retroazione dello stato (LQR).
+};
+
+/**
+ * @brief Enumerazione per i protocolli di uscita degli attuatori.
+ */
+enum class ACTUATOR_PROTOCOL
+{
+    SERVO_50HZ,  ///< PWM standard (50 Hz, 1000-2000 µs): servo analogici ed ESC tradizionali.
+    SERVO_333HZ, ///< Servo digitale (333 Hz, 1000-2000 µs).
+    SERVO_560HZ, ///< Servo digitale ad alta frequenza (560 Hz, 1000-2000 µs).
+    ONESHOT125,  ///< ESC OneShot125 (125-250 µs).
+    MULTISHOT,   ///< ESC Multishot (5-25 µs).
+    DSHOT300,    ///< ESC DShot300 (digitale, tramite RMT).
+    DSHOT600     ///< ESC DShot600 (digitale, tramite RMT).
+};
+
+/**
+ * @brief Canali RMT usati da un ESC DShot.
+ */
+struct RmtChannels
+{
+    int tx; ///< Canale RMT di trasmissione.
+    int rx; ///< Canale RMT di ricezione della telemetria.
+};
+
+/**
+ * @brief Enumerazione per le configurazioni del mixer di uscita.
+ */
+enum class MIXER_LAYOUT
+{
+    STANDARD,           ///< Alettoni, elevatore, timone e motore su canali separati.
+    ELEVON,             ///< Ala volante: elevoni sinistro e destro.
+    V_TAIL,             ///< Coda a V: due ruddervator.
+    FLAPERON,           ///< Alettoni su due canali (sinistro e destro).
+    DIFFERENTIAL_THRUST ///< Due motori con spinta differenziale al posto del timone.
 };
 
 /**
@@ -153,6 +190,16 @@ struct ImuData
     float vel;       ///< Velocità integrata.
 };
 
+/**
+ * @struct EscData
+ * @brief Contiene i dati di telemetria dell'ESC.
+ */
+struct EscData
+{
+    float rpm;  ///< Giri al minuto del motore.
+    bool valid; ///< Indica se l'ultima lettura è valida.
+};
+
 /**
  * @struct ReceiverData
  * @brief Contiene i dati ricevuti dal pilota.
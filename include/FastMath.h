@@ -0,0 +1,168 @@
+/**
+ * @file FastMath.h
+ * @brief Approssimazioni veloci delle funzioni trascendenti usate nel ciclo di controllo.
+ *
+ * Ogni funzione ha una variante esatta (libm in singola precisione) e una variante veloce
+ * (polinomi minimax), selezionate in compilazione con `FAST_MATH`. Gli errori massimi
+ * documentati sono stati misurati su host confrontando con libm in doppia precisione su
+ * tutto il dominio indicato. Le funzioni non dipendono dall'hardware.
+ */
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include "FlightControllerConfig.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if FAST_MATH
+
+/**
+ * @brief Riduce l'angolo all'intervallo [-π/4, π/4] e restituisce il quadrante.
+ *
+ * La costante π/2 è divisa in tre parti (Cody–Waite) per non perdere precisione nella sottrazione.
+ */
+inline int fast_reduce_quadrant(float x, float &r)
+{
+    const float two_over_pi = 0.636619772f;
+    const float pio2_1 = 1.5703125f;                 // 8 bit significativi: k·pio2_1 è esatto
+    const float pio2_2 = 4.837512969970703125e-4f;   // 11 bit significativi
+    const float pio2_3 = 7.54978995489188216e-8f;
+
+    const float kf = nearbyintf(x * two_over_pi);
+    r = ((x - kf * pio2_1) - kf * pio2_2) - kf * pio2_3;
+    return static_cast<int>(kf) & 3;
+}
+
+/**
+ * @brief Seno e coseno di un angolo ridotto a [-π/4, π/4].
+ */
+inline void fast_sincos_reduced(float r, float &s, float &c)
+{
+    const float z = r * r;
+    s = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+    c = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+}
+
+/**
+ * @brief Calcola seno e coseno dello stesso angolo.
+ *
+ * Errore assoluto massimo 1.0e-7 per |x| ≤ 1000 rad; oltre, l'errore cresce con |x| per
+ * la riduzione dell'argomento in singola precisione.
+ *
+ * @param x Angolo (rad).
+ * @param s Seno.
+ * @param c Coseno.
+ */
+inline void fast_sincos(float x, float &s, float &c)
+{
+    float r, sr, cr;
+    const int quadrant = fast_reduce_quadrant(x, r);
+    fast_sincos_reduced(r, sr, cr);
+
+    switch (quadrant)
+    {
+    case 0:
+        s = sr;
+        c = cr;
+        break;
+    case 1:
+        s = cr;
+        c = -sr;
+        break;
+    case 2:
+        s = -sr;
+        c = -cr;
+        break;
+    default:
+        s = -cr;
+        c = sr;
+        break;
+    }
+}
+
+/**
+ * @brief Seno di un angolo. Errore come `fast_sincos`.
+ */
+inline float fast_sin(float x)
+{
+    float s, c;
+    fast_sincos(x, s, c);
+    return s;
+}
+
+/**
+ * @brief Coseno di un angolo. Errore come `fast_sincos`.
+ */
+inline float fast_cos(float x)
+{
+    float s, c;
+    fast_sincos(x, s, c);
+    return c;
+}
+
+/**
+ * @brief Arcotangente a quattro quadranti.
+ *
+ * Polinomio minimax di grado 9 su [0, 1] (Abramowitz–Stegun 4.4.49) e ricostruzione dei
+ * quadranti. Errore assoluto massimo 1.2e-5 rad su tutto il piano; restituisce 0 per (0, 0).
+ * Come `atan2f`, con x < 0 il segno di uno zero in y sceglie tra π e -π.
+ *
+ * @param y Ordinata.
+ * @param x Ascissa.
+ * @return float Angolo in [-π, π] (rad).
+ */
+inline float fast_atan2(float y, float x)
+{
+    const float ax = fabsf(x);
+    const float ay = fabsf(y);
+    const float mx = ax > ay ? ax : ay;
+    if (mx == 0.0f)
+        return 0.0f;
+
+    const float a = (ax < ay ? ax : ay) / mx;
+    const float s = a * a;
+    float r = a * (0.9998660f + s * (-0.3302995f + s * (0.1801410f + s * (-0.0851330f + s * 0.0208351f))));
+
+    if (ay > ax)
+        r = 1.57079637f - r;
+    if (x < 0.0f)
+        r = 3.14159274f - r;
+    return signbit(y) ? -r : r;
+}
+
+/**
+ * @brief Reciproco della radice quadrata.
+ *
+ * Stima iniziale sui bit dell'esponente e due iterazioni di Newton–Raphson, senza radici
+ * né divisioni. Errore relativo massimo 4.8e-6 per x normalizzati positivi.
+ *
+ * @param x Valore positivo.
+ * @return float 1 / sqrt(x).
+ */
+inline float fast_rsqrt(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f375a86u - (bits >> 1);
+    float y;
+    memcpy(&y, &bits, sizeof(y));
+
+    const float half_x = 0.5f * x;
+    y = y * (1.5f - half_x * y * y);
+    y = y * (1.5f - half_x * y * y);
+    return y;
+}
+
+#else // FAST_MATH
+
+inline void fast_sincos(float x, float &s, float &c) { __builtin_sincosf(x, &s, &c); }
+inline float fast_sin(float x) { return sinf(x); }
+inline float fast_cos(float x) { return cosf(x); }
+inline float fast_atan2(float y, float x) { return atan2f(y, x); }
+inline float fast_rsqrt(float x) { return 1.0f / sqrtf(x); }
+
+#endif // FAST_MATH
+
+#endif // FAST_MATH_H
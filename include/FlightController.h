@@ -6,17 +6,24 @@
 #ifndef FLIGHT_CONTROLLER_H
 #define FLIGHT_CONTROLLER_H
 
-#include "PIDcontroller.h"
+#include "AxisPID3.h"
 #include "DataStructures.h"
 #include "FlightControllerConfig.h"
+#include "GainSchedule.h"
+#include "InputShaper.h"
+#include "LQRController.h"
+#include "RelayAutotune.h"
 
 /**
  * @brief Classe per la gestione del controller di volo.
  * 
  * Si occupa della logica di controllo di volo, includendo il calcolo dei PID per la stabilizzazione
  * e l'attitudine del velivolo.
+ *
+ * @tparam T Tipo scalare del calcolo (`float` sul target, `double` disponibile per confronto).
  */
-class FlightController
+template <typename T>
+class FlightControllerT
 {
 private:
     /**
@@ -42,38 +49,87 @@ private:
      * @brief Calcola il controllo PID per le velocità angolari.
      * 
      * @param errors Errori angolari.
-     * @param pid_offsets Offset PID dinamici.
+     * @param setpoint Velocità angolari richieste, usate dal feedforward.
+     * @param gyro Velocità angolari misurate.
+     * @param pid_offsets Offset PID dinamici, per asse.
      * @param dt Intervallo di tempo dall'ultimo ciclo.
+     * @param inv_dt Reciproco di `dt`.
      * @param output Struttura di output per gli attuatori.
      */
-    void compute_gyro_pid(const Euler &errors, const PID &pid_offsets, double dt, Output &output);
+    void compute_gyro_pid(const Euler &errors, const Euler &setpoint, const Euler &gyro,
+                          const AxisGains3<T> &pid_offsets, T dt, T inv_dt, Output &output);
 
     /**
      * @brief Calcola il controllo PID per l'attitudine.
      * 
+     * L'output dell'anello di assetto è la velocità angolare richiesta all'anello del gyro.
+     * 
      * @param errors Errori di attitudine (quaternione).
-     * @param pid_offsets Offset PID dinamici.
+     * @param attitude Attitudine misurata.
+     * @param gyro Velocità angolari misurate.
+     * @param pid_offsets Offset PID dinamici, per asse.
      * @param dt Intervallo di tempo dall'ultimo ciclo.
+     * @param inv_dt Reciproco di `dt`.
+     * @param output Struttura di output per gli attuatori.
+     */
+    void compute_attitude_pid(const Quaternion &errors, const Quaternion &attitude, const Euler &gyro,
+                              const AxisGains3<T> &pid_offsets, T dt, T inv_dt, Output &output);
+
+    /**
+     * @brief Calcola il controllo LQR dell'attitudine.
+     * 
+     * Lo stato è formato dall'errore di assetto (gradi, ricavato dalla parte vettoriale del
+     * quaternione di errore) e dalle velocità angolari misurate; il riferimento è l'attitudine
+     * desiderata con velocità angolari nulle.
+     * 
+     * @param errors Errori di attitudine (quaternione).
+     * @param gyro Velocità angolari misurate.
      * @param output Struttura di output per gli attuatori.
      */
-    void compute_attitude_pid(const Quaternion &errors, const PID &pid_offsets, double dt, Output &output);
+    void compute_lqr(const Quaternion &errors, const Euler &gyro, Output &output);
+
+    /**
+     * @brief Avvia, interrompe e riporta l'esperimento di autotuning in base alla modalità corrente.
+     * 
+     * @param assist_mode Modalità di assistenza corrente; determina l'anello in identificazione.
+     * @param imu_data Dati letti dall'IMU.
+     * @param output Output applicato nel ciclo precedente.
+     */
+    void update_autotune(ASSIST_MODE assist_mode, const ImuData &imu_data, const Output &output);
+
+    /**
+     * @brief Riallinea lo stato dei PID al cambio di modalità di assistenza.
+     * 
+     * @param assist_mode Nuova modalità di assistenza.
+     * @param imu_data Dati letti dall'IMU.
+     * @param output Output applicato nel ciclo precedente, già scalato dal gain scheduling.
+     */
+    void transfer(ASSIST_MODE assist_mode, const ImuData &imu_data, const Output &output);
 
     // Componenti logiche
-    PIDcontroller pid_attitude_x; ///< PID per il controllo dell'assetto sull'asse X (rollio).
-    PIDcontroller pid_attitude_y; ///< PID per il controllo dell'assetto sull'asse Y (beccheggio).
-    PIDcontroller pid_attitude_z; ///< PID per il controllo dell'assetto sull'asse Z (imbardata).
-    PIDcontroller pid_gyro_x;     ///< PID per il controllo della velocità angolare sull'asse X (rollio).
-    PIDcontroller pid_gyro_y;     ///< PID per il controllo della velocità angolare sull'asse Y (beccheggio).
-    PIDcontroller pid_gyro_z;     ///< PID per il controllo della velocità angolare sull'asse Z (imbardata).
+    AxisPID3<T> pid_attitude; ///< PID per il controllo dell'assetto sui tre assi.
+    AxisPID3<T> pid_gyro;     ///< PID per il controllo della velocità angolare sui tre assi.
+    LQRController lqr;        ///< Regolatore LQR per il controllo dell'attitudine.
+    InputShaper input_shaper;     ///< Curve expo/rate e filtro dei setpoint degli stick.
+    GainScheduler gain_scheduler; ///< Gain scheduling in funzione di velocità e throttle.
+    GainScheduleEntry schedule;   ///< Fattori di scala del ciclo corrente.
+    RelayAutotune autotune;       ///< Esperimento di autotuning a relè.
 
     // Dati del controller di volo
     Euler error_gyro;               ///< Errori delle velocità angolari per ciascun asse (X, Y, Z).
+    Euler setpoint_gyro;            ///< Velocità angolari richieste dal pilota (X, Y, Z).
     Quaternion error_attitude;      ///< Errori di attitudine calcolati come differenza tra setpoint e attitudine attuale.
     Quaternion desired_attitude;    ///< Attitudine desiderata calcolata dagli input del pilota.
-    PID pid_tuning_offset_gyro;     ///< Offset dinamici per il tuning del PID delle velocità angolari.
-    PID pid_tuning_offset_attitude; ///< Offset dinamici per il tuning del PID degli assetti.
+    Euler desired_input;            ///< Input (rollio, beccheggio, imbardata) da cui è stata calcolata `desired_attitude`.
+    AxisGains3<T> pid_tuning_offset_gyro;     ///< Offset dinamici per il tuning del PID delle velocità angolari.
+    AxisGains3<T> pid_tuning_offset_attitude; ///< Offset dinamici per il tuning del PID degli assetti.
 
     Errors error; ///< Struttura per gli errori rilevati.
+    ASSIST_MODE active_mode; ///< Modalità per cui è stato inizializzato lo stato dei PID.
+    CONTROLLER_MODE controller_mode; ///< Modalità di controllo dell'ultimo ciclo.
+    ASSIST_MODE autotune_mode;       ///< Modalità di assistenza in cui è stato avviato l'autotuning.
+    int autotune_axis;               ///< Asse in identificazione (0 = X, 1 = Y, 2 = Z).
+    bool autotune_reported;          ///< Risultato dell'autotuning già registrato.
 
 public:
     /**
@@ -83,7 +139,7 @@ public:
      * @param imu_data Riferimento ai dati letti dall'IMU.
      * @param output Riferimento alla struttura di output per gli attuatori.
      */
-    FlightController(ReceiverData &receiver_data, ImuData &imu_data, Output &output);
+    FlightControllerT(ReceiverData &receiver_data, ImuData &imu_data, Output &output);
 
     /**
      * @brief Salva i dati di output del controller.
@@ -104,7 +160,7 @@ public:
      * @param error Errori attuali.
      * @param controller_mode Modalità di controllo corrente.
      */
-    void compute_data(double dt, ReceiverData &receiver_data, ImuData &imu_data, Output &output, ASSIST_MODE assist_mode, CONTROLLER_STATE state, Errors error, CONTROLLER_MODE controller_mode);
+    void compute_data(T dt, ReceiverData &receiver_data, ImuData &imu_data, Output &output, ASSIST_MODE assist_mode, CONTROLLER_STATE state, Errors error, CONTROLLER_MODE controller_mode);
 
     /**
      * @brief Esegue il controllo del velivolo.
@@ -115,9 +171,19 @@ public:
      * @param output Struttura di output per gli attuatori.
      * @param assist_mode Modalità di assistenza corrente.
      * @param state Stato del controller.
-     * @param calibration_target Asse target per la calibrazione PID.
+     * @param calibration_target Asse target per la calibrazione PID e per l'autotuning.
      */
-    void control(double dt, ImuData &imu_data, ReceiverData &receiver_data, Output &output, ASSIST_MODE assist_mode, CONTROLLER_STATE state, CALIBRATION_TARGET calibration_target);
+    void control(T dt, ImuData &imu_data, ReceiverData &receiver_data, Output &output, ASSIST_MODE assist_mode, CONTROLLER_STATE state, CALIBRATION_TARGET calibration_target);
+
+    /**
+     * @brief Restituisce il gain scheduler, per sostituirne le tabelle a runtime.
+     */
+    GainScheduler &get_gain_scheduler() { return gain_scheduler; }
 };
 
+/**
+ * @brief Controller di volo con il tipo scalare configurato.
+ */
+using FlightController = FlightControllerT<CONTROL_SCALAR>;
+
 #endif // FLIGHT_CONTROLLER_H
@@ -13,6 +13,46 @@
  * utilizzati nel sistema.
  */
 
+/**
+ * @brief Tipo scalare usato dal controllo di volo.
+ *
+ * L'FPU dell'ESP32-S3 è a singola precisione: con `double` ogni passo PID viene emulato
+ * via software. Definire `CONTROL_SCALAR=double` nei build flag per un confronto di riferimento.
+ */
+#ifndef CONTROL_SCALAR
+#define CONTROL_SCALAR float
+#endif
+
+/**
+ * @brief Selezione delle funzioni trascendenti (vedi `FastMath.h`).
+ *
+ * 1 usa le approssimazioni polinomiali con errore massimo documentato, 0 le funzioni di libm.
+ */
+#ifndef FAST_MATH
+#define FAST_MATH 1
+#endif
+
+/**
+ * @brief Abilita l'autotuning a relè (`CONTROLLER_MODE::AUTOTUNE`).
+ *
+ * Disabilitato di default: con 0 la posizione SWD=0, SWC=2 resta STANDARD. Con 1 la stessa
+ * posizione avvia l'oscillazione a relè sull'asse target; da abilitare solo per le sessioni di taratura.
+ */
+#ifndef AUTOTUNE_ENABLED
+#define AUTOTUNE_ENABLED 0
+#endif
+
+/**
+ * @brief Abilita la modalità di assistenza LQR (`ASSIST_MODE::LQR_CONTROL`).
+ *
+ * Disabilitata di default: i guadagni di `LQRGains.h` derivano da un modello non identificato
+ * sul velivolo. Con 1 la posizione SWA=0, SWB=1 seleziona LQR invece di MANUAL; SWB resta anche
+ * la sorgente della calibrazione.
+ */
+#ifndef LQR_ENABLED
+#define LQR_ENABLED 0
+#endif
+
 /** @defgroup PID_Parameters Parametri PID
  *  @{
  */
@@ -43,6 +83,51 @@
 #define KI_GYRO_Z 0 ///< Guadagno integrale per l'asse Z (imbardata).
 #define KD_GYRO_Z 0 ///< Guadagno derivativo per l'asse Z (imbardata).
 
+// Guadagni di feedforward sul setpoint
+#define KF_ATTITUDE_X 0 ///< Guadagno feedforward dell'assetto per l'asse X (rollio).
+#define KF_ATTITUDE_Y 0 ///< Guadagno feedforward dell'assetto per l'asse Y (beccheggio).
+#define KF_ATTITUDE_Z 0 ///< Guadagno feedforward dell'assetto per l'asse Z (imbardata).
+
+#define KF_GYRO_X 0 ///< Guadagno feedforward del gyro per l'asse X (rollio).
+#define KF_GYRO_Y 0 ///< Guadagno feedforward del gyro per l'asse Y (beccheggio).
+#define KF_GYRO_Z 0 ///< Guadagno feedforward del gyro per l'asse Z (imbardata).
+
+/** @} */
+
+/** @defgroup PID_Features Funzionalità opzionali dei PID
+ *  Ogni funzionalità disabilitata viene esclusa in compilazione e non ha costo a runtime.
+ *  @{
+ */
+
+#define PID_DTERM_FILTER_NONE 0   ///< Termine derivativo non filtrato.
+#define PID_DTERM_FILTER_PT1 1    ///< Filtro passa-basso del primo ordine.
+#define PID_DTERM_FILTER_BIQUAD 2 ///< Filtro passa-basso biquad (Butterworth del secondo ordine).
+
+// Funzionalità disabilitate per default: senza flag di compilazione il PID si comporta come
+// quello su cui sono tarati i guadagni (derivata dell'errore, nessun filtro, feedforward o back-calculation)
+#ifndef PID_D_ON_MEASUREMENT
+#define PID_D_ON_MEASUREMENT 0 ///< Deriva la misura invece dell'errore (nessun derivative kick sui gradini di setpoint).
+#endif
+#ifndef PID_DTERM_FILTER
+#define PID_DTERM_FILTER PID_DTERM_FILTER_NONE ///< Filtro applicato al termine derivativo.
+#endif
+#define PID_DTERM_CUTOFF_HZ 20  ///< Frequenza di taglio del filtro del termine derivativo.
+#define PID_DTERM_SAMPLE_HZ 100 ///< Frequenza nominale del loop, usata per i coefficienti del biquad.
+#ifndef PID_FEEDFORWARD
+#define PID_FEEDFORWARD 0 ///< Abilita il termine di feedforward sul setpoint.
+#endif
+#ifndef PID_ANTIWINDUP_BACKCALC
+#define PID_ANTIWINDUP_BACKCALC 0 ///< Abilita l'anti-windup a back-calculation sulla saturazione dell'output.
+#endif
+#define PID_BACKCALC_GAIN 1 ///< Guadagno di back-calculation (errore equivalente per unità di saturazione).
+#ifndef PID_BUMPLESS_TRANSFER
+#define PID_BUMPLESS_TRANSFER 0 ///< Precarica l'integrale al cambio di ASSIST_MODE per evitare salti dell'output.
+#endif
+
+#define PID_OUTPUT_LIMIT_ATTITUDE 90 ///< Limite dell'output del PID di assetto (velocità angolare richiesta).
+#define PID_OUTPUT_LIMIT_GYRO 90     ///< Limite dell'output del PID del gyro (comando degli attuatori).
+#define LQR_OUTPUT_LIMIT 90          ///< Limite dell'output del regolatore LQR (comando degli attuatori).
+
 /** @} */
 
 /** @defgroup Limits Limiti e soglie
@@ -57,6 +142,13 @@
 
 #define TUNING_TARGET_AXIS 0 ///< Asse target per il tuning (0 = X, 1 = Y, 2 = Z).
 
+#define AUTOTUNE_RELAY_GYRO 20         ///< Ampiezza del relè sull'anello del gyro (unità dell'output).
+#define AUTOTUNE_RELAY_ATTITUDE 30     ///< Ampiezza del relè sull'anello di assetto (velocità angolare richiesta).
+#define AUTOTUNE_HYSTERESIS_GYRO 2     ///< Isteresi del relè sull'errore di velocità angolare.
+#define AUTOTUNE_HYSTERESIS_ATTITUDE 0.005 ///< Isteresi del relè sull'errore di assetto (componente del quaternione).
+#define AUTOTUNE_CYCLES 4              ///< Periodi di oscillazione mediati per la stima.
+#define AUTOTUNE_TIMEOUT 20            ///< Durata massima dell'esperimento di autotuning (s).
+
 #define FORWARD_SPEED_THRESHOLD 1  ///< Soglia della velocità in avanti per la riduzione del controllo.
 #define SERVO_REDUCTION_FACTOR 0.5 ///< Fattore di riduzione per i servo.
 
@@ -67,4 +159,33 @@
 
 /** @} */
 
+/** @defgroup Input_Shaping Sagomatura degli input del pilota
+ *  Curve expo/rate e filtro dei setpoint applicati agli stick nelle modalità assistite.
+ *  @{
+ */
+
+#define INPUT_SMOOTHING_NONE 0        ///< Setpoint a gradini, aggiornati a ogni frame del ricevitore.
+#define INPUT_SMOOTHING_PT1 1         ///< Filtro passa-basso del primo ordine sui setpoint.
+#define INPUT_SMOOTHING_INTERPOLATE 2 ///< Rampa lineare verso il nuovo valore, della durata di un frame.
+
+#define INPUT_STICK_MAX 90       ///< Escursione massima degli stick (unità di `ReceiverData`).
+#define INPUT_SHAPER_LUT_SIZE 32 ///< Segmenti della tabella delle curve, su metà escursione.
+
+#define INPUT_EXPO_X 0   ///< Expo dell'asse X (0 = lineare, 1 = cubica).
+#define INPUT_EXPO_Y 0   ///< Expo dell'asse Y (0 = lineare, 1 = cubica).
+#define INPUT_EXPO_Z 0   ///< Expo dell'asse Z (0 = lineare, 1 = cubica).
+#define INPUT_RATE_X 90  ///< Setpoint a stick completo per l'asse X (gradi/s o gradi).
+#define INPUT_RATE_Y 90  ///< Setpoint a stick completo per l'asse Y (gradi/s o gradi).
+#define INPUT_RATE_Z 90  ///< Setpoint a stick completo per l'asse Z (gradi/s o gradi).
+
+// Per default i setpoint seguono gli stick senza filtro, come prima dell'InputShaper;
+// PT1 e INTERPOLATE vanno abilitati e validati in volo
+#ifndef INPUT_SMOOTHING
+#define INPUT_SMOOTHING INPUT_SMOOTHING_NONE ///< Filtro applicato ai setpoint.
+#endif
+#define INPUT_SMOOTHING_CUTOFF_HZ 20 ///< Frequenza di taglio del filtro PT1.
+#define INPUT_FRAME_INTERVAL_MS 7    ///< Periodo dei frame del ricevitore (iBUS), durata della rampa.
+
+/** @} */
+
 #endif // FLIGHT_CONTROLLER_CONFIG_H
@@ -0,0 +1,126 @@
+/**
+ * @file GainSchedule.h
+ * @brief Dichiarazione delle classi per il gain scheduling dei PID in funzione di velocità e throttle.
+ */
+#ifndef GAIN_SCHEDULE_H
+#define GAIN_SCHEDULE_H
+
+#include <atomic>
+#include <stddef.h>
+
+#define GAIN_SCHEDULE_MAX_POINTS 8 ///< Numero massimo di breakpoint per tabella.
+#define GAIN_SCHEDULE_FIELDS 12    ///< Valori interpolati per breakpoint (4 fattori × 3 assi).
+
+/**
+ * @struct GainScheduleEntry
+ * @brief Fattori moltiplicativi applicati ai guadagni PID e all'output, per asse (X, Y, Z).
+ *
+ * I valori sono memorizzati in un unico array, così l'interpolazione li percorre con un solo
+ * ciclo; gli accessori restituiscono i tre assi di ciascun fattore.
+ */
+struct GainScheduleEntry
+{
+    float field[GAIN_SCHEDULE_FIELDS]; ///< Fattori kp, ki, kd e output, 3 assi ciascuno.
+
+    float *kp() { return &field[0]; }                  ///< Fattori di scala del guadagno proporzionale.
+    float *ki() { return &field[3]; }                  ///< Fattori di scala del guadagno integrale.
+    float *kd() { return &field[6]; }                  ///< Fattori di scala del guadagno derivativo.
+    float *output() { return &field[9]; }              ///< Fattori di scala dell'output.
+    const float *kp() const { return &field[0]; }      ///< Fattori di scala del guadagno proporzionale.
+    const float *ki() const { return &field[3]; }      ///< Fattori di scala del guadagno integrale.
+    const float *kd() const { return &field[6]; }      ///< Fattori di scala del guadagno derivativo.
+    const float *output() const { return &field[9]; }  ///< Fattori di scala dell'output.
+};
+
+/**
+ * @brief Tabella di breakpoint interpolata linearmente.
+ *
+ * Le pendenze di ogni segmento vengono precalcolate alla costruzione: la valutazione
+ * richiede solo una ricerca sui breakpoint e un prodotto-somma per valore, senza divisioni.
+ * Fuori dall'intervallo dei breakpoint viene mantenuto il valore dell'estremo più vicino.
+ */
+class GainScheduleTable
+{
+private:
+    size_t count;                                        ///< Numero di breakpoint.
+    float breakpoints[GAIN_SCHEDULE_MAX_POINTS];         ///< Breakpoint in ordine crescente.
+    GainScheduleEntry values[GAIN_SCHEDULE_MAX_POINTS];  ///< Valori ai breakpoint.
+    GainScheduleEntry slopes[GAIN_SCHEDULE_MAX_POINTS];  ///< Pendenze del segmento che inizia al breakpoint.
+
+public:
+    /**
+     * @brief Costruttore della classe GainScheduleTable.
+     *
+     * @param breakpoints Breakpoint in ordine strettamente crescente.
+     * @param values Valori ai breakpoint.
+     * @param count Numero di breakpoint (1 - GAIN_SCHEDULE_MAX_POINTS); l'eccesso viene scartato.
+     */
+    GainScheduleTable(const float *breakpoints, const GainScheduleEntry *values, size_t count);
+
+    /**
+     * @brief Valuta la tabella.
+     *
+     * @param x Variabile di scheduling (velocità o throttle).
+     * @param result Valori interpolati.
+     */
+    void evaluate(float x, GainScheduleEntry &result) const;
+};
+
+/**
+ * @brief Classe per il gain scheduling.
+ *
+ * Combina una tabella indicizzata dalla velocità stimata e una indicizzata dal throttle,
+ * moltiplicando i fattori. Una tabella assente equivale a fattori unitari. Le tabelle possono
+ * essere sostituite a runtime da un altro task: lo scambio del puntatore è atomico e ogni
+ * ciclo legge una tabella completa. Le tabelle devono restare valide finché sono in uso.
+ */
+class GainScheduler
+{
+private:
+    std::atomic<const GainScheduleTable *> speed_table;    ///< Tabella indicizzata dalla velocità.
+    std::atomic<const GainScheduleTable *> throttle_table; ///< Tabella indicizzata dal throttle.
+
+public:
+    /**
+     * @brief Costruttore della classe GainScheduler.
+     *
+     * @param speed_table Tabella indicizzata dalla velocità (può essere nullptr).
+     * @param throttle_table Tabella indicizzata dal throttle (può essere nullptr).
+     */
+    GainScheduler(const GainScheduleTable *speed_table, const GainScheduleTable *throttle_table);
+
+    /**
+     * @brief Sostituisce la tabella indicizzata dalla velocità.
+     *
+     * @param table Nuova tabella (nullptr per disabilitarla).
+     * @return const GainScheduleTable* Tabella sostituita.
+     */
+    const GainScheduleTable *set_speed_table(const GainScheduleTable *table);
+
+    /**
+     * @brief Sostituisce la tabella indicizzata dal throttle.
+     *
+     * @param table Nuova tabella (nullptr per disabilitarla).
+     * @return const GainScheduleTable* Tabella sostituita.
+     */
+    const GainScheduleTable *set_throttle_table(const GainScheduleTable *table);
+
+    /**
+     * @brief Calcola i fattori di scala per il ciclo corrente.
+     *
+     * @param speed Velocità stimata.
+     * @param throttle Throttle corrente.
+     * @param result Fattori di scala combinati.
+     */
+    void evaluate(float speed, float throttle, GainScheduleEntry &result) const;
+
+    /**
+     * @brief Restituisce la tabella predefinita indicizzata dalla velocità.
+     *
+     * Riproduce la rampa lineare dell'output tra 1 e `SERVO_REDUCTION_FACTOR` fino a
+     * `FORWARD_SPEED_THRESHOLD`, lasciando invariati i guadagni.
+     */
+    static const GainScheduleTable &default_speed_table();
+};
+
+#endif // GAIN_SCHEDULE_H
@@ -13,15 +13,56 @@
  * e ai valori utilizzati per configurare il sistema.
  */
 
-#define ESC_PWM_CHANNEL 0 ///< Canale PWM utilizzato per l'ESC.
+/** @defgroup PWM_Channels Canali e timer LEDC
+ *  @{
+ */
+#define ESC_PWM_CHANNEL 0 ///< Canale LEDC utilizzato per l'ESC.
+
+#define SERVO_X_PWM_CHANNEL 1 ///< Canale LEDC utilizzato per il servomotore X.
+#define SERVO_Y_PWM_CHANNEL 2 ///< Canale LEDC utilizzato per il servomotore Y.
+#define SERVO_Z_PWM_CHANNEL 3 ///< Canale LEDC utilizzato per il servomotore Z.
 
-#define RGB_RED_PWM_CHANNEL 1   ///< Canale PWM utilizzato per il LED rosso.
-#define RGB_GREEN_PWM_CHANNEL 2 ///< Canale PWM utilizzato per il LED verde.
-#define RGB_BLUE_PWM_CHANNEL 3  ///< Canale PWM utilizzato per il LED blu.
+#define RGB_RED_PWM_CHANNEL 7   ///< Canale LEDC assegnato da `analogWrite` al LED rosso.
+#define RGB_GREEN_PWM_CHANNEL 6 ///< Canale LEDC assegnato da `analogWrite` al LED verde.
+#define RGB_BLUE_PWM_CHANNEL 5  ///< Canale LEDC assegnato da `analogWrite` al LED blu.
+
+#define ESC_PWM_TIMER 0   ///< Timer LEDC dell'ESC.
+#define SERVO_PWM_TIMER 1 ///< Timer LEDC condiviso dai servomotori (i timer 2 e 3 sono usati da `analogWrite`).
+/** @} */
 
-#define SERVO_X_PWM_CHANNEL 4 ///< Canale PWM utilizzato per il servomotore X.
-#define SERVO_Y_PWM_CHANNEL 5 ///< Canale PWM utilizzato per il servomotore Y.
-#define SERVO_Z_PWM_CHANNEL 6 ///< Canale PWM utilizzato per il servomotore Z.
+/** @defgroup Output_Protocols Protocolli di uscita
+ *  @{
+ */
+/**
+ * @brief Protocollo dell'ESC.
+ *
+ * Il valore predefinito è il PWM standard a 50 Hz (1000-2000 µs), accettato da qualsiasi ESC
+ * e identico al segnale generato in precedenza tramite ESP32Servo. OneShot125, Multishot e
+ * DShot vanno abilitati esplicitamente solo con ESC che li supportano, ad esempio
+ * `-DESC_PROTOCOL=ACTUATOR_PROTOCOL::ONESHOT125` nei build flag.
+ */
+#ifndef ESC_PROTOCOL
+#define ESC_PROTOCOL ACTUATOR_PROTOCOL::SERVO_50HZ
+#endif
+
+/**
+ * @brief Protocollo dei servomotori.
+ *
+ * Il valore predefinito a 50 Hz è sicuro per qualsiasi servo. SERVO_333HZ e SERVO_560HZ
+ * surriscaldano i servo analogici: vanno abilitati esplicitamente solo con servo digitali,
+ * ad esempio `-DSERVO_PROTOCOL=ACTUATOR_PROTOCOL::SERVO_333HZ` nei build flag.
+ */
+#ifndef SERVO_PROTOCOL
+#define SERVO_PROTOCOL ACTUATOR_PROTOCOL::SERVO_50HZ
+#endif
+
+#define ESC_RMT_TX_CHANNEL 0  ///< Canale RMT di trasmissione per DShot (0-3 sull'ESP32-S3).
+#define ESC_RMT_RX_CHANNEL 4  ///< Canale RMT di ricezione per la telemetria DShot (4-7 sull'ESP32-S3).
+#define ESC2_RMT_TX_CHANNEL 1 ///< Canale RMT di trasmissione del secondo motore (spinta differenziale con DShot).
+#define ESC2_RMT_RX_CHANNEL 5 ///< Canale RMT di ricezione del secondo motore (spinta differenziale con DShot).
+#define DSHOT_BIDIRECTIONAL 1 ///< Abilita la telemetria eRPM bidirezionale.
+#define MOTOR_POLES 14        ///< Numero di poli magnetici del motore (per la conversione eRPM -> RPM).
+/** @} */
 
 /** @defgroup PWM_Ranges Intervalli PWM
  *  @{
@@ -33,6 +74,13 @@
 #define PWM_MAX_SERVO 2000 ///< Valore massimo del segnale PWM per i servomotori.
 /** @} */
 
+/** @defgroup Mixer_Parameters Parametri del mixer
+ *  @{
+ */
+#define AIRFRAME_PROFILE StandardAirframe ///< Profilo di velivolo (vedi `AirframeConfig.h`), che determina il mixer.
+#define DIFFERENTIAL_THRUST_YAW 0.3       ///< Peso dello yaw sulla spinta differenziale.
+/** @} */
+
 /** @defgroup Servo_Ranges Intervalli Servo
  *  @{
  */
@@ -0,0 +1,105 @@
+/**
+ * @file IBusParser.h
+ * @brief Dichiarazione del parser del protocollo IBUS, indipendente dalla UART.
+ */
+#ifndef IBUS_PARSER_H
+#define IBUS_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "DataStructures.h"
+
+/**
+ * @brief Statistiche del parser IBUS.
+ *
+ * Misurano il lavoro svolto dal parser per rendere visibile il caso peggiore
+ * su collegamenti rumorosi.
+ */
+struct ReceiverStats
+{
+    uint32_t bytesRead;        ///< Byte letti dalla UART.
+    uint32_t bytesDiscarded;   ///< Byte scartati durante la risincronizzazione.
+    uint32_t packetsValid;     ///< Pacchetti con header e checksum validi.
+    uint32_t checksumErrors;   ///< Pacchetti scartati per checksum errato.
+    uint32_t budgetExhausted;  ///< Chiamate a `read` interrotte per budget esaurito.
+    uint32_t maxBytesPerRead;  ///< Massimo numero di byte elaborati in una singola chiamata.
+    uint32_t maxWorkPerRead;   ///< Massimo numero di byte esaminati/spostati in una singola chiamata.
+};
+
+/**
+ * @brief Parser del flusso IBUS.
+ *
+ * Riceve blocchi di byte già letti dalla UART e ne estrae i pacchetti validi.
+ * Non dipende dall'hardware, così può essere compilato sull'host per il fuzzing
+ * e per la misura del costo per byte.
+ */
+class IBusParser
+{
+public:
+    static const size_t PACKET_SIZE = 32; ///< Dimensione del pacchetto IBUS.
+    static const uint8_t HEADER_1 = 0x20; ///< Primo byte dell'header del pacchetto IBUS.
+    static const uint8_t HEADER_2 = 0x40; ///< Secondo byte dell'header del pacchetto IBUS.
+    static const int CHANNELS = 10;       ///< Numero di canali decodificati.
+
+    IBusParser();
+
+    /**
+     * @brief Elabora un blocco di byte ricevuti.
+     *
+     * I byte di un pacchetto incompleto restano nel buffer interno per la chiamata
+     * successiva. Se il blocco contiene più pacchetti validi, `data` contiene il più recente.
+     *
+     * @param bytes Byte ricevuti.
+     * @param length Numero di byte ricevuti.
+     * @param data Riferimento alla struttura `ReceiverData` da aggiornare.
+     * @return true Se almeno un pacchetto valido è stato decodificato.
+     */
+    bool parse(const uint8_t *bytes, size_t length, ReceiverData &data);
+
+    /**
+     * @brief Scarta il pacchetto parziale nel buffer.
+     */
+    void reset();
+
+    /**
+     * @brief Conta una lettura interrotta per budget esaurito.
+     */
+    void countBudgetExhausted() { stats.budgetExhausted++; }
+
+    /**
+     * @brief Restituisce il numero di byte di un pacchetto incompleto nel buffer.
+     */
+    size_t pending() const { return bufferIndex; }
+
+    /**
+     * @brief Restituisce le statistiche del parser.
+     */
+    const ReceiverStats &getStats() const { return stats; }
+
+private:
+    uint8_t buffer[PACKET_SIZE]; ///< Buffer per la memorizzazione del pacchetto IBUS.
+    size_t bufferIndex;          ///< Indice corrente del buffer.
+    ReceiverStats stats;         ///< Statistiche del parser.
+
+    /**
+     * @brief Verifica e decodifica un pacchetto IBUS dal buffer.
+     *
+     * @param data Riferimento alla struttura `ReceiverData` da aggiornare.
+     * @return true Se il pacchetto è valido.
+     * @return false Se il pacchetto è invalido.
+     */
+    bool decodePacket(ReceiverData &data);
+
+    /**
+     * @brief Riallinea il buffer al primo possibile inizio di pacchetto.
+     *
+     * Scarta in un'unica operazione tutti i byte che precedono il primo header
+     * candidato, invece di scorrere il buffer un byte alla volta.
+     *
+     * @param from Indice da cui iniziare la ricerca dell'header.
+     * @return size_t Numero di byte esaminati o spostati.
+     */
+    size_t resync(size_t from);
+};
+
+#endif // IBUS_PARSER_H
@@ -24,13 +24,6 @@ public:
    */
   IMU();
 
-  /**
-   * @brief Salva i dati letti dall'IMU.
-   *
-   * @param data Dati letti dall'IMU.
-   */
-  void logData(const ImuData &data);
-
   /**
    * @brief Legge i dati dall'IMU.
    *
@@ -0,0 +1,70 @@
+/**
+ * @file InputShaper.h
+ * @brief Dichiarazione della classe InputShaper per la sagomatura degli input del pilota.
+ */
+
+#ifndef INPUT_SHAPER_H
+#define INPUT_SHAPER_H
+
+#include "FlightControllerConfig.h"
+
+/**
+ * @brief Classe per la sagomatura degli stick: curve expo/rate e filtro dei setpoint.
+ *
+ * Le curve f(n) = rate · (expo · n³ + (1 - expo) · n), con n = |stick| / `INPUT_STICK_MAX`,
+ * vengono campionate alla costruzione in una tabella per asse con pendenze precalcolate: la
+ * valutazione richiede un indice, un prodotto-somma e nessuna potenza. Le curve sono dispari,
+ * quindi la tabella copre solo metà escursione.
+ *
+ * Il ricevitore aggiorna gli stick a gradini (un frame ogni `INPUT_FRAME_INTERVAL_MS`); il filtro
+ * selezionato con `INPUT_SMOOTHING` distribuisce ogni gradino su più cicli di controllo, così
+ * feedforward e derivata non vedono un impulso a ogni nuovo frame.
+ */
+class InputShaper
+{
+private:
+    float lut[3][INPUT_SHAPER_LUT_SIZE + 1]; ///< Curve campionate per asse (X, Y, Z).
+    float slope[3][INPUT_SHAPER_LUT_SIZE];   ///< Pendenze dei segmenti, per unità di indice.
+    float smoothed[3];                       ///< Setpoint filtrati (X, Y, Z).
+#if INPUT_SMOOTHING == INPUT_SMOOTHING_INTERPOLATE
+    float target[3];  ///< Ultimo setpoint ricevuto, obiettivo della rampa.
+    float step[3];    ///< Incremento per ciclo della rampa.
+    int remaining[3]; ///< Cicli mancanti al termine della rampa.
+#endif
+
+public:
+    /**
+     * @brief Costruttore della classe InputShaper.
+     *
+     * @param expo Expo per asse (0 = lineare, 1 = cubica).
+     * @param rate Setpoint a stick completo per asse.
+     */
+    InputShaper(const float expo[3], const float rate[3]);
+
+    /**
+     * @brief Applica la curva di un asse.
+     *
+     * @param axis Asse (0 = X, 1 = Y, 2 = Z).
+     * @param stick Posizione dello stick (±`INPUT_STICK_MAX`, oltre viene saturata).
+     * @return float Setpoint sagomato.
+     */
+    float shape(int axis, float stick) const;
+
+    /**
+     * @brief Calcola i setpoint del ciclo corrente.
+     *
+     * @param stick Posizioni degli stick (X, Y, Z).
+     * @param dt Intervallo di tempo dall'ultimo ciclo (s).
+     * @param setpoint Setpoint sagomati e filtrati (X, Y, Z).
+     */
+    void update(const float stick[3], float dt, float setpoint[3]);
+
+    /**
+     * @brief Porta il filtro direttamente sui setpoint degli stick indicati.
+     *
+     * @param stick Posizioni degli stick (X, Y, Z).
+     */
+    void reset(const float stick[3]);
+};
+
+#endif // INPUT_SHAPER_H
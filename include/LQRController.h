@@ -0,0 +1,52 @@
+/**
+ * @file LQRController.h
+ * @brief Dichiarazione della classe LQRController per il controllo a retroazione dello stato.
+ */
+
+#ifndef LQR_CONTROLLER_H
+#define LQR_CONTROLLER_H
+
+#include "LQRGains.h"
+
+/**
+ * @brief Regolatore lineare quadratico (LQR) a guadagno costante.
+ *
+ * Calcola u = -K (x - x_ref), con stato x = [errore di assetto X, Y, Z (gradi); velocità
+ * angolari X, Y, Z (gradi/s)] e K (3×6) calcolata offline da `tools/lqr_gains.py`. A differenza
+ * dei PID per asse, K contiene anche i termini incrociati tra rollio e imbardata. Il calcolo è
+ * un prodotto matrice-vettore in singola precisione (18 prodotti-somma) senza stato interno,
+ * quindi il cambio di modalità non richiede riallineamenti.
+ */
+class LQRController
+{
+private:
+    float gains[LQR_INPUTS][LQR_STATES]; ///< Matrice dei guadagni K.
+    float outputLimit;                   ///< Limite simmetrico dell'output.
+
+public:
+    /**
+     * @brief Costruttore della classe LQRController.
+     *
+     * @param gains Matrice dei guadagni K (ingressi × stati).
+     * @param outputLimit Limite simmetrico dell'output.
+     */
+    LQRController(const float gains[LQR_INPUTS][LQR_STATES], float outputLimit);
+
+    /**
+     * @brief Calcola i comandi dei tre assi.
+     *
+     * @param state Stato misurato.
+     * @param reference Stato di riferimento.
+     * @param output Comandi calcolati (X, Y, Z), limitati a ±`outputLimit`.
+     */
+    void update(const float state[LQR_STATES], const float reference[LQR_STATES], float output[LQR_INPUTS]) const;
+
+    /**
+     * @brief Sostituisce la matrice dei guadagni.
+     *
+     * @param gains Nuova matrice dei guadagni K (ingressi × stati).
+     */
+    void set_gains(const float gains[LQR_INPUTS][LQR_STATES]);
+};
+
+#endif // LQR_CONTROLLER_H
@@ -0,0 +1,23 @@
+/**
+ * @file LQRGains.h
+ * @brief Guadagni del regolatore LQR, generati da tools/lqr_gains.py. Non modificare a mano.
+ *
+ * Modello: dt=0.01, Lp=-8.0, Lr=1.5, Mq=-6.0, Mtheta=-4.0, Np=-0.8, Nr=-2.0, La=12.0, Lrud=1.0, Me=10.0, Na=-1.2, Nrud=6.0, max_attitude_error=10.0, max_rate=90.0, max_command=60.0
+ * Raggio spettrale stimato in anello chiuso: 0.9477
+ */
+
+#ifndef LQR_GAINS_H
+#define LQR_GAINS_H
+
+#define LQR_STATES 6 ///< Stati: errore di assetto (X, Y, Z, gradi) e velocità angolari (X, Y, Z, gradi/s).
+#define LQR_INPUTS 3 ///< Ingressi: comandi degli assi X, Y, Z.
+
+/**
+ * @brief Matrice dei guadagni K (ingressi × stati) del regolatore u = -K (x - x_ref).
+ */
+inline constexpr float LQR_GAINS[LQR_INPUTS][LQR_STATES] = {
+    {5.595814f, 0.000000f, -1.312819f, 0.671016f, 0.000000f, -0.167959f},
+    {0.000000f, 5.381027f, 0.000000f, 0.000000f, 0.761851f, 0.000000f},
+    {1.340191f, 0.000000f, 5.619405f, 0.089995f, 0.000000f, 1.217245f}};
+
+#endif // LQR_GAINS_H
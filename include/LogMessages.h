@@ -0,0 +1,251 @@
+/**
+ * @file LogMessages.h
+ * @brief Tabella dei messaggi di log a formattazione differita.
+ */
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+#include "DataStructures.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+#define LOG_EVENT_ARGS 6 ///< Argomenti massimi di un messaggio (parole da 32 bit).
+
+/**
+ * @brief Tabella dei messaggi: identificativo, livello e formato.
+ *
+ * I messaggi emessi con `Logger::logEvent` portano solo identificativo, istante e argomenti
+ * grezzi; il testo viene composto dal task della seriale e, a terra, da
+ * `server/log_messages.py`, che legge questa tabella da questo file.
+ *
+ * Il formato è ASCII senza sequenze di escape e accetta solo conversioni a 32 bit: `%d`/`%i`
+ * (intero con segno), `%u`/`%x` (senza segno), `%f` (float), con flag, larghezza e
+ * precisione; `%%` per il carattere `%`. L'identificativo è la posizione nella tabella: i
+ * messaggi nuovi vanno aggiunti in fondo.
+ */
+#define LOG_MESSAGES(X)                                                                                        \
+    X(STATE_ARMED, INFO, "Controller state set -> ARMED.")                                                     \
+    X(STATE_DISARMED, INFO, "Controller state set -> DISARMED.")                                               \
+    X(STATE_FAILSAFE, WARNING, "Controller state set -> FAILSAFE.")                                            \
+    X(FAILSAFE_RELEASED, WARNING, "Failsafe mode released.")                                                   \
+    X(IMU_ERROR, ERROR, "IMU error detected.")                                                                 \
+    X(RECEIVER_ERROR, ERROR, "Receiver error detected.")                                                       \
+    X(FAILSAFE_ASSIST_MANUAL, WARNING, "Assist mode set -> Manual")                                            \
+    X(FAILSAFE_ASSIST_ATTITUDE, WARNING, "Assist mode set -> Attitude control")                                \
+    X(IMU_MISSING_ASSIST_MANUAL, WARNING, "IMU not set up. Assist mode set -> Manual")                         \
+    X(IMU_MISSING_MODE_STANDARD, WARNING, "IMU not set up. Controller mode set -> Standard")                   \
+    X(ASSIST_LQR_CONTROL, INFO, "Assist mode set -> LQR control")                                              \
+    X(ASSIST_MANUAL, INFO, "Assist mode set -> Manual")                                                        \
+    X(ASSIST_GYRO_STABILIZED, INFO, "Assist mode set -> Gyro stabilized")                                      \
+    X(ASSIST_ATTITUDE_CONTROL, INFO, "Assist mode set -> Attitude control")                                    \
+    X(MODE_AUTOTUNE, INFO, "Controller mode set -> Autotune")                                                  \
+    X(MODE_STANDARD, INFO, "Controller mode set -> Standard")                                                  \
+    X(MODE_KP_CALIBRATION, INFO, "Controller mode set -> KP calibration")                                      \
+    X(MODE_KI_CALIBRATION, INFO, "Controller mode set -> KI calibration")                                      \
+    X(MODE_KD_CALIBRATION, INFO, "Controller mode set -> KD calibration")                                      \
+    X(CRITICAL_ERROR, ERROR, "Critical error detected. System halted. Prayers sent.")                          \
+    X(KP_UPDATED, INFO, "Kp updated")                                                                          \
+    X(KI_UPDATED, INFO, "Ki updated")                                                                          \
+    X(KD_UPDATED, INFO, "Kd updated")                                                                          \
+    X(PID_STATE_TRANSFERRED, INFO, "PID state transferred on assist mode change.")                             \
+    X(AUTOTUNE_ABORTED, WARNING, "Autotune aborted.")                                                          \
+    X(AUTOTUNE_STARTED, INFO, "Autotune started on axis %d.")                                                  \
+    X(AUTOTUNE_FAILED, WARNING, "Autotune failed: no stable oscillation.")                                     \
+    X(AUTOTUNE_GYRO_RESULT, INFO, "Autotune gyro axis %d: Ku=%f Tu=%f -> Kp=%f Ki=%f Kd=%f")                   \
+    X(AUTOTUNE_ATTITUDE_RESULT, INFO, "Autotune attitude axis %d: Ku=%f Tu=%f -> Kp=%f Ki=%f Kd=%f")           \
+    X(GAIN_TABLE_TRUNCATED, WARNING, "Gain schedule table truncated.")                                         \
+    X(GAIN_BREAKPOINTS_NOT_INCREASING, ERROR, "Gain schedule breakpoints not increasing.")                     \
+    X(LOG_QUEUE_FULL, WARNING, "Log queue full: %u messages dropped.")                                         \
+    X(DATA_QUEUE_FULL, WARNING, "Data queue full: %u records dropped.")                                        \
+    X(SERIAL_QUEUE_FULL, WARNING, "Serial log queue full: %u messages dropped.")                               \
+    X(SERIAL_COMMAND_UNKNOWN, WARNING, "Unknown serial command.")                                              \
+    X(TELEMETRY_UPLOAD, INFO, "Telemetry upload: %u rows/s, %u bytes/s, %u queued.")                           \
+    X(DATA_UPLOAD_FAILED, ERROR, "Failed to send data logs to server. HTTP error: %d")                         \
+    X(LOGGER_BUFFERS_PSRAM, INFO, "Logger buffers in PSRAM: %u records, %u log messages per queue, %u KB.")    \
+    X(LOGGER_BUFFERS_INTERNAL, INFO, "Logger buffers in RAM: %u records, %u log messages per queue, %u KB.")   \
+    X(LOGGER_BUFFERS_FAILED, ERROR, "Logger buffers not allocated (%u bytes).")                                \
+    X(BUFFER_HIGH_WATER, INFO, "Buffer high water: %u/%u records, %u/%u log messages.")                        \
+    X(TELEMETRY_CHANNEL_REJECTED, WARNING, "Telemetry channel %u not registered.")                             \
+    X(TELEMETRY_CHANNEL_SET, INFO, "Telemetry channel %u: divider %u.")                                        \
+    X(TELEMETRY_CHANNEL_UNKNOWN, WARNING, "Unknown telemetry channel.")                                        \
+    X(SERVICE_NOT_FOUND, WARNING, "No service found.")                                                         \
+    X(SERVICE_FOUND, INFO, "Service found.")                                                                   \
+    X(SERVER_FOUND, INFO, "Server found.")                                                                     \
+    X(SERVER_NOT_FOUND, WARNING, "Target server not found.")                                                   \
+    X(WIFI_LOST, WARNING, "WiFi connection lost.")                                                             \
+    X(WIFI_CONNECTING, WARNING, "Attempting to connect to WiFi...")                                            \
+    X(TIME_SYNCHRONIZING, INFO, "Synchronizing time with NTP server...")                                       \
+    X(TIME_SYNCHRONIZED, INFO, "Time synchronized.")                                                           \
+    X(MDNS_FAILED, ERROR, "Error starting mDNS.")                                                              \
+    X(MDNS_STARTED, INFO, "mDNS responder started.")                                                           \
+    X(WIFI_CONNECTED, INFO, "Connected to WiFi.")                                                              \
+    X(SERVER_CHECK_SKIPPED, WARNING, "WiFi not connected. Skipping server check.")                             \
+    X(SERVER_CONNECTED, INFO, "Connection to server established.")                                             \
+    X(SERVER_CONNECTION_FAILED, WARNING, "Connection to server failed.")                                       \
+    X(BLACKBOX_NOT_AVAILABLE, ERROR, "Blackbox storage not available.")                                        \
+    X(BLACKBOX_READ_FAILED, ERROR, "Blackbox storage read failed.")                                            \
+    X(BLACKBOX_STATUS, INFO, "Blackbox: %u KB used of %u KB, last session %u.")                                \
+    X(BLACKBOX_RECOVERED, WARNING, "Blackbox: recovered interrupted block with %u records.")                   \
+    X(BLACKBOX_SESSION_CLOSED, INFO, "Blackbox: session %u closed, %u records, %u lost, %u dropped.")          \
+    X(BLACKBOX_ERASE_STARTED, INFO, "Blackbox: erase started.")                                                \
+    X(BLACKBOX_INFO, INFO, "Blackbox: %u KB used, %u KB prepared of %u KB, %u records, %u errors.")            \
+    X(BLACKBOX_BUSY, WARNING, "Blackbox: command not available while recording.")
+
+/**
+ * @brief Identificativo di un messaggio di log.
+ */
+enum class LOG_ID : uint16_t
+{
+    TEXT = 0, ///< Testo libero, emesso con `Logger::log`.
+#define LOG_MESSAGE_ID(id, level, format) id,
+    LOG_MESSAGES(LOG_MESSAGE_ID)
+#undef LOG_MESSAGE_ID
+    COUNT ///< Numero di identificativi.
+};
+
+/**
+ * @struct LogMessageInfo
+ * @brief Voce della tabella dei messaggi.
+ */
+struct LogMessageInfo
+{
+    LogLevel level;     ///< Livello del messaggio.
+    const char *format; ///< Formato del testo.
+};
+
+/**
+ * @brief Tabella dei messaggi, indicizzata per `LOG_ID`.
+ */
+inline constexpr LogMessageInfo logMessageTable[] = {
+    {LogLevel::INFO, ""}, // TEXT: il testo viaggia con il messaggio
+#define LOG_MESSAGE_INFO(id, level, format) {LogLevel::level, format},
+    LOG_MESSAGES(LOG_MESSAGE_INFO)
+#undef LOG_MESSAGE_INFO
+};
+
+static_assert(sizeof(logMessageTable) / sizeof(logMessageTable[0]) == static_cast<size_t>(LOG_ID::COUNT),
+              "Tabella dei messaggi incompleta");
+
+/**
+ * @brief Restituisce la voce della tabella di un messaggio.
+ */
+constexpr const LogMessageInfo &log_message_info(LOG_ID id)
+{
+    return logMessageTable[static_cast<size_t>(id) < static_cast<size_t>(LOG_ID::COUNT) ? static_cast<size_t>(id) : 0];
+}
+
+/**
+ * @brief Restituisce la conversione (`d`, `i`, `u`, `x`, `f`...) dell'argomento `index` di un formato.
+ *
+ * @return char Carattere di conversione; '\0' se il formato ha meno argomenti.
+ */
+constexpr char log_conversion(const char *format, size_t index)
+{
+    for (size_t i = 0; format[i] != '\0'; ++i)
+    {
+        if (format[i] != '%')
+            continue;
+        if (format[++i] == '%')
+            continue;
+        while (format[i] == '-' || format[i] == '+' || format[i] == ' ' || format[i] == '#' || format[i] == '0' ||
+               format[i] == '.' || (format[i] >= '1' && format[i] <= '9'))
+            ++i;
+        if (format[i] == '\0')
+            return '\0';
+        if (index-- == 0)
+            return format[i];
+    }
+    return '\0';
+}
+
+/**
+ * @brief Restituisce il numero di argomenti di un formato.
+ */
+constexpr size_t log_argument_count(const char *format)
+{
+    size_t count = 0;
+    while (log_conversion(format, count) != '\0')
+        ++count;
+    return count;
+}
+
+/**
+ * @brief Verifica che un argomento di tipo `T` sia compatibile con una conversione.
+ */
+template <typename T>
+constexpr bool log_argument_matches(char conversion)
+{
+    if (std::is_floating_point<T>::value)
+        return conversion == 'f';
+    return (std::is_integral<T>::value || std::is_enum<T>::value) && sizeof(T) <= sizeof(uint32_t) &&
+           (conversion == 'd' || conversion == 'i' || conversion == 'u' || conversion == 'x');
+}
+
+/**
+ * @brief Verifica gli argomenti `Args` contro le conversioni di un formato.
+ */
+template <typename... Args, size_t... I>
+constexpr bool log_arguments_match(const char *format, std::index_sequence<I...>)
+{
+    static_cast<void>(format); // Inutilizzato senza argomenti
+    return (log_argument_matches<Args>(log_conversion(format, I)) && ... && true);
+}
+
+/**
+ * @brief Impronta della tabella (FNV-1a su livello e formato di ogni messaggio).
+ *
+ * Viene inviata con i messaggi: il server la confronta con quella della tabella che legge e
+ * segnala un firmware compilato con una tabella diversa.
+ */
+constexpr uint32_t log_table_hash()
+{
+    uint32_t hash = 2166136261u;
+    for (size_t id = 1; id < static_cast<size_t>(LOG_ID::COUNT); ++id)
+    {
+        hash = (hash ^ static_cast<uint8_t>(logMessageTable[id].level)) * 16777619u;
+        const char *format = logMessageTable[id].format;
+        for (size_t i = 0;; ++i)
+        {
+            hash = (hash ^ static_cast<uint8_t>(format[i])) * 16777619u;
+            if (format[i] == '\0')
+                break;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Converte un argomento nella parola da 32 bit trasmessa (bit del float per i reali).
+ */
+template <typename T>
+inline uint32_t log_argument(T value)
+{
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        const float f = static_cast<float>(value);
+        uint32_t word;
+        memcpy(&word, &f, sizeof(word));
+        return word;
+    }
+    else
+    {
+        return static_cast<uint32_t>(value);
+    }
+}
+
+/**
+ * @brief Compone il testo di un messaggio dal formato e dagli argomenti grezzi.
+ *
+ * @param id Identificativo del messaggio.
+ * @param args Argomenti grezzi.
+ * @param argc Numero di argomenti; quelli mancanti valgono 0.
+ * @param buffer Buffer di destinazione.
+ * @param size Dimensione del buffer; il testo viene troncato se necessario.
+ * @return size_t Caratteri scritti, terminatore escluso.
+ */
+size_t log_render(LOG_ID id, const uint32_t *args, uint8_t argc, char *buffer, size_t size);
+
+#endif // LOG_MESSAGES_H
@@ -6,57 +6,249 @@
 #define LOGGER_H
 
 #include "DataStructures.h"
+#include "LogMessages.h"
+#include "SPSCQueue.h"
+#include "Telemetry.h"
+#if TELEMETRY_TRANSPORT == TELEMETRY_TRANSPORT_UDP
+#include "TelemetryStream.h"
+#endif
 #include <string>
-#include <vector>
 #include <mutex>
-#include <deque>
 #include <iostream>
+#include <utility>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define LOG_MESSAGE_SIZE 128               ///< Lunghezza massima di un testo di log in coda (terminatore incluso).
+#define LOG_LINE_SIZE (LOG_MESSAGE_SIZE + 24) ///< Lunghezza massima di una riga formattata, con timestamp e livello.
+#define LOG_QUEUE_SIZE 32                  ///< Messaggi per coda della seriale e minimo per le code verso il server (potenza di 2).
+
+#define LOG_BUDGET_PSRAM (1024 * 1024)  ///< Memoria per le code di telemetria e di log verso il server, in PSRAM (byte).
+#define LOG_BUDGET_INTERNAL (48 * 1024) ///< Memoria per le stesse code in RAM interna, senza PSRAM (byte).
+#define LOG_BUDGET_LOG_DIVISOR 32       ///< Ogni coda di log verso il server riceve 1/N del budget.
+
+#define LOG_SERIAL_TX_BUFFER 1024 ///< Buffer di trasmissione della seriale, svuotato dall'interrupt della UART (byte).
+#define LOG_SERIAL_PERIOD_MS 10   ///< Periodo del task di scrittura sulla seriale.
+
+/**
+ * @struct LogMessage
+ * @brief Messaggio di log non formattato, a dimensione fissa per le code senza allocazioni.
+ *
+ * I messaggi della tabella (`LogMessages.h`) portano solo identificativo e argomenti grezzi;
+ * il testo libero viene copiato così com'è. Timestamp e livello vengono formattati da chi
+ * scrive il messaggio (`Logger::formatLog`).
+ */
+struct LogMessage
+{
+    uint32_t timestamp_ms; ///< Istante del messaggio (ms dall'avvio).
+    LogLevel level;        ///< Livello del messaggio.
+    LOG_ID id;             ///< Messaggio della tabella, o `LOG_ID::TEXT` per il testo libero.
+    uint8_t argc;          ///< Argomenti grezzi in `args`.
+    union
+    {
+        uint32_t args[LOG_EVENT_ARGS]; ///< Argomenti grezzi (messaggi della tabella).
+        char text[LOG_MESSAGE_SIZE];   ///< Testo, troncato se necessario (solo `LOG_ID::TEXT`).
+    };
+};
+
+/**
+ * @struct LoggerMemoryStats
+ * @brief Memoria e riempimento delle code di telemetria e di log verso il server.
+ */
+struct LoggerMemoryStats
+{
+    size_t budget;          ///< Byte del budget allocato (0 se l'allocazione è fallita).
+    bool psram;             ///< Il budget è in PSRAM.
+    uint32_t dataCapacity;  ///< Record di telemetria memorizzabili.
+    uint32_t dataHighWater; ///< Massimo numero di record in coda.
+    uint32_t dataDropped;   ///< Record scartati per coda piena.
+    uint32_t logCapacity;   ///< Messaggi memorizzabili per coda di log.
+    uint32_t logHighWater;  ///< Massimo numero di messaggi in una coda di log.
+    uint32_t logDropped;    ///< Messaggi scartati per code piene.
+};
 
 /**
  * @brief Classe per la gestione dei log di sistema e dei dati numerici.
  *
  * La classe fornisce un'interfaccia per la registrazione e l'invio di log di sistema
  * e dati numerici. Implementata come Singleton.
+ *
+ * Il ciclo di controllo comunica con il task di invio solo tramite code lock-free
+ * (`SPSCQueue`): una per i record di telemetria e una per i suoi messaggi di log. Gli altri
+ * task (WiFi, invio) condividono una seconda coda di log, serializzata tra loro da un mutex
+ * che il ciclo di controllo non prende mai. Con una coda piena il nuovo elemento viene
+ * scartato e contato; il task di invio segnala periodicamente gli scarti.
+ *
+ * Anche la seriale ha una coppia di code propria: i messaggi vengono accodati senza
+ * attendere la trasmissione (circa 5 ms per 60 caratteri a 115200 baud). Il task della
+ * seriale copia le righe nel buffer di trasmissione della UART solo per lo spazio libero,
+ * quindi non si blocca mai sulla linea. Chi deve scrivere direttamente sulla UART (il dump del
+ * blackbox) la prende con `acquireSerial`: il task della seriale la cede solo tra una riga e
+ * l'altra e sospende i log finché non viene rilasciata. Lo stesso task legge i comandi (`SerialCommands`),
+ * in ogni stato del controller; il Logger registra `telemetry <canale|all> <divisore>`, che
+ * imposta il divisore dei canali (0 = disabilitato).
+ *
+ * Le code verso il server devono coprire le interruzioni del WiFi: la loro memoria viene
+ * allocata una volta da un budget (`allocateBuffers`), in PSRAM se la scheda la monta, e il
+ * task di invio ne segnala il massimo riempimento.
+ *
+ * La formattazione è differita: `logEvent` scrive nelle code solo identificativo, istante e
+ * argomenti grezzi di un messaggio della tabella, `log` il testo libero. Il testo completo
+ * viene composto dal task della seriale e, per lo stream UDP, dal server.
  */
 class Logger
 {
 private:
     Logger(); ///< Costruttore privato per garantire il Singleton.
 
-    std::mutex mutex;                  ///< Mutex per la sincronizzazione.
-    std::deque<std::string> logBuffer; ///< Buffer circolare per i log.
-    size_t maxBufferSize = 100;        ///< Dimensione massima del buffer dei log.
+    SPSCRing<LogMessage> controlLogQueue;    ///< Log prodotti dal task di controllo, verso il server.
+    SPSCRing<LogMessage> backgroundLogQueue; ///< Log prodotti dagli altri task, verso il server.
+    std::mutex backgroundMutex;              ///< Serializza i produttori della coda di background.
+    TaskHandle_t controlTask = nullptr;      ///< Task del ciclo di controllo.
+    void *bufferMemory = nullptr;            ///< Budget delle code verso il server, allocato una volta.
+    size_t bufferBudget = 0;                 ///< Byte del budget allocato.
+    bool bufferInPsram = false;              ///< Il budget è in PSRAM.
+
+    SPSCQueue<LogMessage, LOG_QUEUE_SIZE> controlSerialQueue;    ///< Log del task di controllo verso la seriale.
+    SPSCQueue<LogMessage, LOG_QUEUE_SIZE> backgroundSerialQueue; ///< Log degli altri task verso la seriale.
+    char serialLine[LOG_LINE_SIZE + 2];                          ///< Riga in scrittura sulla seriale, "\r\n" incluso.
+    size_t serialLineLength = 0;                                 ///< Lunghezza della riga in scrittura.
+    size_t serialLineWritten = 0;                                ///< Byte della riga già passati alla UART.
+    uint32_t reportedSerialDrops = 0;                            ///< Messaggi per la seriale scartati già segnalati.
+    std::mutex serialMutex;                                      ///< Accesso esclusivo alla UART (task della seriale o dump).
+
+    TelemetryQueue dataBuffer;             ///< Coda preallocata dei record di telemetria.
+    TelemetryChannels channels;            ///< Canali della telemetria, registrati al setup.
+#if TELEMETRY_TRANSPORT == TELEMETRY_TRANSPORT_UDP
+    TelemetryStream stream;                ///< Stream UDP verso il server, usato solo dal task di invio.
+#if TELEMETRY_ENCODING == TELEMETRY_ENCODING_DELTA
+    TelemetryEncoder encoder;                                ///< Codifica delle righe nei datagrammi (solo task di invio).
+    uint16_t framesSinceSchema = TELEMETRY_SCHEMA_INTERVAL; ///< Datagrammi di dati dall'ultimo invio dello schema.
+#endif
+#else
+    char dataBatch[TELEMETRY_BATCH_BYTES]; ///< Corpo della richiesta di upload, usato solo dal task di invio.
+#endif
+    TelemetryUploadStats uploadStats = {}; ///< Statistiche dell'upload (solo task di invio).
+    uint32_t statsWindowStart = 0;         ///< Inizio dell'intervallo di calcolo del throughput (ms).
+    uint32_t statsWindowRows = 0;          ///< Righe inviate nell'intervallo corrente.
+    uint32_t statsWindowBytes = 0;         ///< Byte inviati nell'intervallo corrente.
+    uint32_t currentCycle = 0;             ///< Contatore del ciclo corrente (solo task di controllo).
+    char startTimestamp[20] = {0};         ///< Timestamp di inizio raccolta dati.
+    TelemetryRecord lastRecord = {};       ///< Ultimo record registrato (solo task di controllo).
 
-    std::deque<std::vector<std::string>> dataBuffer; ///< Buffer per i dati numerici.
-    size_t maxDataBufferSize = 2000;                  ///< Dimensione massima del buffer dei dati.
-    std::vector<std::string> tempDataRow;            ///< Riga temporanea per i dati del ciclo corrente.
-    size_t currentCycle = 0;                         ///< Contatore del ciclo corrente.
-    std::string startTimestamp;                      ///< Timestamp di inizio raccolta dati.
+    bool headerInitialized = false; ///< Indica se l'header è stato inviato.
 
-    bool headerInitialized = false; ///< Indica se l'header è stato inizializzato
+    uint32_t reportedLogDrops = 0;      ///< Messaggi scartati già segnalati.
+    uint32_t reportedDataDrops = 0;     ///< Record scartati già segnalati.
+    uint32_t reportedDataHighWater = 0; ///< Massimo riempimento della coda dei record già segnalato.
+    uint32_t reportedLogHighWater = 0;  ///< Massimo riempimento delle code di log già segnalato.
 
     static void logTask(void *param); ///< Task FreeRTOS per l'invio asincrono dei log.
 
+    static void serialLogTask(void *param); ///< Task FreeRTOS per la scrittura dei log e la lettura dei comandi sulla seriale.
+
+    static bool telemetryCommand(void *context, const char *arguments); ///< Gestore di `telemetry` (task della seriale).
+
+    void configureTelemetry(const char *arguments); ///< Imposta il divisore dei canali della telemetria.
+
+    bool nextSerialLine(); ///< Prepara la prossima riga per la seriale (solo task della seriale).
+
+    void writeSerialLogs(); ///< Passa alla UART le righe in coda finché c'è spazio (solo task della seriale).
+
+    void reportDrops(); ///< Segnala i nuovi scarti delle code (solo task di invio).
+
+    void reportUploadStats(); ///< Aggiorna e segnala il throughput dell'upload (solo task di invio).
+
+    void reportHighWater(); ///< Segnala i nuovi massimi di riempimento delle code (solo task di invio).
+
+    void sendLogsToServer(); ///< Invia i messaggi di log in coda (solo task di invio).
+
+    void pushEvent(LOG_ID id, const uint32_t *args, uint8_t argc); ///< Accoda un messaggio della tabella.
+
 public:
     static Logger &getInstance(); ///< Ottiene l'istanza Singleton.
 
-    void startLogTask(); ///< Avvia il task di invio asincrono dei log.
+    /**
+     * @brief Alloca la memoria delle code di telemetria e di log verso il server (una sola volta).
+     *
+     * Il budget `LOG_BUDGET_PSRAM` va in PSRAM se presente, altrimenti `LOG_BUDGET_INTERNAL` in
+     * RAM interna. Ogni coda di log riceve 1/`LOG_BUDGET_LOG_DIVISOR` del budget, la coda dei
+     * record il resto, arrotondando le capacità alla potenza di 2 inferiore. Va chiamata nel
+     * setup, dopo l'inizializzazione della PSRAM e prima dei task: fino ad allora le code verso
+     * il server hanno capacità 0 e i messaggi arrivano solo alla seriale.
+     */
+    void allocateBuffers();
+
+    void startLogTask(); ///< Registra il comando `telemetry` e avvia i task di invio asincrono dei log e della seriale.
+
+    void registerControlTask(); ///< Registra il task chiamante come task del ciclo di controllo.
+
+    void log(LogLevel level, const std::string &message, bool sendToServer = true); ///< Registra un messaggio di log in testo libero.
+
+    /**
+     * @brief Registra un messaggio della tabella (`LogMessages.h`) con i suoi argomenti grezzi.
+     *
+     * Numero e tipo degli argomenti vengono verificati in compilazione contro il formato. Il
+     * costo è la scrittura di identificativo, istante e argomenti negli slot delle code.
+     *
+     * @tparam Id Messaggio della tabella.
+     * @param args Argomenti del formato: interi o enum per `%d`/`%i`/`%u`/`%x`, reali per `%f`.
+     */
+    template <LOG_ID Id, typename... Args>
+    void logEvent(Args... args)
+    {
+        constexpr const char *format = logMessageTable[static_cast<size_t>(Id)].format;
+        static_assert(Id != LOG_ID::TEXT && Id < LOG_ID::COUNT, "Messaggio non presente nella tabella");
+        static_assert(sizeof...(Args) == log_argument_count(format), "Numero di argomenti diverso dal formato");
+        static_assert(log_arguments_match<Args...>(format, std::index_sequence_for<Args...>{}),
+                      "Argomenti non compatibili con il formato");
+
+        const uint32_t words[sizeof...(Args) + 1] = {log_argument(args)...};
+        pushEvent(Id, words, sizeof...(Args));
+    }
+
+    /**
+     * @brief Registra un messaggio della tabella senza argomenti, scelto a runtime.
+     *
+     * @param id Messaggio della tabella; il formato non deve avere argomenti.
+     */
+    void logEvent(LOG_ID id) { pushEvent(id, nullptr, 0); }
+
+    /**
+     * @brief Formatta un messaggio di log con timestamp e livello, senza allocazioni.
+     *
+     * @param message Messaggio in testo libero o della tabella.
+     * @param buffer Buffer di destinazione.
+     * @param size Dimensione del buffer; la riga viene troncata se necessario.
+     * @return size_t Caratteri scritti, terminatore escluso.
+     */
+    size_t formatLog(const LogMessage &message, char *buffer, size_t size) const;
+
+    void sendLogToServer(const char *log); ///< Invia un log al server remoto.
+
+    void incrementCycle(); ///< Incrementa il contatore del ciclo (solo task di controllo).
 
-    void log(LogLevel level, const std::string &message, bool sendToServer = true); ///< Registra un messaggio di log.
+    void logData(const TelemetryRecord &record); ///< Accoda il record del ciclo corrente (solo task di controllo).
 
-    std::string formatLog(LogLevel level, const std::string &message) const; ///< Formatta un messaggio di log.
+    void sendDataToServer(); ///< Invia i dati in coda entro il budget di byte e di tempo, in datagrammi o in un'unica richiesta (solo task di invio).
 
-    void sendLogToServer(const std::string &log); ///< Invia un log al server remoto.
+    TelemetryChannels &getChannels() { return channels; } ///< Registro dei canali della telemetria.
 
-    void incrementCycle(); ///< Incrementa il contatore del ciclo e prepara la riga dati.
+    const TelemetryUploadStats &getUploadStats() const { return uploadStats; } ///< Statistiche dell'upload della telemetria.
 
-    void logData(const std::string &varName, double value, int decimalPlaces = 3); ///< Registra un dato numerico.
+    LoggerMemoryStats getMemoryStats() const; ///< Memoria, massimo riempimento e scarti delle code verso il server.
 
-    void prepareDataBuffer(); ///< Organizza i dati raccolti nel buffer principale.
+    /**
+     * @brief Prende la seriale per una scrittura diretta, sospendendo i log.
+     *
+     * Attende che il task della seriale completi la riga in corso; i messaggi accodati nel
+     * frattempo vengono scritti dopo `releaseSerial`. Da non usare nel ciclo di controllo.
+     */
+    void acquireSerial();
 
-    void sendDataToServer(); ///< Invia i dati raccolti al server remoto.
+    void releaseSerial(); ///< Restituisce la seriale al task dei log.
 
-    void printCurrentCycleData() const; ///< Stampa i dati del ciclo corrente sulla seriale.
+    void printCurrentCycleData() const; ///< Stampa l'ultimo record registrato sulla seriale.
 
     ~Logger() = default; ///< Distruttore di default.
 };
@@ -0,0 +1,114 @@
+/**
+ * @file Mixer.h
+ * @brief Dichiarazione della classe Mixer per la miscelazione degli output verso gli attuatori.
+ */
+#ifndef MIXER_H
+#define MIXER_H
+
+#include "DataStructures.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define MIXER_INPUTS 4  ///< Ingressi del mixer: x, y, z, throttle.
+#define MIXER_OUTPUTS 4 ///< Uscite del mixer: canali X, Y, Z ed ESC.
+#define MIXER_MAX_WEIGHT 2.0f ///< Peso massimo (in modulo) di un ingresso, per evitare overflow.
+
+/**
+ * @struct MixerRule
+ * @brief Configurazione di un'uscita del mixer.
+ *
+ * I pesi sono normalizzati: 1.0 porta l'uscita a fondo corsa quando l'ingresso è a fondo corsa.
+ */
+struct MixerRule
+{
+    float weight[MIXER_INPUTS]; ///< Pesi degli ingressi x, y, z, throttle.
+    int pwm_min;                ///< Fine corsa minimo (µs).
+    int pwm_neutral;            ///< Posizione neutra (µs); per i motori coincide con il minimo.
+    int pwm_max;                ///< Fine corsa massimo (µs).
+    int trim;                   ///< Trim (µs) sommato alla posizione neutra.
+    bool reversed;              ///< Inverte il verso dell'uscita.
+};
+
+/**
+ * @brief Classe per la miscelazione degli output del controller verso gli attuatori.
+ *
+ * Implementa una matrice uscite × ingressi con trim, fine corsa e inversione per ogni uscita.
+ * I fattori di scala vengono precalcolati in virgola fissa alla configurazione, così ogni
+ * ciclo richiede solo prodotti e somme intere e un clamp per uscita, senza divisioni.
+ */
+class Mixer
+{
+private:
+    MixerRule rules[MIXER_OUTPUTS]; ///< Configurazione delle uscite.
+
+    int32_t coefficient[MIXER_OUTPUTS][MIXER_INPUTS]; ///< Coefficienti (µs per unità di ingresso, Q8).
+    int32_t bias[MIXER_OUTPUTS];                      ///< Termine costante (µs, Q16).
+
+    float input_min[MIXER_INPUTS]; ///< Limite inferiore degli ingressi.
+    float input_max[MIXER_INPUTS]; ///< Limite superiore degli ingressi.
+
+    /**
+     * @brief Ricalcola coefficienti e termine costante di un'uscita.
+     *
+     * @param index Indice dell'uscita.
+     */
+    void precompute(size_t index);
+
+public:
+    /**
+     * @brief Costruttore della classe Mixer.
+     *
+     * @param layout Configurazione iniziale del mixer.
+     */
+    explicit Mixer(MIXER_LAYOUT layout);
+
+    /**
+     * @brief Carica una delle configurazioni predefinite.
+     *
+     * @param layout Configurazione del mixer.
+     */
+    void set_layout(MIXER_LAYOUT layout);
+
+    /**
+     * @brief Imposta la configurazione di un'uscita.
+     *
+     * @param index Indice dell'uscita.
+     * @param rule Configurazione dell'uscita.
+     */
+    void set_rule(size_t index, const MixerRule &rule);
+
+    /**
+     * @brief Imposta il trim di un'uscita.
+     *
+     * @param index Indice dell'uscita.
+     * @param trim Trim (µs).
+     */
+    void set_trim(size_t index, int trim);
+
+    /**
+     * @brief Imposta i fine corsa di un'uscita.
+     *
+     * @param index Indice dell'uscita.
+     * @param pwm_min Fine corsa minimo (µs).
+     * @param pwm_max Fine corsa massimo (µs).
+     */
+    void set_endpoints(size_t index, int pwm_min, int pwm_max);
+
+    /**
+     * @brief Imposta l'inversione di un'uscita.
+     *
+     * @param index Indice dell'uscita.
+     * @param reversed Inverte il verso dell'uscita.
+     */
+    void set_reversed(size_t index, bool reversed);
+
+    /**
+     * @brief Calcola gli impulsi delle uscite.
+     *
+     * @param output Output del controller.
+     * @param pwm Impulsi risultanti (µs), uno per uscita.
+     */
+    void mix(const Output &output, int pwm[MIXER_OUTPUTS]) const;
+};
+
+#endif // MIXER_H
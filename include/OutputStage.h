@@ -0,0 +1,69 @@
+/**
+ * @file OutputStage.h
+ * @brief Dichiarazione della classe OutputStage per l'aggiornamento sincronizzato degli attuatori.
+ */
+#ifndef OUTPUT_STAGE_H
+#define OUTPUT_STAGE_H
+
+#include "Actuator.h"
+#include "Mixer.h"
+#include <freertos/FreeRTOS.h>
+
+/**
+ * @struct OutputStageStats
+ * @brief Contatori delle scritture sugli attuatori.
+ */
+struct OutputStageStats
+{
+    uint32_t commits;        ///< Commit eseguiti.
+    uint32_t writes_issued;  ///< Scritture effettuate sui registri.
+    uint32_t writes_skipped; ///< Scritture evitate perché il valore non era cambiato.
+};
+
+/**
+ * @brief Classe per l'aggiornamento sincronizzato e selettivo degli attuatori.
+ *
+ * I valori di tutti i canali vengono prima preparati e convertiti, poi caricati insieme con
+ * sole scritture di registro in una breve sezione critica: i canali LEDC che condividono un
+ * timer applicano così i nuovi valori allo stesso inizio di periodo. Canali su timer diversi
+ * (ESC e servo) non hanno un confine di periodo comune e cambiano ciascuno al proprio. I canali
+ * il cui valore non è cambiato non vengono riscritti.
+ */
+class OutputStage
+{
+private:
+    Actuator *actuators[MIXER_OUTPUTS]; ///< Attuatori, nell'ordine delle uscite del mixer.
+    bool pending[MIXER_OUTPUTS];        ///< Canali con un valore da scrivere.
+    OutputStageStats stats;             ///< Contatori delle scritture.
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED; ///< Spinlock della sezione critica.
+
+public:
+    /**
+     * @brief Costruttore della classe OutputStage.
+     *
+     * @param servo_x Attuatore dell'uscita 0 (canale X).
+     * @param servo_y Attuatore dell'uscita 1 (canale Y).
+     * @param servo_z Attuatore dell'uscita 2 (canale Z).
+     * @param esc Attuatore dell'uscita 3 (ESC).
+     */
+    OutputStage(Actuator &servo_x, Actuator &servo_y, Actuator &servo_z, Actuator &esc);
+
+    /**
+     * @brief Prepara i valori di tutti i canali.
+     *
+     * @param pwm Impulsi (µs), uno per uscita.
+     */
+    void stage(const int pwm[MIXER_OUTPUTS]);
+
+    /**
+     * @brief Applica insieme tutti i valori cambiati.
+     */
+    void commit();
+
+    /**
+     * @brief Restituisce i contatori delle scritture.
+     */
+    const OutputStageStats &get_stats() const { return stats; }
+};
+
+#endif // OUTPUT_STAGE_H
@@ -1,99 +1,234 @@
 /**
  * @file Quaternions.h
- * @brief Dichiarazione delle funzioni per la manipolazione dei quaternioni.
- * 
+ * @brief Funzioni inline per la manipolazione di quaternioni e vettori.
+ *
  * Questo file include le funzioni necessarie per il calcolo e la gestione dei quaternioni,
- * inclusi la moltiplicazione, la normalizzazione e il calcolo degli errori.
+ * inclusi la moltiplicazione, la normalizzazione e il calcolo degli errori. Tutte le funzioni
+ * sono inline (constexpr dove possibile) e il file può essere incluso da più unità di compilazione.
  */
 
 #ifndef QUATERNIONS_H
 #define QUATERNIONS_H
 
 #include "DataStructures.h"
-#include <cmath>
+#include "FastMath.h"
+#include <math.h>
+#include <stddef.h>
 
 /**
- * @brief Array statico di assi standard per i calcoli dei quaternioni.
+ * @brief Array di assi standard per i calcoli dei quaternioni.
  */
-static float axis[3][3] = {
+inline constexpr float axis[3][3] = {
     {1, 0, 0}, // Asse X (ROLL)
     {0, 1, 0}, // Asse Y (PITCH)
     {0, 0, 1}  // Asse Z (YAW)
 };
 
+/**
+ * @brief Fattore di conversione da gradi a radianti, in singola precisione.
+ */
+inline constexpr float DEG_TO_RAD_F = 3.14159265358979f / 180.0f;
+
+/** @defgroup Vector_Ops Operazioni sui vettori
+ *  @{
+ */
+
+/**
+ * @brief Prodotto scalare di due vettori.
+ */
+constexpr float vector_dot(const Euler &a, const Euler &b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/**
+ * @brief Prodotto vettoriale di due vettori.
+ */
+constexpr Euler vector_cross(const Euler &a, const Euler &b)
+{
+    return {a.y * b.z - a.z * b.y,
+            a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x};
+}
+
+/**
+ * @brief Moltiplica un vettore per uno scalare.
+ */
+constexpr Euler vector_scale(const Euler &v, float k)
+{
+    return {v.x * k, v.y * k, v.z * k};
+}
+
+/**
+ * @brief Somma due vettori.
+ */
+constexpr Euler vector_add(const Euler &a, const Euler &b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+/** @} */
+
+/** @defgroup Quaternion_Ops Operazioni sui quaternioni
+ *  @{
+ */
+
+/**
+ * @brief Restituisce il coniugato di un quaternione.
+ */
+constexpr Quaternion quaternion_conjugate(const Quaternion &q)
+{
+    return {q.w, -q.x, -q.y, -q.z};
+}
+
 /**
  * @brief Calcola il coniugato di un quaternione.
  */
-void quaternion_conjugate(const Quaternion &q, Quaternion &q_conj)
+inline void quaternion_conjugate(const Quaternion &q, Quaternion &q_conj)
 {
-    q_conj.w = q.w;
-    q_conj.x = -q.x;
-    q_conj.y = -q.y;
-    q_conj.z = -q.z;
+    q_conj = quaternion_conjugate(q);
+}
+
+/**
+ * @brief Restituisce il prodotto di due quaternioni.
+ */
+constexpr Quaternion quaternion_multiply(const Quaternion &q1, const Quaternion &q2)
+{
+    return {q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z,
+            q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+            q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+            q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w};
 }
 
 /**
  * @brief Moltiplica due quaternioni.
  */
-void quaternion_multiply(const Quaternion &q1, const Quaternion &q2, Quaternion &q_result)
+inline void quaternion_multiply(const Quaternion &q1, const Quaternion &q2, Quaternion &q_result)
 {
-    q_result.w = q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z;
-    q_result.x = q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y;
-    q_result.y = q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x;
-    q_result.z = q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w;
+    q_result = quaternion_multiply(q1, q2);
+}
+
+/**
+ * @brief Ruota un vettore con un quaternione unitario (v' = q v q*).
+ *
+ * Usa la forma v' = v + 2w(u × v) + 2u × (u × v), con u parte vettoriale di q.
+ */
+constexpr Euler quaternion_rotate(const Quaternion &q, const Euler &v)
+{
+    const Euler u = {q.x, q.y, q.z};
+    const Euler t = vector_scale(vector_cross(u, v), 2.0f);
+    return vector_add(vector_add(v, vector_scale(t, q.w)), vector_cross(u, t));
 }
 
 /**
  * @brief Converte un asse e un angolo in un quaternione.
  */
-void quaternion_from_axis_angle(const float axis[3], float angle_deg, Quaternion &q)
+inline void quaternion_from_axis_angle(const float axis[3], float angle_deg, Quaternion &q)
 {
-    float angle_rad = angle_deg * M_PI / 180.0f;
-    float sin_half_angle = sin(angle_rad / 2);
-    q.w = cos(angle_rad / 2);
-    q.x = axis[0] * sin_half_angle;
-    q.y = axis[1] * sin_half_angle;
-    q.z = axis[2] * sin_half_angle;
+    float s, c;
+    fast_sincos(0.5f * DEG_TO_RAD_F * angle_deg, s, c);
+    q.w = c;
+    q.x = axis[0] * s;
+    q.y = axis[1] * s;
+    q.z = axis[2] * s;
+}
+
+/**
+ * @brief Converte angoli di rollio, beccheggio e imbardata in un quaternione.
+ *
+ * Forma chiusa di q = q_x(roll) ⊗ q_y(pitch) ⊗ q_z(yaw), equivalente alla composizione dei
+ * tre quaternioni asse-angolo ma con tre `fast_sincos` e 16 prodotti invece di sei chiamate
+ * trigonometriche e due moltiplicazioni complete. Il risultato è unitario per costruzione.
+ *
+ * @param roll_deg Rollio (gradi).
+ * @param pitch_deg Beccheggio (gradi).
+ * @param yaw_deg Imbardata (gradi).
+ * @param q Quaternione risultante.
+ */
+inline void quaternion_from_euler(float roll_deg, float pitch_deg, float yaw_deg, Quaternion &q)
+{
+    const float k = 0.5f * DEG_TO_RAD_F;
+    float sr, cr, sp, cp, sy, cy;
+    fast_sincos(roll_deg * k, sr, cr);
+    fast_sincos(pitch_deg * k, sp, cp);
+    fast_sincos(yaw_deg * k, sy, cy);
+
+    const float cr_cp = cr * cp, sr_sp = sr * sp;
+    const float sr_cp = sr * cp, cr_sp = cr * sp;
+    q.w = cr_cp * cy - sr_sp * sy;
+    q.x = sr_cp * cy + cr_sp * sy;
+    q.y = cr_sp * cy - sr_cp * sy;
+    q.z = cr_cp * sy + sr_sp * cy;
 }
 
 /**
  * @brief Normalizza un quaternione per renderlo unitario.
+ *
+ * Il fattore di scala è calcolato con `fast_rsqrt` (senza radici né divisioni con `FAST_MATH`);
+ * le componenti vengono poi scalate con moltiplicazioni.
  */
-void quaternion_normalize(Quaternion &q)
+inline void quaternion_normalize(Quaternion &q)
 {
-    float magnitude = sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    const float norm2 = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
 
-    if (magnitude > 0.0f)
+    if (norm2 > 0.0f)
     {
-        q.w /= magnitude;
-        q.x /= magnitude;
-        q.y /= magnitude;
-        q.z /= magnitude;
+        const float inv = fast_rsqrt(norm2);
+        q.w *= inv;
+        q.x *= inv;
+        q.y *= inv;
+        q.z *= inv;
     }
 }
 
 /**
  * @brief Compone una serie di quaternioni in un unico quaternione risultante.
  */
-void quaternion_compose(const Quaternion *quaternions, size_t count, Quaternion &result)
+inline void quaternion_compose(const Quaternion *quaternions, size_t count, Quaternion &result)
 {
     result = {1, 0, 0, 0}; // Quaternione unitario
     for (size_t i = 0; i < count; ++i)
-    {
-        Quaternion temp;
-        quaternion_multiply(result, quaternions[i], temp);
-        result = temp;
-    }
+        result = quaternion_multiply(result, quaternions[i]);
 }
 
 /**
  * @brief Calcola l'errore tra un quaternione desiderato e quello attuale.
+ *
+ * q e -q rappresentano la stessa rotazione: con w < 0 l'errore viene negato, così la parte
+ * vettoriale indica sempre la rotazione più breve (angolo ≤ 180°).
  */
-void quaternion_error(const Quaternion &desired, const Quaternion &actual, Quaternion &error)
+inline void quaternion_error(const Quaternion &desired, const Quaternion &actual, Quaternion &error)
 {
-    Quaternion conjugate;
-    quaternion_conjugate(actual, conjugate);
-    quaternion_multiply(desired, conjugate, error);
+    error = quaternion_multiply(desired, quaternion_conjugate(actual));
+    if (error.w < 0.0f)
+        error = {-error.w, -error.x, -error.y, -error.z};
 }
 
-#endif // QUATERNIONS_H
\ No newline at end of file
+/**
+ * @brief Calcola la derivata dell'errore di `quaternion_error` dovuta alle sole velocità angolari.
+ *
+ * Con q̇ = ½ q ⊗ (0, ω), ω nel riferimento del corpo, e attitudine desiderata costante,
+ * l'errore q_e = q_d ⊗ q* varia come q̇_e = -½ q_d ⊗ (0, ω) ⊗ q*. Il segno segue quello scelto
+ * da `quaternion_error`. A differenza della differenza finita della parte vettoriale di q,
+ * vale anche lontano dall'identità e non risente dei gradini dell'attitudine desiderata.
+ *
+ * @param desired Attitudine desiderata.
+ * @param actual Attitudine attuale.
+ * @param gyro Velocità angolari nel riferimento del corpo (gradi/s).
+ * @param rate Derivata del quaternione di errore (1/s).
+ */
+inline void quaternion_error_rate(const Quaternion &desired, const Quaternion &actual, const Euler &gyro, Quaternion &rate)
+{
+    const float k = -0.5f * DEG_TO_RAD_F;
+    const Quaternion omega = {0.0f, gyro.x * k, gyro.y * k, gyro.z * k};
+    rate = quaternion_multiply(quaternion_multiply(desired, omega), quaternion_conjugate(actual));
+
+    // (q_d ⊗ q*).w è il prodotto scalare tra q_d e q: stesso emisfero dell'errore
+    const float w = desired.w * actual.w + desired.x * actual.x + desired.y * actual.y + desired.z * actual.z;
+    if (w < 0.0f)
+        rate = {-rate.w, -rate.x, -rate.y, -rate.z};
+}
+
+/** @} */
+
+#endif // QUATERNIONS_H
@@ -8,6 +8,7 @@
 #include <Arduino.h>
 #include "HardwareParameters.h"
 #include "DataStructures.h"
+#include "IBusParser.h"
 
 /**
  * @brief Struttura dati per i dati ricevuti dal ricevitore.
@@ -38,26 +39,16 @@ struct ReceiverDataRAW
 class Receiver
 {
 private:
-    static const int PACKET_SIZE = 32;    ///< Dimensione massima del pacchetto IBUS.
-    static const uint8_t HEADER_1 = 0x20; ///< Primo byte dell'header del pacchetto IBUS.
-    static const uint8_t HEADER_2 = 0x40; ///< Secondo byte dell'header del pacchetto IBUS.
-
-    int rxPin;                   ///< Pin di ricezione del segnale IBUS.
-    uint8_t buffer[PACKET_SIZE]; ///< Buffer per la memorizzazione del pacchetto IBUS.
-    size_t bufferIndex;          ///< Indice corrente del buffer.
-
     /**
-     * @brief Verifica e decodifica un pacchetto IBUS dal buffer.
+     * @brief Numero massimo di byte elaborati in una chiamata a `read`.
      *
-     * @return true Se il pacchetto è valido.
-     * @return false Se il pacchetto è invalido.
+     * Limita il tempo speso nel parser anche con un flusso continuo di byte non validi:
+     * i byte eccedenti restano nel buffer della UART per il ciclo successivo.
      */
-    bool decodeIBusPacket();
+    static const size_t MAX_BYTES_PER_READ = 3 * IBusParser::PACKET_SIZE;
 
-    /**
-     * @brief Resetta il buffer del ricevitore.
-     */
-    void resetBuffer();
+    int rxPin;         ///< Pin di ricezione del segnale IBUS.
+    IBusParser parser; ///< Parser del flusso IBUS.
 
 public:
     /**
@@ -79,11 +70,9 @@ public:
     bool read(ReceiverData &data);
 
     /**
-     * @brief Logga i dati ricevuti dal ricevitore.
-     *
-     * @param data Dati ricevuti dal ricevitore.
+     * @brief Restituisce le statistiche del parser.
      */
-    void logData(const ReceiverData &data);
+    const ReceiverStats &getStats() const { return parser.getStats(); }
 };
 
 #endif // RECEIVER_H
@@ -0,0 +1,111 @@
+/**
+ * @file RelayAutotune.h
+ * @brief Dichiarazione della classe RelayAutotune per l'autotuning dei PID con esperimento a relè.
+ */
+#ifndef RELAY_AUTOTUNE_H
+#define RELAY_AUTOTUNE_H
+
+/**
+ * @brief Stati dell'esperimento di autotuning.
+ */
+enum class AUTOTUNE_STATE
+{
+    IDLE,    ///< Nessun esperimento in corso.
+    RUNNING, ///< Oscillazione a relè in corso.
+    DONE,    ///< Identificazione completata, risultati disponibili.
+    FAILED   ///< Oscillazione non stabilizzata entro il tempo massimo.
+};
+
+/**
+ * @struct AutotuneResult
+ * @brief Risultati dell'identificazione e guadagni suggeriti.
+ */
+struct AutotuneResult
+{
+    float ku; ///< Guadagno ultimo stimato.
+    float tu; ///< Periodo ultimo stimato (s).
+    float kp; ///< Guadagno proporzionale suggerito.
+    float ki; ///< Guadagno integrale suggerito.
+    float kd; ///< Guadagno derivativo suggerito.
+};
+
+/**
+ * @brief Autotuning a relè (metodo di Åström–Hägglund).
+ *
+ * Il relè con isteresi porta l'anello in un ciclo limite. Dall'ampiezza `a` dell'oscillazione
+ * e dall'ampiezza `d` del relè si stima il guadagno ultimo con l'approssimazione della funzione
+ * descrittiva, `Ku = 4d / (π·sqrt(a² - ε²))`, e dal periodo delle commutazioni il periodo ultimo
+ * `Tu`. I guadagni suggeriti seguono la regola di Ziegler–Nichols (Kp = 0.6·Ku, Ti = Tu/2, Td = Tu/8)
+ * espressi nella forma usata dai PID del controller (ki = Kp/Ti, kd = Kp·Td).
+ *
+ * La classe non dipende dall'hardware: l'identificazione può essere verificata su host.
+ */
+class RelayAutotune
+{
+private:
+    float amplitude;  ///< Ampiezza del relè (d).
+    float hysteresis; ///< Isteresi sull'errore (ε).
+    int cycles;       ///< Periodi da mediare dopo il transitorio.
+    float timeout;    ///< Durata massima dell'esperimento (s).
+
+    AUTOTUNE_STATE state; ///< Stato dell'esperimento.
+    float output;         ///< Uscita corrente del relè.
+    float elapsed;        ///< Tempo trascorso dall'avvio (s).
+    float last_rise;      ///< Istante dell'ultima commutazione positiva (s), negativo se assente.
+    float peak_max;       ///< Massimo dell'errore nel periodo corrente.
+    float peak_min;       ///< Minimo dell'errore nel periodo corrente.
+    int periods;          ///< Periodi completati, transitorio incluso.
+    float sum_period;     ///< Somma dei periodi mediati.
+    float sum_amplitude;  ///< Somma delle ampiezze mediate.
+    AutotuneResult result; ///< Risultati dell'ultimo esperimento completato.
+
+    /**
+     * @brief Chiude un periodo dell'oscillazione e, se possibile, calcola i risultati.
+     */
+    void complete_period();
+
+public:
+    /**
+     * @brief Costruttore della classe RelayAutotune.
+     *
+     * @param amplitude Ampiezza del relè, nelle unità dell'uscita dell'anello.
+     * @param hysteresis Isteresi sull'errore, per evitare commutazioni dovute al rumore.
+     * @param cycles Numero di periodi da mediare.
+     * @param timeout Durata massima dell'esperimento (s).
+     */
+    RelayAutotune(float amplitude, float hysteresis, int cycles, float timeout);
+
+    /**
+     * @brief Avvia un nuovo esperimento.
+     *
+     * @param amplitude Ampiezza del relè.
+     * @param hysteresis Isteresi sull'errore.
+     */
+    void start(float amplitude, float hysteresis);
+
+    /**
+     * @brief Interrompe l'esperimento e torna allo stato IDLE.
+     */
+    void stop();
+
+    /**
+     * @brief Esegue un passo dell'esperimento.
+     *
+     * @param error Errore dell'anello sull'asse in identificazione (setpoint - misura).
+     * @param dt Intervallo di tempo dall'ultimo passo (s).
+     * @return float Uscita del relè da applicare all'anello (0 se l'esperimento non è in corso).
+     */
+    float update(float error, float dt);
+
+    /**
+     * @brief Restituisce lo stato dell'esperimento.
+     */
+    AUTOTUNE_STATE get_state() const { return state; }
+
+    /**
+     * @brief Restituisce i risultati dell'ultimo esperimento completato.
+     */
+    const AutotuneResult &get_result() const { return result; }
+};
+
+#endif // RELAY_AUTOTUNE_H
@@ -0,0 +1,223 @@
+/**
+ * @file SPSCQueue.h
+ * @brief Coda circolare lock-free a singolo produttore e singolo consumatore.
+ */
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Coda circolare lock-free a singolo produttore e singolo consumatore (SPSC), su memoria esterna.
+ *
+ * Il produttore scrive solo `head`, il consumatore solo `tail`: nessuno dei due prende lock né
+ * attende l'altro, quindi un task ad alta priorità non subisce inversioni di priorità. Gli
+ * indici crescono liberamente e vengono ridotti con una maschera (capacità potenza di 2).
+ *
+ * Politica di overflow: con la coda piena il nuovo elemento viene scartato e contato. Il
+ * produttore non può sovrascrivere il più vecchio, che appartiene al consumatore.
+ *
+ * La memoria degli elementi viene assegnata una volta con `attach`, anche a runtime (ad
+ * esempio in PSRAM); prima di `attach` la coda ha capacità 0 e scarta ogni elemento.
+ * `SPSCQueue` la riserva nell'oggetto stesso, con capacità fissata in compilazione.
+ *
+ * @tparam T Tipo degli elementi (banalmente copiabile se la memoria non è inizializzata).
+ */
+template <typename T>
+class SPSCRing
+{
+private:
+    T *slots = nullptr;                 ///< Elementi della coda.
+    size_t slotCount = 0;               ///< Capacità della coda.
+    std::atomic<size_t> head{0};        ///< Prossimo slot da scrivere (solo produttore).
+    std::atomic<size_t> tail{0};        ///< Prossimo slot da leggere (solo consumatore).
+    std::atomic<uint32_t> dropped{0};   ///< Elementi scartati per coda piena.
+    std::atomic<uint32_t> highWater{0}; ///< Massimo numero di elementi in coda.
+
+    // Aggiorna il massimo riempimento dopo l'inserimento di un elemento (solo produttore)
+    void updateHighWater(size_t used)
+    {
+        if (used > highWater.load(std::memory_order_relaxed))
+            highWater.store(static_cast<uint32_t>(used), std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * @brief Assegna la memoria degli elementi e svuota la coda, azzerando le statistiche.
+     *
+     * Da chiamare prima dell'uso o comunque senza produttori né consumatori attivi.
+     *
+     * @param memory Memoria per `capacity` elementi, valida per tutta la vita della coda.
+     * @param capacity Capacità, potenza di 2 (0 = nessuna memoria).
+     * @return true Se la capacità è valida.
+     */
+    bool attach(T *memory, size_t capacity)
+    {
+        if (capacity != 0 && (capacity < 2 || (capacity & (capacity - 1)) != 0 || memory == nullptr))
+            return false;
+        slots = memory;
+        slotCount = capacity;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        highWater.store(0, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Inserisce un elemento (solo produttore).
+     *
+     * @param item Elemento da copiare.
+     * @return true Se l'elemento è stato inserito, false se la coda era piena.
+     */
+    bool push(const T &item)
+    {
+        T *slot = prepare();
+        if (slot == nullptr)
+            return false;
+        *slot = item;
+        commit();
+        return true;
+    }
+
+    /**
+     * @brief Restituisce lo slot libero successivo, da riempire sul posto (solo produttore).
+     *
+     * Evita la copia di un elemento grande quando ne servono solo alcuni campi. L'elemento
+     * diventa visibile al consumatore con `commit`. Con la coda piena l'elemento viene
+     * scartato e contato come in `push`.
+     *
+     * @return T* Slot da riempire; nullptr se la coda è piena (senza `commit`).
+     */
+    T *prepare()
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t used = h - tail.load(std::memory_order_acquire);
+        if (used == slotCount)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        updateHighWater(used + 1);
+        return &slots[h & (slotCount - 1)];
+    }
+
+    /**
+     * @brief Pubblica lo slot ottenuto da `prepare` (solo produttore).
+     */
+    void commit()
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Restituisce l'elemento più vecchio senza rimuoverlo (solo consumatore).
+     *
+     * @return const T* Elemento, valido fino a `pop`; nullptr se la coda è vuota.
+     */
+    const T *front() const
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return nullptr;
+        return &slots[t & (slotCount - 1)];
+    }
+
+    /**
+     * @brief Restituisce l'elemento in posizione `index` a partire dal più vecchio (solo consumatore).
+     *
+     * @param index Posizione (0 = più vecchio).
+     * @return const T* Elemento, valido fino a `pop`; nullptr se la coda ne contiene meno.
+     */
+    const T *peek(size_t index) const
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) - t <= index)
+            return nullptr;
+        return &slots[(t + index) & (slotCount - 1)];
+    }
+
+    /**
+     * @brief Rimuove l'elemento più vecchio (solo consumatore).
+     */
+    void pop()
+    {
+        pop(static_cast<size_t>(1));
+    }
+
+    /**
+     * @brief Rimuove i `count` elementi più vecchi, o tutti se la coda ne contiene meno (solo consumatore).
+     *
+     * @param count Elementi da rimuovere.
+     */
+    void pop(size_t count)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t available = head.load(std::memory_order_acquire) - t;
+        tail.store(t + (count < available ? count : available), std::memory_order_release);
+    }
+
+    /**
+     * @brief Estrae l'elemento più vecchio (solo consumatore).
+     *
+     * @param item Elemento di destinazione.
+     * @return true Se la coda conteneva almeno un elemento.
+     */
+    bool pop(T &item)
+    {
+        const T *oldest = front();
+        if (oldest == nullptr)
+            return false;
+        item = *oldest;
+        pop();
+        return true;
+    }
+
+    /**
+     * @brief Numero di elementi in coda (indicativo se letto durante un accesso concorrente).
+     */
+    size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Restituisce il numero di elementi scartati per coda piena.
+     */
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Restituisce il massimo numero di elementi in coda dall'ultimo `attach`.
+     */
+    uint32_t getHighWater() const { return highWater.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Capacità della coda.
+     */
+    size_t capacity() const { return slotCount; }
+};
+
+/**
+ * @brief Coda SPSC con la memoria degli elementi nell'oggetto (vedi `SPSCRing`).
+ *
+ * @tparam T Tipo degli elementi (copiabile).
+ * @tparam N Capacità, potenza di 2.
+ */
+template <typename T, size_t N>
+class SPSCQueue : public SPSCRing<T>
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "La capacità deve essere una potenza di 2");
+
+private:
+    T storage[N]; ///< Elementi della coda.
+
+public:
+    SPSCQueue() { this->attach(storage, N); } ///< Costruttore: coda vuota di capacità `N`.
+
+    SPSCQueue(const SPSCQueue &) = delete;            ///< Elimina il costruttore di copia.
+    SPSCQueue &operator=(const SPSCQueue &) = delete; ///< Elimina l'operatore di assegnazione.
+};
+
+#endif // SPSC_QUEUE_H
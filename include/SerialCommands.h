@@ -0,0 +1,76 @@
+/**
+ * @file SerialCommands.h
+ * @brief Dichiarazione della classe SerialCommands per la lettura dei comandi dalla seriale.
+ */
+#ifndef SERIAL_COMMANDS_H
+#define SERIAL_COMMANDS_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SERIAL_COMMAND_SIZE 48     ///< Lunghezza massima di una riga di comando (terminatore incluso).
+#define SERIAL_COMMAND_HANDLERS 4 ///< Gestori registrabili.
+
+/**
+ * @brief Gestore di un comando.
+ *
+ * @param context Puntatore passato alla registrazione.
+ * @param arguments Testo dopo il nome del comando e lo spazio (stringa vuota se assente).
+ * @return true Se il comando è stato riconosciuto, anche se rifiutato.
+ */
+typedef bool (*SerialCommandHandler)(void *context, const char *arguments);
+
+/**
+ * @brief Lettore dei comandi testuali dalla seriale.
+ *
+ * Ogni riga (`<nome> <argomenti>`, terminata da `\n` o `\r`) viene passata al gestore
+ * registrato con quel nome. I moduli registrano i gestori al setup, prima o dopo l'avvio del
+ * task della seriale; il gestore gira nel task della seriale e deve solo validare gli
+ * argomenti e passare il lavoro lungo al proprio task. Le righe troppo lunghe vengono scartate.
+ * Implementata come Singleton.
+ */
+class SerialCommands
+{
+private:
+    SerialCommands(); ///< Costruttore privato per garantire il Singleton.
+
+    /**
+     * @struct Entry
+     * @brief Gestore registrato.
+     */
+    struct Entry
+    {
+        const char *name;             ///< Nome del comando, stringa statica.
+        SerialCommandHandler handler; ///< Gestore.
+        void *context;                ///< Contesto del gestore.
+    };
+
+    Entry entries[SERIAL_COMMAND_HANDLERS]; ///< Gestori registrati, immutabili dopo `add`.
+    std::atomic<uint8_t> count{0};          ///< Gestori registrati (pubblicato dopo il gestore).
+    char line[SERIAL_COMMAND_SIZE];         ///< Riga in ricezione (solo task della seriale).
+    size_t length = 0;                      ///< Caratteri della riga ricevuti.
+    bool overflow = false;                  ///< La riga in ricezione è troppo lunga.
+
+    void dispatch(); ///< Esegue la riga ricevuta.
+
+public:
+    static SerialCommands &getInstance(); ///< Ottiene l'istanza Singleton.
+
+    SerialCommands(const SerialCommands &) = delete;            ///< Elimina il costruttore di copia.
+    SerialCommands &operator=(const SerialCommands &) = delete; ///< Elimina l'operatore di assegnazione.
+
+    /**
+     * @brief Registra il gestore di un comando (solo al setup, da un unico task).
+     *
+     * @param name Nome del comando, stringa statica senza spazi.
+     * @param handler Gestore del comando.
+     * @param context Puntatore passato al gestore.
+     * @return true Se il gestore è stato registrato.
+     */
+    bool add(const char *name, SerialCommandHandler handler, void *context);
+
+    void poll(); ///< Legge i caratteri disponibili ed esegue le righe complete (solo task della seriale).
+};
+
+#endif // SERIAL_COMMANDS_H
@@ -0,0 +1,293 @@
+/**
+ * @file Telemetry.h
+ * @brief Dichiarazione del record binario di telemetria e della relativa coda.
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "DataStructures.h"
+#include "SPSCQueue.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+#define TELEMETRY_TEXT_SIZE 768 ///< Dimensione del buffer per la conversione testuale di un record.
+
+#define TELEMETRY_BATCH_BYTES 8192       ///< Dimensione massima del corpo di una richiesta di upload.
+#define TELEMETRY_BATCH_TIME_US 20000    ///< Tempo massimo di preparazione di un batch (µs).
+#define TELEMETRY_STATS_INTERVAL_MS 5000 ///< Intervallo di calcolo e segnalazione del throughput.
+
+#define TELEMETRY_IMU_VALID 0x01      ///< I dati dell'IMU sono stati letti nel ciclo.
+#define TELEMETRY_RECEIVER_VALID 0x02 ///< I dati del ricevitore sono stati letti nel ciclo.
+#define TELEMETRY_RPM_VALID 0x04      ///< La telemetria dell'ESC è disponibile.
+
+/**
+ * @struct TelemetryRecord
+ * @brief Record di telemetria di un ciclo, a layout fisso.
+ *
+ * Contiene le strutture del ciclo così come sono in memoria: il record viene riempito per
+ * copia, senza conversioni né allocazioni. La conversione in testo avviene solo all'invio.
+ */
+struct TelemetryRecord
+{
+    uint32_t timestamp_us; ///< Istante di acquisizione (µs dall'avvio).
+    uint32_t cycle;        ///< Numero del ciclo.
+    ImuData imu;           ///< Dati letti dall'IMU.
+    ReceiverData receiver; ///< Dati ricevuti dal pilota.
+    Output output;         ///< Output del controller.
+    float rpm;             ///< Giri al minuto del motore.
+    uint32_t flags;        ///< Validità dei dati (`TELEMETRY_*_VALID`).
+};
+
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value,
+              "TelemetryRecord deve poter essere copiato con memcpy");
+static_assert(sizeof(TelemetryRecord) == 116,
+              "Il layout di TelemetryRecord è decodificato da server/telemetry_stream.py");
+
+/** @defgroup Telemetry_Stream Stream UDP della telemetria
+ *  Formato dei datagrammi: header `TelemetryFrameHeader` seguito dal payload. I dati sono
+ *  record `TelemetryRecord` binari (little-endian) consecutivi oppure righe codificate da
+ *  `TelemetryEncoder`, i log sono messaggi di testo terminati da '\0'. Il numero di sequenza
+ *  cresce di uno per datagramma, così la stazione di terra rileva le perdite.
+ *  Decodifica: `server/telemetry_stream.py`.
+ *  @{
+ */
+
+#define TELEMETRY_TRANSPORT_HTTP 0 ///< Una richiesta HTTP per batch JSON.
+#define TELEMETRY_TRANSPORT_UDP 1  ///< Datagrammi UDP binari su un unico socket.
+
+#define TELEMETRY_TRANSPORT TELEMETRY_TRANSPORT_UDP ///< Trasporto della telemetria verso il server.
+#define TELEMETRY_UDP_PORT 5005                     ///< Porta UDP di destinazione sul server.
+#define TELEMETRY_FRAME_BYTES 1400                  ///< Dimensione massima di un datagramma (sotto la MTU).
+#define TELEMETRY_FRAME_VERSION 2                   ///< Versione del formato dei datagrammi.
+
+#define TELEMETRY_ENCODING_RAW 0   ///< Record `TelemetryRecord` binari a layout fisso.
+#define TELEMETRY_ENCODING_DELTA 1 ///< Righe quantizzate in differenza dalla precedente, come varint zig-zag.
+
+#define TELEMETRY_ENCODING TELEMETRY_ENCODING_DELTA ///< Codifica dei dati nei datagrammi UDP.
+#define TELEMETRY_SCHEMA_INTERVAL 16                ///< Datagrammi di dati tra due invii dello schema.
+
+/**
+ * @brief Tipo di payload di un datagramma.
+ */
+enum class TELEMETRY_FRAME : uint8_t
+{
+    DATA = 1,   ///< Record di telemetria binari.
+    LOG = 2,    ///< Messaggi di log testuali.
+    SCHEMA = 3, ///< Schema dei canali delle righe codificate.
+    DELTA = 4,  ///< Generazione dello schema (u16) e righe codificate da `TelemetryEncoder`.
+    EVENT = 5   ///< Messaggi di log della tabella (`LogMessages.h`): identificativo e argomenti grezzi.
+};
+
+/**
+ * @struct TelemetryFrameHeader
+ * @brief Header di un datagramma della telemetria.
+ */
+struct TelemetryFrameHeader
+{
+    char magic[2];     ///< Identificativo del formato ("TL").
+    uint8_t version;   ///< Versione del formato (`TELEMETRY_FRAME_VERSION`).
+    uint8_t type;      ///< Tipo di payload (`TELEMETRY_FRAME`).
+    uint32_t sequence; ///< Numero di sequenza del datagramma.
+    uint16_t count;    ///< Record o messaggi contenuti.
+    uint16_t length;   ///< Lunghezza del payload in byte.
+};
+
+static_assert(sizeof(TelemetryFrameHeader) == 12, "Header dei datagrammi senza padding");
+
+#define TELEMETRY_FRAME_RECORDS ((TELEMETRY_FRAME_BYTES - sizeof(TelemetryFrameHeader)) / sizeof(TelemetryRecord)) ///< Record per datagramma.
+
+#define TELEMETRY_MAX_CHANNELS 32                                  ///< Canali registrabili.
+#define TELEMETRY_CHANNEL_NAME_SIZE 16                             ///< Lunghezza massima del nome di un canale (terminatore incluso).
+#define TELEMETRY_ENCODED_MAX ((TELEMETRY_MAX_CHANNELS + 1) * 5) ///< Dimensione massima di una riga codificata (ciclo e canali).
+#define TELEMETRY_SCHEMA_BYTES (3 + TELEMETRY_MAX_CHANNELS * (3 + TELEMETRY_CHANNEL_NAME_SIZE)) ///< Dimensione massima dello schema.
+
+/**
+ * @brief Tipo di un canale.
+ */
+enum class TELEMETRY_COLUMN : uint8_t
+{
+    UNSIGNED = 0, ///< Intero senza segno a 32 bit.
+    FIXED = 1     ///< Valore reale `float` in virgola fissa con segno (decimali indicati nello schema).
+};
+
+/**
+ * @struct TelemetryChannel
+ * @brief Canale della telemetria: un valore a 32 bit del record, con nome, tipo e scala.
+ */
+struct TelemetryChannel
+{
+    const char *name;      ///< Nome del canale (stringa statica).
+    uint16_t offset;       ///< Offset del valore nel record.
+    TELEMETRY_COLUMN type; ///< Tipo del valore.
+    uint8_t decimals;      ///< Decimali nella vista testuale e nella quantizzazione (scala 10^decimali).
+};
+
+/**
+ * @brief Registro dei canali della telemetria.
+ *
+ * I canali vengono registrati una volta al setup e ricevono un identificativo numerico, la
+ * loro posizione nel registro. Ogni canale ha un divisore modificabile a runtime da qualsiasi
+ * task: il canale viene inviato nei cicli multipli del divisore (1 = ogni ciclo, 0 = mai), così
+ * i canali lenti (interruttori, potenziometri) non occupano la banda di quelli veloci.
+ *
+ * Ogni modifica incrementa la generazione: il task di invio se ne accorge a inizio datagramma,
+ * copia la configurazione (`TelemetryEncoder::configure`) e invia subito lo schema nuovo.
+ */
+class TelemetryChannels
+{
+private:
+    TelemetryChannel channels[TELEMETRY_MAX_CHANNELS];     ///< Canali registrati, immutabili dopo `add`.
+    std::atomic<uint8_t> dividers[TELEMETRY_MAX_CHANNELS]; ///< Divisore di ciascun canale.
+    std::atomic<uint8_t> count{0};                         ///< Canali registrati (pubblicato dopo il canale).
+    std::atomic<uint16_t> generation{0};                   ///< Numero di modifiche della configurazione.
+
+public:
+    /**
+     * @brief Registra un canale (solo al setup, da un unico task).
+     *
+     * @param name Nome del canale, stringa statica di al massimo `TELEMETRY_CHANNEL_NAME_SIZE - 1` caratteri.
+     * @param offset Offset del valore a 32 bit in `TelemetryRecord` (`offsetof`).
+     * @param type Tipo del valore.
+     * @param decimals Decimali della quantizzazione (0-4; ignorati per `UNSIGNED`).
+     * @param divider Divisore iniziale (0 = disabilitato).
+     * @return int Identificativo del canale; -1 se il registro è pieno o il canale non è valido.
+     */
+    int add(const char *name, size_t offset, TELEMETRY_COLUMN type, uint8_t decimals, uint8_t divider = 1);
+
+    /**
+     * @brief Cerca un canale per nome.
+     *
+     * @return int Identificativo del canale; -1 se non registrato.
+     */
+    int find(const char *name) const;
+
+    /**
+     * @brief Imposta il divisore di un canale.
+     *
+     * @param id Identificativo del canale.
+     * @param divider Il canale viene inviato nei cicli multipli del divisore; 0 lo disabilita.
+     * @return true Se il canale esiste.
+     */
+    bool setDivider(uint8_t id, uint8_t divider);
+
+    uint8_t getDivider(uint8_t id) const { return dividers[id].load(std::memory_order_relaxed); } ///< Divisore di un canale.
+
+    const TelemetryChannel &get(uint8_t id) const { return channels[id]; } ///< Canale registrato.
+
+    uint8_t size() const { return count.load(std::memory_order_acquire); } ///< Canali registrati.
+
+    uint16_t getGeneration() const { return generation.load(std::memory_order_acquire); } ///< Generazione della configurazione.
+};
+
+/**
+ * @brief Codifica compatta delle righe di telemetria.
+ *
+ * Ogni riga inizia con il numero del ciclo, seguito dai canali previsti in quel ciclo (divisore
+ * non nullo che divide il ciclo): il decodificatore ricava gli stessi canali dal ciclo e dallo
+ * schema, senza maschere nella riga. Ogni valore viene quantizzato a intero (i reali con i
+ * decimali del canale), sottratto all'ultimo valore inviato dello stesso canale e scritto come
+ * varint zig-zag: i valori che cambiano poco occupano uno o due byte invece di quattro.
+ * La prima riga dopo `reset` è in differenza da zero, così ogni datagramma si decodifica da solo.
+ *
+ * La configurazione dei canali viene copiata da `configure`, così lo schema (`formatSchema`)
+ * e le righe restano coerenti anche se il registro cambia durante un datagramma.
+ */
+class TelemetryEncoder
+{
+private:
+    const TelemetryChannels *channels = nullptr;   ///< Registro dei canali.
+    uint8_t count = 0;                             ///< Canali nella configurazione copiata.
+    uint8_t dividers[TELEMETRY_MAX_CHANNELS];      ///< Divisori nella configurazione copiata.
+    uint16_t generation = 0;                       ///< Generazione della configurazione copiata.
+    uint32_t previous[TELEMETRY_MAX_CHANNELS + 1]; ///< Ultimi valori quantizzati inviati: ciclo e canali.
+
+public:
+    TelemetryEncoder() { reset(); } ///< Costruttore: nessun canale, la prossima riga è in differenza da zero.
+
+    /**
+     * @brief Copia la configurazione del registro, se è cambiata dall'ultima copia.
+     *
+     * @param registry Registro dei canali.
+     * @return true Se la configurazione è cambiata: lo schema va inviato di nuovo.
+     */
+    bool configure(const TelemetryChannels &registry);
+
+    uint16_t getGeneration() const { return generation; } ///< Generazione della configurazione copiata.
+
+    /**
+     * @brief Azzera lo stato: la prossima riga è in differenza da zero.
+     */
+    void reset();
+
+    /**
+     * @brief Codifica un record in differenza dal precedente.
+     *
+     * @param record Record da codificare.
+     * @param buffer Buffer di destinazione, di almeno `TELEMETRY_ENCODED_MAX` byte.
+     * @return size_t Byte scritti.
+     */
+    size_t encode(const TelemetryRecord &record, uint8_t *buffer);
+
+    /**
+     * @brief Scrive lo schema della configurazione copiata.
+     *
+     * Formato: generazione (u16), numero di canali (u8), poi per canale tipo (`TELEMETRY_COLUMN`),
+     * decimali (u8), divisore (u8) e nome terminato da '\0'. Il ciclo, sempre presente, non è un canale.
+     *
+     * @param buffer Buffer di destinazione, di almeno `TELEMETRY_SCHEMA_BYTES` byte.
+     * @param size Dimensione del buffer.
+     * @return size_t Byte scritti; 0 se il buffer non basta.
+     */
+    size_t formatSchema(uint8_t *buffer, size_t size) const;
+};
+
+/** @} */
+
+/**
+ * @struct TelemetryUploadStats
+ * @brief Statistiche dell'upload della telemetria.
+ */
+struct TelemetryUploadStats
+{
+    uint32_t rows;        ///< Righe inviate con successo dall'avvio.
+    uint32_t bytes;       ///< Byte inviati con successo dall'avvio.
+    uint32_t requests;    ///< Richieste riuscite dall'avvio.
+    uint32_t failures;    ///< Richieste fallite dall'avvio.
+    float rowsPerSecond;  ///< Righe al secondo nell'ultimo intervallo.
+    float bytesPerSecond; ///< Byte al secondo nell'ultimo intervallo.
+};
+
+/**
+ * @brief Coda preallocata dei record di telemetria, dal ciclo di controllo al task di invio.
+ *
+ * L'inserimento copia il record in uno slot fisso e non alloca né prende lock; con la coda
+ * piena il record nuovo viene scartato e contato (vedi `SPSCRing`). La memoria viene assegnata
+ * una volta dal budget del logger (`Logger::allocateBuffers`).
+ */
+using TelemetryQueue = SPSCRing<TelemetryRecord>;
+
+/**
+ * @brief Scrive l'header dei dati come array JSON: timestamp di inizio e nomi dei canali registrati.
+ *
+ * @param channels Registro dei canali.
+ * @param startTimestamp Timestamp di inizio raccolta dati.
+ * @param buffer Buffer di destinazione.
+ * @param size Dimensione del buffer.
+ * @return size_t Caratteri scritti (escluso il terminatore).
+ */
+size_t telemetry_format_header(const TelemetryChannels &channels, const char *startTimestamp, char *buffer, size_t size);
+
+/**
+ * @brief Scrive un record come array JSON: numero del ciclo e valori di tutti i canali registrati.
+ *
+ * @param channels Registro dei canali.
+ * @param record Record da convertire.
+ * @param buffer Buffer di destinazione.
+ * @param size Dimensione del buffer.
+ * @return size_t Caratteri scritti (escluso il terminatore).
+ */
+size_t telemetry_format_record(const TelemetryChannels &channels, const TelemetryRecord &record, char *buffer, size_t size);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,73 @@
+/**
+ * @file TelemetryChannelTable.h
+ * @brief Tabella dei canali della telemetria registrati dall'aereo.
+ *
+ * Condivisa da `Aircraft::register_telemetry_channels` e dai test su host, che codificano le
+ * stesse righe inviate in volo.
+ */
+#ifndef TELEMETRY_CHANNEL_TABLE_H
+#define TELEMETRY_CHANNEL_TABLE_H
+
+#include "Telemetry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_DIVIDER_SWITCHES 100 ///< Divisore dei canali degli interruttori del radiocomando (1 Hz a 100 Hz).
+#define TELEMETRY_DIVIDER_POTS 20      ///< Divisore dei canali dei potenziometri del radiocomando (5 Hz a 100 Hz).
+#define TELEMETRY_DIVIDER_RPM 10       ///< Divisore del canale dei giri del motore (10 Hz a 100 Hz).
+#define TELEMETRY_CHANNEL_DECIMALS 3   ///< Decimali dei canali reali.
+
+/**
+ * @struct TelemetryChannelSpec
+ * @brief Canale da registrare: nome, posizione nel record, tipo e divisore iniziale.
+ */
+struct TelemetryChannelSpec
+{
+    const char *name;      ///< Nome del canale.
+    size_t offset;         ///< Offset del valore in `TelemetryRecord`.
+    TELEMETRY_COLUMN type; ///< Tipo del valore.
+    uint8_t divider;       ///< Divisore iniziale.
+};
+
+/**
+ * @brief Canali della telemetria; l'identificativo di ogni canale è la sua posizione nella tabella.
+ *
+ * Giroscopio, assetto e output viaggiano a ogni ciclo; interruttori, potenziometri e giri del
+ * motore, che cambiano lentamente, a frequenza ridotta.
+ */
+static const TelemetryChannelSpec TELEMETRY_CHANNEL_TABLE[] = {
+    {"t_us", offsetof(TelemetryRecord, timestamp_us), TELEMETRY_COLUMN::UNSIGNED, 1},
+    {"flags", offsetof(TelemetryRecord, flags), TELEMETRY_COLUMN::UNSIGNED, 1},
+    {"G_X", offsetof(TelemetryRecord, imu.gyro.x), TELEMETRY_COLUMN::FIXED, 1},
+    {"G_Y", offsetof(TelemetryRecord, imu.gyro.y), TELEMETRY_COLUMN::FIXED, 1},
+    {"G_Z", offsetof(TelemetryRecord, imu.gyro.z), TELEMETRY_COLUMN::FIXED, 1},
+    {"Ac_X", offsetof(TelemetryRecord, imu.accel.x), TELEMETRY_COLUMN::FIXED, 1},
+    {"Ac_Y", offsetof(TelemetryRecord, imu.accel.y), TELEMETRY_COLUMN::FIXED, 1},
+    {"Ac_Z", offsetof(TelemetryRecord, imu.accel.z), TELEMETRY_COLUMN::FIXED, 1},
+    {"Q_W", offsetof(TelemetryRecord, imu.quat.w), TELEMETRY_COLUMN::FIXED, 1},
+    {"Q_X", offsetof(TelemetryRecord, imu.quat.x), TELEMETRY_COLUMN::FIXED, 1},
+    {"Q_Y", offsetof(TelemetryRecord, imu.quat.y), TELEMETRY_COLUMN::FIXED, 1},
+    {"Q_Z", offsetof(TelemetryRecord, imu.quat.z), TELEMETRY_COLUMN::FIXED, 1},
+    {"V", offsetof(TelemetryRecord, imu.vel), TELEMETRY_COLUMN::FIXED, 1},
+    {"x", offsetof(TelemetryRecord, receiver.x), TELEMETRY_COLUMN::FIXED, 1},
+    {"y", offsetof(TelemetryRecord, receiver.y), TELEMETRY_COLUMN::FIXED, 1},
+    {"throttle", offsetof(TelemetryRecord, receiver.throttle), TELEMETRY_COLUMN::FIXED, 1},
+    {"z", offsetof(TelemetryRecord, receiver.z), TELEMETRY_COLUMN::FIXED, 1},
+    {"swa", offsetof(TelemetryRecord, receiver.swa), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_SWITCHES},
+    {"swb", offsetof(TelemetryRecord, receiver.swb), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_SWITCHES},
+    {"swc", offsetof(TelemetryRecord, receiver.swc), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_SWITCHES},
+    {"swd", offsetof(TelemetryRecord, receiver.swd), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_SWITCHES},
+    {"vra", offsetof(TelemetryRecord, receiver.vra), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_POTS},
+    {"vrb", offsetof(TelemetryRecord, receiver.vrb), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_POTS},
+    {"out_x", offsetof(TelemetryRecord, output.x), TELEMETRY_COLUMN::FIXED, 1},
+    {"out_y", offsetof(TelemetryRecord, output.y), TELEMETRY_COLUMN::FIXED, 1},
+    {"out_z", offsetof(TelemetryRecord, output.z), TELEMETRY_COLUMN::FIXED, 1},
+    {"out_throttle", offsetof(TelemetryRecord, output.throttle), TELEMETRY_COLUMN::FIXED, 1},
+    {"RPM", offsetof(TelemetryRecord, rpm), TELEMETRY_COLUMN::FIXED, TELEMETRY_DIVIDER_RPM},
+};
+
+#define TELEMETRY_CHANNEL_TABLE_SIZE (sizeof(TELEMETRY_CHANNEL_TABLE) / sizeof(TELEMETRY_CHANNEL_TABLE[0])) ///< Canali della tabella.
+
+static_assert(TELEMETRY_CHANNEL_TABLE_SIZE <= TELEMETRY_MAX_CHANNELS, "Troppi canali per il registro della telemetria");
+
+#endif // TELEMETRY_CHANNEL_TABLE_H
@@ -0,0 +1,74 @@
+/**
+ * @file TelemetryStream.h
+ * @brief Dichiarazione della classe TelemetryStream per l'invio della telemetria in datagrammi UDP.
+ */
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include "Telemetry.h"
+#include <WiFiUdp.h>
+
+/**
+ * @brief Stream di datagrammi UDP numerati verso la stazione di terra.
+ *
+ * Un unico socket resta aperto per tutta la sessione: ogni invio costa un datagramma, senza
+ * handshake né chiusura di connessione. I datagrammi vengono composti in un buffer
+ * preallocato: `begin` apre un datagramma del tipo indicato, `append` aggiunge un elemento se
+ * c'è spazio, `send` lo trasmette e incrementa il numero di sequenza.
+ */
+class TelemetryStream
+{
+private:
+    WiFiUDP udp;                          ///< Socket UDP.
+    uint8_t frame[TELEMETRY_FRAME_BYTES]; ///< Datagramma in composizione.
+    size_t length;                        ///< Byte occupati nel datagramma (header incluso).
+    uint16_t count;                       ///< Elementi nel datagramma.
+    uint32_t sequence;                    ///< Numero di sequenza del prossimo datagramma.
+
+public:
+    TelemetryStream(); ///< Costruttore: nessun datagramma aperto.
+
+    /**
+     * @brief Apre un nuovo datagramma, scartando quello in composizione.
+     *
+     * @param type Tipo di payload.
+     * @param prefix Dati iniziali del payload, non contati tra gli elementi (opzionale).
+     * @param prefixSize Dimensione dei dati iniziali in byte.
+     */
+    void begin(TELEMETRY_FRAME type, const void *prefix = nullptr, size_t prefixSize = 0);
+
+    /**
+     * @brief Aggiunge un elemento al datagramma.
+     *
+     * @param data Dati dell'elemento.
+     * @param size Dimensione in byte.
+     * @return true Se l'elemento è stato aggiunto, false se non c'è spazio.
+     */
+    bool append(const void *data, size_t size);
+
+    /**
+     * @brief Restituisce il numero di elementi nel datagramma in composizione.
+     */
+    uint16_t pending() const { return count; }
+
+    /**
+     * @brief Restituisce la dimensione del datagramma in composizione (header incluso).
+     */
+    size_t size() const { return length; }
+
+    /**
+     * @brief Trasmette il datagramma in composizione.
+     *
+     * @param address Indirizzo del server.
+     * @param port Porta UDP del server.
+     * @return size_t Byte trasmessi (header incluso); 0 in caso di errore o datagramma vuoto.
+     */
+    size_t send(const char *address, uint16_t port);
+
+    /**
+     * @brief Restituisce il numero di sequenza del prossimo datagramma.
+     */
+    uint32_t getSequence() const { return sequence; }
+};
+
+#endif // TELEMETRY_STREAM_H
@@ -0,0 +1,91 @@
+"""
+Tabella dei messaggi di log a formattazione differita.
+
+Il firmware invia i messaggi di include/LogMessages.h come identificativo e argomenti grezzi
+(parole da 32 bit). La tabella viene letta direttamente dall'header, così resta allineata al
+firmware compilato dagli stessi sorgenti; l'impronta inviata con i messaggi segnala un
+firmware compilato con una tabella diversa.
+"""
+
+import os
+import re
+import struct
+
+DEFAULT_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include", "LogMessages.h")
+
+# Valori di LogLevel nel firmware (include/DataStructures.h)
+LEVELS = {"ERROR": 0, "WARNING": 1, "INFO": 2}
+LEVEL_NAMES = {value: name for name, value in LEVELS.items()}
+
+ENTRY = re.compile(r'X\(\s*(\w+)\s*,\s*(\w+)\s*,\s*"([^"]*)"\s*\)')
+CONVERSION = re.compile(r"%(?:%|[-+ #0]*\d*(?:\.\d+)?([diuxf]))")
+
+
+def table_hash(messages):
+    """Impronta FNV-1a di livello e formato dei messaggi, come `log_table_hash()` nel firmware."""
+    value = 2166136261
+    for _, level, fmt in messages:
+        for byte in bytes([LEVELS[level]]) + fmt.encode("ascii") + b"\0":
+            value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def render(fmt, args):
+    """Compone il testo di un formato con gli argomenti grezzi (mancanti = 0)."""
+    values = []
+    for match in CONVERSION.finditer(fmt):
+        conversion = match.group(1)
+        if conversion is None:
+            continue  # '%%'
+        word = args[len(values)] if len(values) < len(args) else 0
+        if conversion == "f":
+            values.append(struct.unpack("<f", struct.pack("<I", word))[0])
+        elif conversion in "di":
+            values.append(word - (1 << 32) if word & 0x80000000 else word)
+        else:
+            values.append(word)
+    return fmt % tuple(values)
+
+
+class LogTable:
+    """Messaggi indicizzati per identificativo (0 = testo libero, non in tabella)."""
+
+    def __init__(self, path=DEFAULT_PATH):
+        with open(path, encoding="utf-8") as f:
+            source = f.read()
+        start = source.index("#define LOG_MESSAGES(X)")
+        end = source.index("\n\n", start)
+        self.messages = ENTRY.findall(source[start:end])
+        self.hash = table_hash(self.messages)
+
+    def format_line(self, timestamp_ms, message_id, args, table_hash=None):
+        """Riga nello stesso formato del firmware: "[hh:mm:ss] LIVELLO: testo"."""
+        seconds = timestamp_ms // 1000
+        prefix = f"[{seconds // 3600:02d}:{seconds // 60 % 60:02d}:{seconds % 60:02d}]"
+        if table_hash not in (None, self.hash) or not 1 <= message_id <= len(self.messages):
+            # Tabella diversa da quella del firmware: il testo potrebbe non corrispondere
+            raw = " ".join(f"0x{word:08x}" for word in args)
+            return f"{prefix} UNKNOWN: message {message_id} {raw}".rstrip()
+        _, level, fmt = self.messages[message_id - 1]
+        return f"{prefix} {level}: {render(fmt, args)}"
+
+
+def decode_events(payload, count, table):
+    """Decodifica un payload EVENT: impronta (u32), poi `count` messaggi (istante, id, argomenti)."""
+    if len(payload) < 4:
+        raise ValueError("Payload EVENT troppo corto")
+    (received_hash,) = struct.unpack_from("<I", payload)
+    lines, offset = [], 4
+    for _ in range(count):
+        if offset + 7 > len(payload):
+            raise ValueError("Messaggio troncato")
+        timestamp_ms, message_id, argc = struct.unpack_from("<IHB", payload, offset)
+        offset += 7
+        if offset + 4 * argc > len(payload):
+            raise ValueError("Argomenti troncati")
+        args = struct.unpack_from(f"<{argc}I", payload, offset)
+        offset += 4 * argc
+        lines.append(table.format_line(timestamp_ms, message_id, args, received_hash))
+    if offset != len(payload):
+        raise ValueError("Lunghezza dei messaggi non coerente")
+    return lines
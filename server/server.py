@@ -5,6 +5,7 @@ import socket
 import threading
 import os
 import signal
+import telemetry_stream
 
 app = Flask(__name__)
 
@@ -14,6 +15,8 @@ display_logs = []  # Log visibili su /logs
 
 server_data = []     # Dati numerici disponibili su /get_data_logs
 
+stream_stats = telemetry_stream.StreamStats()  # Statistiche dello stream UDP su /get_stream_stats
+
 # Variabile per il controllo dell'arresto
 shutdown_signal = False
 
@@ -33,6 +36,24 @@ def start_mdns_service():
     zeroconf.register_service(service_info)
     return zeroconf, service_info
 
+# Callback dello stream UDP: righe di dati
+def receive_stream_rows(rows, header):
+    if header:
+        # Nuovo stream: stessa intestazione inviata dall'upload HTTP
+        server_data.append(header)
+    server_data.extend(rows)
+
+# Callback dello stream UDP: messaggi di log
+def receive_stream_logs(messages):
+    for message in messages:
+        timestamped_log = f"[{datetime.now().strftime('%H:%M:%S')}] {message}"
+        display_logs.append(timestamped_log)
+        server_logs.append(timestamped_log)
+
+# Funzione per ricevere lo stream UDP della telemetria
+def run_stream_receiver():
+    telemetry_stream.serve(telemetry_stream.DEFAULT_PORT, receive_stream_rows, receive_stream_logs, stream_stats)
+
 # Endpoint per ricevere i log dall'ESP32
 @app.route('/receive_logs', methods=['POST'])
 def receive_logs():
@@ -111,7 +132,11 @@ def receive_data_logs():
     global data_logs
     try:
         data = request.get_json()
-        if isinstance(data, list):
+        if isinstance(data, list) and data and all(isinstance(row, list) for row in data):
+            # Batch: una lista di righe
+            server_data.extend(data)
+            return f"{len(data)} data rows received", 200
+        elif isinstance(data, list):
             server_data.append(data)
             return "Data logs received", 200
         else:
@@ -125,6 +150,11 @@ def get_data_logs():
     global server_data
     return jsonify(server_data), 200
 
+# Endpoint per ottenere le statistiche dello stream UDP (datagrammi persi e fuori ordine)
+@app.route('/get_stream_stats', methods=['GET'])
+def get_stream_stats():
+    return jsonify(stream_stats.snapshot()), 200
+
 # Endpoint per cancellare i dati numerici dal server
 @app.route('/clear_server_data', methods=['GET'])
 def clear_server_data():
@@ -156,6 +186,8 @@ if __name__ == '__main__':
     zeroconf, service_info = start_mdns_service()
     server_thread = threading.Thread(target=run_server)
     server_thread.start()
+    stream_thread = threading.Thread(target=run_stream_receiver, daemon=True)
+    stream_thread.start()
 
     try:
         while not shutdown_signal:
@@ -0,0 +1,326 @@
+"""
+Ricezione dello stream UDP della telemetria inviato dall'ESP32.
+
+Formato dei datagrammi (vedi include/Telemetry.h, little-endian):
+    header  magic "TL", versione (u8), tipo (u8), sequenza (u32), conteggio (u16), lunghezza (u16)
+    DATA    `conteggio` record TelemetryRecord binari consecutivi
+    LOG     `conteggio` messaggi di testo terminati da '\\0'
+    SCHEMA  generazione (u16), numero di canali (u8), poi per canale tipo (u8), decimali (u8),
+            divisore (u8) e nome terminato da '\\0'
+    DELTA   generazione dello schema (u16), poi `conteggio` righe: il ciclo e i canali previsti
+            nel ciclo (divisore non nullo che divide il ciclo), ciascuno come differenza quantizzata
+            dall'ultimo valore dello stesso canale, in varint zig-zag; la prima riga del
+            datagramma è in differenza da zero
+    EVENT   impronta della tabella dei messaggi (u32), poi `conteggio` messaggi di
+            include/LogMessages.h: istante in ms (u32), identificativo (u16), numero di argomenti
+            (u8) e argomenti (u32); il testo viene composto con server/log_messages.py
+
+Il numero di sequenza cresce di uno per datagramma: i buchi indicano datagrammi persi.
+
+Il modulo è usato da server.py per l'ingest e può essere eseguito da solo come ricevitore
+di prova su Linux:
+    python3 server/telemetry_stream.py --port 5005
+"""
+
+import argparse
+import socket
+import struct
+import threading
+import time
+from datetime import datetime
+
+import log_messages
+
+DEFAULT_PORT = 5005
+FRAME_VERSION = 2
+FRAME_DATA = 1
+FRAME_LOG = 2
+FRAME_SCHEMA = 3
+FRAME_DELTA = 4
+FRAME_EVENT = 5
+
+COLUMN_UNSIGNED = 0
+COLUMN_FIXED = 1
+
+FRAME_HEADER = struct.Struct("<2sBBIHH")
+# timestamp_us, cycle, ImuData (11 float), ReceiverData (10 float), Output (4 float), rpm, flags
+RECORD = struct.Struct("<II11f10f4ffI")
+
+COLUMNS = ["t_us", "flags", "G_X", "G_Y", "G_Z", "Ac_X", "Ac_Y", "Ac_Z", "Q_W", "Q_X", "Q_Y", "Q_Z", "V",
+           "x", "y", "throttle", "z", "swa", "swb", "swc", "swd", "vra", "vrb",
+           "out_x", "out_y", "out_z", "out_throttle", "RPM"]
+
+
+def header_row(columns=COLUMNS):
+    """Riga di intestazione nello stesso formato dell'upload HTTP: istante di inizio e canali."""
+    return [datetime.now().strftime("%Y-%m-%d %H:%M:%S")] + list(columns)
+
+
+def decode_record(data, offset=0):
+    """Converte un record binario in una riga: ciclo, timestamp, flag e valori delle colonne."""
+    fields = RECORD.unpack_from(data, offset)
+    timestamp_us, cycle = fields[0], fields[1]
+    values, flags = fields[2:-1], fields[-1]
+    return [str(cycle), str(timestamp_us), str(flags)] + [f"{v:.3f}" for v in values]
+
+
+def decode_schema(payload):
+    """Restituisce (generazione, canali) con i canali come lista di (nome, tipo, decimali, divisore)."""
+    if len(payload) < 3:
+        raise ValueError("Schema vuoto")
+    generation, count = struct.unpack_from("<HB", payload)
+    offset, channels = 3, []
+    for _ in range(count):
+        end = payload.find(b"\0", offset + 3)
+        if end < 0:
+            raise ValueError("Schema troncato")
+        kind, decimals, divider = payload[offset:offset + 3]
+        channels.append((payload[offset + 3:end].decode("ascii"), kind, decimals, divider))
+        offset = end + 1
+    return generation, channels
+
+
+def decode_delta(payload, count, channels):
+    """
+    Decodifica `count` righe codificate in differenza, nella stessa vista testuale di DATA.
+
+    Le righe contengono il ciclo e i canali abilitati; i canali non previsti nel ciclo
+    (decimati) sono stringhe vuote.
+    """
+    rows, previous, offset = [], [0] * (len(channels) + 1), 0
+
+    def read_value(i):
+        # Varint: 7 bit per byte, bit alto = continua
+        nonlocal offset
+        zigzag = shift = 0
+        while True:
+            if offset >= len(payload):
+                raise ValueError("Riga troncata")
+            byte = payload[offset]
+            offset += 1
+            zigzag |= (byte & 0x7F) << shift
+            shift += 7
+            if byte < 0x80:
+                break
+        delta = (zigzag >> 1) ^ -(zigzag & 1)
+        previous[i] = (previous[i] + delta) & 0xFFFFFFFF
+        return previous[i]
+
+    for _ in range(count):
+        cycle = read_value(0)
+        row = [str(cycle)]
+        for i, (_, kind, decimals, divider) in enumerate(channels, start=1):
+            if divider == 0:
+                continue
+            if cycle % divider:
+                row.append("")
+                continue
+            value = read_value(i)
+            if kind == COLUMN_UNSIGNED:
+                row.append(str(value))
+            else:
+                signed = value - (1 << 32) if value & 0x80000000 else value
+                row.append(f"{signed / 10 ** decimals:.{decimals}f}")
+        rows.append(row)
+    if offset != len(payload):
+        raise ValueError("Lunghezza delle righe non coerente")
+    return rows
+
+
+class StreamDecoder:
+    """Decodifica dei datagrammi; conserva l'ultimo schema ricevuto per le righe DELTA."""
+
+    def __init__(self, log_table=None):
+        self.schema = None  # (generazione, canali)
+        self.log_table = log_table or log_messages.LogTable()
+
+    def columns(self):
+        """Nomi dei canali abilitati nello schema corrente, escluso il ciclo."""
+        if self.schema is None:
+            return COLUMNS
+        return [name for name, _, _, divider in self.schema[1] if divider]
+
+    def decode_frame(self, datagram):
+        """
+        Decodifica un datagramma.
+
+        Restituisce (tipo, sequenza, elementi): righe di dati per FRAME_DATA e FRAME_DELTA,
+        stringhe per FRAME_LOG e FRAME_EVENT, (generazione, canali) per FRAME_SCHEMA. Gli elementi
+        sono None per righe DELTA arrivate prima del loro schema. Solleva ValueError se il
+        datagramma non è valido.
+        """
+        if len(datagram) < FRAME_HEADER.size:
+            raise ValueError("Datagramma troppo corto")
+        magic, version, frame_type, sequence, count, length = FRAME_HEADER.unpack_from(datagram)
+        if magic != b"TL" or version != FRAME_VERSION:
+            raise ValueError("Formato non riconosciuto")
+        payload = datagram[FRAME_HEADER.size:FRAME_HEADER.size + length]
+        if len(payload) != length:
+            raise ValueError("Payload incompleto")
+
+        if frame_type == FRAME_DATA:
+            if length != count * RECORD.size:
+                raise ValueError("Lunghezza dei record non coerente")
+            rows = [decode_record(payload, i * RECORD.size) for i in range(count)]
+            return frame_type, sequence, rows
+        if frame_type == FRAME_LOG:
+            messages = [m.decode("utf-8", errors="replace") for m in payload.split(b"\0") if m]
+            return frame_type, sequence, messages
+        if frame_type == FRAME_EVENT:
+            return frame_type, sequence, log_messages.decode_events(payload, count, self.log_table)
+        if frame_type == FRAME_SCHEMA:
+            self.schema = decode_schema(payload)
+            return frame_type, sequence, self.schema
+        if frame_type == FRAME_DELTA:
+            if length < 2:
+                raise ValueError("Payload DELTA troppo corto")
+            (generation,) = struct.unpack_from("<H", payload)
+            if self.schema is None or self.schema[0] != generation:
+                return frame_type, sequence, None
+            return frame_type, sequence, decode_delta(payload[2:], count, self.schema[1])
+        raise ValueError(f"Tipo di datagramma sconosciuto: {frame_type}")
+
+
+class StreamStats:
+    """Conteggio di datagrammi ricevuti, persi e fuori ordine a partire dai numeri di sequenza."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.reset()
+
+    def reset(self):
+        self.expected = None
+        self.frames = 0
+        self.rows = 0
+        self.bytes = 0
+        self.lost = 0
+        self.out_of_order = 0
+        self.invalid = 0
+        self.undecoded = 0
+        self.restarts = 0
+
+    def update(self, sequence, rows, size):
+        """Aggiorna le statistiche; restituisce True se lo stream è (ri)partito."""
+        with self.lock:
+            restarted = False
+            if self.expected is None or sequence == 0 and self.expected > 0:
+                # Primo datagramma o riavvio del dispositivo
+                restarted = True
+                self.restarts += self.expected is not None
+            elif sequence > self.expected:
+                self.lost += sequence - self.expected
+            elif sequence < self.expected:
+                self.out_of_order += 1
+                self.lost = max(0, self.lost - 1)
+            if restarted or sequence >= self.expected:
+                self.expected = sequence + 1
+            self.frames += 1
+            self.rows += rows
+            self.bytes += size
+            return restarted
+
+    def snapshot(self):
+        with self.lock:
+            total = self.frames + self.lost
+            return {
+                "frames": self.frames,
+                "rows": self.rows,
+                "bytes": self.bytes,
+                "lost": self.lost,
+                "loss_ratio": self.lost / total if total else 0.0,
+                "out_of_order": self.out_of_order,
+                "invalid": self.invalid,
+                "undecoded": self.undecoded,
+                "restarts": self.restarts,
+            }
+
+
+def serve(port, on_rows, on_logs, stats, stop_event=None, host="0.0.0.0"):
+    """
+    Riceve i datagrammi su `port` finché `stop_event` non viene impostato.
+
+    `on_rows(rows, header)` riceve le righe di dati e, per le prime righe di uno stream nuovo o
+    riavviato o dopo un cambio dei canali abilitati, la riga di intestazione (altrimenti None);
+    `on_logs(messages)` i messaggi di log.
+    """
+    decoder = StreamDecoder()
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind((host, port))
+    sock.settimeout(0.5)
+    # Il riavvio può arrivare con un datagramma di log o di schema: l'intestazione va sulle prime righe
+    header_pending = False
+    columns = decoder.columns()
+    try:
+        while stop_event is None or not stop_event.is_set():
+            try:
+                datagram, _ = sock.recvfrom(65535)
+            except socket.timeout:
+                continue
+            try:
+                frame_type, sequence, items = decoder.decode_frame(datagram)
+            except ValueError:
+                with stats.lock:
+                    stats.invalid += 1
+                continue
+            if frame_type == FRAME_SCHEMA and decoder.columns() != columns:
+                # Canali abilitati cambiati: le righe seguenti hanno un'intestazione nuova
+                columns = decoder.columns()
+                header_pending = True
+            is_data = frame_type in (FRAME_DATA, FRAME_DELTA)
+            restarted = stats.update(sequence, len(items) if is_data and items else 0, len(datagram))
+            header_pending = header_pending or restarted
+            if is_data and items is None:
+                # Righe arrivate prima dello schema: non decodificabili
+                with stats.lock:
+                    stats.undecoded += 1
+            elif is_data:
+                row_columns = columns if frame_type == FRAME_DELTA else COLUMNS
+                on_rows(items, header_row(row_columns) if header_pending else None)
+                header_pending = False
+            elif frame_type in (FRAME_LOG, FRAME_EVENT):
+                on_logs(items)
+    finally:
+        sock.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Ricevitore di prova dello stream UDP della telemetria.")
+    parser.add_argument("--port", type=int, default=DEFAULT_PORT, help="Porta UDP in ascolto.")
+    parser.add_argument("--rows", action="store_true", help="Stampa ogni riga di dati ricevuta.")
+    args = parser.parse_args()
+
+    stats = StreamStats()
+
+    def on_rows(rows, header):
+        if header:
+            print("Stream avviato:", ",".join(header))
+        if args.rows:
+            for row in rows:
+                print(",".join(row))
+
+    def on_logs(messages):
+        for message in messages:
+            print(message)
+
+    stop_event = threading.Event()
+    thread = threading.Thread(target=serve, args=(args.port, on_rows, on_logs, stats, stop_event), daemon=True)
+    thread.start()
+    print(f"In ascolto su UDP {args.port}. Ctrl+C per uscire.")
+
+    previous = stats.snapshot()
+    try:
+        while True:
+            time.sleep(1.0)
+            current = stats.snapshot()
+            print(f"{current['rows'] - previous['rows']} righe/s, {current['bytes'] - previous['bytes']} byte/s, "
+                  f"persi {current['lost']} ({current['loss_ratio']:.2%}), fuori ordine {current['out_of_order']}, "
+                  f"non validi {current['invalid']}, senza schema {current['undecoded']}")
+            previous = current
+    except KeyboardInterrupt:
+        stop_event.set()
+        thread.join()
+
+
+if __name__ == "__main__":
+    main()
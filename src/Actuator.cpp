@@ -2,6 +2,8 @@
 #include "HardwareParameters.h"
 #include "Logger.h"
 #include <Arduino.h>
+#include <hal/ledc_ll.h>
+#include <soc/ledc_struct.h>
 
 /**
  * Funzione per limitare un valore all'interno di un intervallo.
@@ -13,32 +15,195 @@ constexpr const T &clamp(const T &value, const T &min, const T &max)
                                                : value;
 }
 
+
 /**
- * Converte un valore digitale in PWM, rispettando i limiti configurati.
+ * Parametri di temporizzazione di un protocollo di uscita.
  */
-int digital_to_pwm(double value, double min_digital, double max_digital, int min_analog, int max_analog)
+struct ProtocolTiming
 {
-    return clamp(static_cast<int>(((value - min_digital) * (max_analog - min_analog) / (max_digital - min_digital)) + min_analog), min_analog, max_analog);
-}
+    uint32_t frequency;  ///< Frequenza PWM (Hz).
+    uint8_t resolution;  ///< Risoluzione del duty cycle (bit).
+    float pulse_scale;   ///< Durata impulso = pwm * pulse_scale + pulse_offset.
+    float pulse_offset;  ///< Offset della durata dell'impulso (µs).
+};
 
-Actuator::Actuator(int pin, int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max) : pin(pin)
+/**
+ * Restituisce i parametri di temporizzazione di un protocollo.
+ *
+ * Le risoluzioni sono limitate dal timer LEDC dell'ESP32-S3 (14 bit) e, a frequenze elevate,
+ * dal clock APB (80 MHz).
+ */
+static ProtocolTiming protocol_timing(ACTUATOR_PROTOCOL protocol)
 {
-    Logger::getInstance().log(LogLevel::INFO, "Actuator setup started.");
+    switch (protocol)
+    {
+    case ACTUATOR_PROTOCOL::SERVO_333HZ:
+        return {333, 14, 1.0f, 0.0f};
+    case ACTUATOR_PROTOCOL::SERVO_560HZ:
+        return {560, 14, 1.0f, 0.0f};
+    case ACTUATOR_PROTOCOL::ONESHOT125:
+        return {2000, 14, 0.125f, 0.0f}; // 1000-2000 -> 125-250 µs
+    case ACTUATOR_PROTOCOL::MULTISHOT:
+        return {16000, 12, 0.02f, -15.0f}; // 1000-2000 -> 5-25 µs
+    case ACTUATOR_PROTOCOL::SERVO_50HZ:
+    default:
+        return {50, 14, 1.0f, 0.0f};
+    }
+}
 
+void Actuator::set_limits(int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max)
+{
     this->pwm_min = pwm_min;
     this->pwm_max = pwm_max;
     this->pwm_null = pwm_null;
     this->digital_min = digital_min;
     this->digital_max = digital_max;
+    pwm_per_unit = (float)(pwm_max - pwm_min) / (float)(digital_max - digital_min);
+}
+
+Actuator::Actuator(int pin, RmtChannels rmt, ACTUATOR_PROTOCOL protocol, int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max)
+    : pin(pin), channel(LEDC_CHANNEL_MAX), timer(LEDC_TIMER_MAX), protocol(protocol),
+      ticks_per_us(0), pulse_scale(0), pulse_offset(0), pwm_per_unit(0)
+{
+    Logger::getInstance().log(LogLevel::INFO, "Actuator setup started.");
+
+    set_limits(pwm_min, pwm_max, pwm_null, digital_min, digital_max);
 
-    actuator.attach(pin);
-    actuator.writeMicroseconds(pwm_null);
+    if (protocol != ACTUATOR_PROTOCOL::DSHOT300 && protocol != ACTUATOR_PROTOCOL::DSHOT600)
+    {
+        Logger::getInstance().log(LogLevel::ERROR, "Actuator RMT output requires a DShot protocol!");
+        return;
+    }
+
+    dshot.reset(new DShotESC(pin, rmt.tx, rmt.rx, protocol, DSHOT_BIDIRECTIONAL));
+    valid = true;
+    write_pwm(pwm_null);
 
     Logger::getInstance().log(LogLevel::INFO, "Actuator setup complete.");
 }
 
+Actuator::Actuator(int pin, int channel, int timer, ACTUATOR_PROTOCOL protocol, int pwm_min, int pwm_max, int pwm_null, double digital_min, double digital_max)
+    : pin(pin), channel(static_cast<ledc_channel_t>(channel)), timer(static_cast<ledc_timer_t>(timer)), protocol(protocol),
+      ticks_per_us(0), pulse_scale(0), pulse_offset(0), pwm_per_unit(0)
+{
+    Logger::getInstance().log(LogLevel::INFO, "Actuator setup started.");
+
+    set_limits(pwm_min, pwm_max, pwm_null, digital_min, digital_max);
+
+    if (protocol == ACTUATOR_PROTOCOL::DSHOT300 || protocol == ACTUATOR_PROTOCOL::DSHOT600)
+    {
+        Logger::getInstance().log(LogLevel::ERROR, "Actuator DShot output requires RMT channels!");
+        return;
+    }
+
+    ProtocolTiming timing = protocol_timing(protocol);
+    ticks_per_us = (float)(1UL << timing.resolution) * timing.frequency / 1000000.0f;
+    pulse_scale = timing.pulse_scale;
+    pulse_offset = timing.pulse_offset;
+
+    // Configura il timer che genera il periodo PWM
+    ledc_timer_config_t timer_config = {};
+    timer_config.speed_mode = LEDC_LOW_SPEED_MODE;
+    timer_config.duty_resolution = static_cast<ledc_timer_bit_t>(timing.resolution);
+    timer_config.timer_num = this->timer;
+    timer_config.freq_hz = timing.frequency;
+    timer_config.clk_cfg = LEDC_AUTO_CLK;
+
+    // Collega il canale al timer e al pin
+    ledc_channel_config_t channel_config = {};
+    channel_config.gpio_num = pin;
+    channel_config.speed_mode = LEDC_LOW_SPEED_MODE;
+    channel_config.channel = this->channel;
+    channel_config.intr_type = LEDC_INTR_DISABLE;
+    channel_config.timer_sel = this->timer;
+    channel_config.duty = 0;
+    channel_config.hpoint = 0;
+
+    if (ledc_timer_config(&timer_config) != ESP_OK || ledc_channel_config(&channel_config) != ESP_OK)
+    {
+        Logger::getInstance().log(LogLevel::ERROR, "Actuator LEDC configuration failed!");
+        return;
+    }
+
+    valid = true;
+    write_pwm(pwm_null);
+
+    Logger::getInstance().log(LogLevel::INFO, "Actuator setup complete.");
+}
+
+bool Actuator::stage(int pwm_value)
+{
+    // Un attuatore non configurato non ha né canale né scala: nessuna scrittura
+    if (!valid)
+        return false;
+
+    if (dshot != nullptr)
+    {
+        staged_dshot = dshot_throttle_from_pwm(pwm_value, pwm_min, pwm_max);
+        return true;
+    }
+
+    // Converte la scala standard nella durata reale dell'impulso e poi in tick LEDC
+    float pulse_us = pwm_value * pulse_scale + pulse_offset;
+    staged_duty = static_cast<uint32_t>(pulse_us * ticks_per_us + 0.5f);
+    return staged_duty != applied_duty;
+}
+
+void Actuator::apply()
+{
+    if (!valid)
+        return;
+
+    if (dshot != nullptr)
+    {
+        dshot->write(staged_dshot);
+        return;
+    }
+
+    // Solo registri, come `ledc_set_duty` senza spinlock né log del driver: il valore è già
+    // convertito in `stage` e la chiamata può stare in una sezione critica
+    ledc_ll_set_duty_int_part(&LEDC, LEDC_LOW_SPEED_MODE, channel, staged_duty);
+    ledc_ll_set_duty_direction(&LEDC, LEDC_LOW_SPEED_MODE, channel, LEDC_DUTY_DIR_INCREASE);
+    ledc_ll_set_duty_num(&LEDC, LEDC_LOW_SPEED_MODE, channel, 1);
+    ledc_ll_set_duty_cycle(&LEDC, LEDC_LOW_SPEED_MODE, channel, 1);
+    ledc_ll_set_duty_scale(&LEDC, LEDC_LOW_SPEED_MODE, channel, 0);
+    applied_duty = staged_duty;
+}
+
+void Actuator::latch()
+{
+    // Il nuovo duty viene caricato dall'hardware solo alla fine del periodo in corso,
+    // quindi l'impulso non viene mai troncato a metà (registri come `ledc_update_duty`)
+    if (!valid || dshot != nullptr)
+        return;
+    ledc_ll_set_sig_out_en(&LEDC, LEDC_LOW_SPEED_MODE, channel, true);
+    ledc_ll_set_duty_start(&LEDC, LEDC_LOW_SPEED_MODE, channel, true);
+    ledc_ll_ls_channel_update(&LEDC, LEDC_LOW_SPEED_MODE, channel);
+}
+
+void Actuator::write_pwm(int pwm_value)
+{
+    if (stage(pwm_value))
+    {
+        apply();
+        latch();
+    }
+}
+
 void Actuator::write(double value)
 {
-    int pwm_value = digital_to_pwm(value, digital_min, digital_max, pwm_min, pwm_max);
-    actuator.writeMicroseconds(pwm_value);
-}
\ No newline at end of file
+    // Converte il valore digitale in PWM con il fattore precalcolato, rispettando i limiti configurati
+    int pwm_value = clamp(static_cast<int>((float)(value - digital_min) * pwm_per_unit) + pwm_min, pwm_min, pwm_max);
+    write_pwm(pwm_value);
+}
+
+bool Actuator::read_rpm(float &rpm) const
+{
+    uint32_t erpm;
+    if (dshot == nullptr || !dshot->get_erpm(erpm))
+        return false;
+
+    // eRPM = RPM * coppie polari
+    rpm = erpm / (MOTOR_POLES / 2.0f);
+    return true;
+}
@@ -1,16 +1,33 @@
 #include "Aircraft.h"
-#include "pins.h"
+#include "AirframeConfig.h"
 #include "Logger.h"
+#include "Blackbox.h"
+#include "TelemetryChannelTable.h"
 
 bool imu_read = false, receiver_read = false;
 
+using Airframe = ActiveAirframe::profile; ///< Profilo di velivolo selezionato.
+
+/**
+ * Costruisce un attuatore dalla sua configurazione: con DShot sui canali RMT, altrimenti su
+ * canale e timer LEDC.
+ */
+static Actuator make_actuator(const ActuatorConfig &config)
+{
+    if (config.dshot())
+        return Actuator(config.pin, config.rmt, config.protocol, config.pwm.min, config.pwm.max, config.pwm_null, config.digital.min, config.digital.max);
+    return Actuator(config.pin, config.channel, config.timer, config.protocol, config.pwm.min, config.pwm.max, config.pwm_null, config.digital.min, config.digital.max);
+}
+
 // Costruttore della classe Aircraft
-Aircraft::Aircraft() : esc(ESC_PIN, PWM_MIN, PWM_MAX, PWM_MIN, THROTTLE_MIN, THROTTLE_MAX),
-                       servo_x(SERVO_PIN_X, PWM_MIN_SERVO, PWM_MAX_SERVO, PWM_NEUTRAL_SERVO, ROLL_MIN, ROLL_MAX),
-                       servo_y(SERVO_PIN_Y, PWM_MIN_SERVO, PWM_MAX_SERVO, PWM_NEUTRAL_SERVO, PITCH_MIN, PITCH_MAX),
-                       servo_z(SERVO_PIN_Z, PWM_MIN_SERVO, PWM_MAX_SERVO, PWM_NEUTRAL_SERVO, VRA_MIN, VRA_MAX),
+Aircraft::Aircraft() : esc(make_actuator(ActiveAirframe::esc)),
+                       servo_x(make_actuator(ActiveAirframe::servo_x)),
+                       servo_y(make_actuator(ActiveAirframe::servo_y)),
+                       servo_z(make_actuator(ActiveAirframe::servo_z)),
+                       mixer(ActiveAirframe::mixer),
+                       output_stage(servo_x, servo_y, servo_z, esc),
                        imu(),
-                       receiver(IBUS_RX_PIN),
+                       receiver(Airframe::receiver_pin),
                        led_red(LED_PIN_RED),
                        led_green(LED_PIN_GREEN),
                        led_rgb(LED_PIN_RGB_RED, LED_PIN_RGB_GREEN, LED_PIN_RGB_BLUE)
@@ -18,6 +35,8 @@ Aircraft::Aircraft() : esc(ESC_PIN, PWM_MIN, PWM_MAX, PWM_MIN, THROTTLE_MIN, THR
 {
     // Inizializza i dati del sistema
     receiver_data = {0};
+    esc_data = {0, false};
+    register_telemetry_channels();
     Logger::getInstance().log(LogLevel::INFO, "Aircraft setup complete.");
     led_green.set_state(LED_STATE::ON);
     led_red.set_state(BLINK_ON, BLINK_OFF);
@@ -69,6 +88,9 @@ void Aircraft::update_leds(ASSIST_MODE assist_mode, CONTROLLER_STATE state)
     case ASSIST_MODE::ATTITUDE_CONTROL:
         led_rgb.set_state(LED_STATE::ON, COLOR::PURPLE); // Imposta il colore viola
         break;
+    case ASSIST_MODE::LQR_CONTROL:
+        led_rgb.set_state(LED_STATE::ON, COLOR::LIGHT_BLUE); // Imposta il colore blu chiaro
+        break;
     }
 
     // Aggiorna lo stato dei LED in base allo stato del controller
@@ -99,24 +121,67 @@ void Aircraft::update_leds(ASSIST_MODE assist_mode, CONTROLLER_STATE state)
 
 void Aircraft::write_actuators()
 {
-    // Scrive i valori sugli attuatori
-    servo_x.write(output.x);
-    servo_y.write(output.y);
-    servo_z.write(output.z);
-    esc.write(output.throttle);
+    // Miscela gli output e scrive i valori sugli attuatori
+    int pwm[MIXER_OUTPUTS];
+    mixer.mix(output, pwm);
+
+    output_stage.stage(pwm);
+    output_stage.commit();
+
+    // Aggiorna la telemetria dell'ESC (risposta al frame precedente)
+    esc_data.valid = esc.read_rpm(esc_data.rpm);
+}
+
+TelemetryRecord Aircraft::make_telemetry_record() const
+{
+    // Record a layout fisso riempito per copia: la conversione avviene fuori dal ciclo di controllo
+    TelemetryRecord record;
+    record.timestamp_us = micros();
+    record.cycle = 0; // Assegnato da chi registra il record
+    record.imu = imu_data;
+    record.receiver = receiver_data;
+    record.output = output;
+    record.rpm = esc_data.rpm;
+    record.flags = (imu_read ? TELEMETRY_IMU_VALID : 0) |
+                   (receiver_read ? TELEMETRY_RECEIVER_VALID : 0) |
+                   (esc.has_telemetry() ? TELEMETRY_RPM_VALID : 0);
+    return record;
 }
 
 void Aircraft::update_data_logger()
 {
-    if (imu_read)
-        imu.logData(imu_data);
-    if (receiver_read)
-        receiver.logData(receiver_data);
     // Aggiorna il logger dei dati
     if (imu_read || receiver_read) // Andrà cambiato con && o rivisto
     {
-        Logger::getInstance().prepareDataBuffer(); // Organizza e salva i dati del ciclo
-        Logger::getInstance().sendDataToServer();  // Invia i dati (se necessario)
-        Logger::getInstance().incrementCycle();    // Passa al ciclo successivo
+        Logger::getInstance().logData(make_telemetry_record()); // Copia il record nel buffer circolare
+        Logger::getInstance().incrementCycle();                 // Passa al ciclo successivo
     }
+}
+
+void Aircraft::register_telemetry_channels()
+{
+    TelemetryChannels &registry = Logger::getInstance().getChannels();
+    for (size_t i = 0; i < TELEMETRY_CHANNEL_TABLE_SIZE; ++i)
+    {
+        const TelemetryChannelSpec &channel = TELEMETRY_CHANNEL_TABLE[i];
+        if (registry.add(channel.name, channel.offset, channel.type, TELEMETRY_CHANNEL_DECIMALS, channel.divider) < 0)
+            Logger::getInstance().logEvent<LOG_ID::TELEMETRY_CHANNEL_REJECTED>(static_cast<uint32_t>(i));
+    }
+}
+
+void Aircraft::update_blackbox(CONTROLLER_STATE state, ASSIST_MODE assist_mode, CONTROLLER_MODE controller_mode, const Errors &error, uint32_t cycle_start_us)
+{
+    // Ogni ciclo, anche senza letture nuove: i flag del record indicano quali dati sono freschi
+    BlackboxRecord record;
+    record.telemetry = make_telemetry_record();
+    record.telemetry.timestamp_us = cycle_start_us;
+    record.loop_us = micros() - cycle_start_us;
+    record.dropped = 0; // Assegnato dal blackbox
+    record.state = static_cast<int8_t>(state);
+    record.assist_mode = static_cast<uint8_t>(assist_mode);
+    record.controller_mode = static_cast<uint8_t>(controller_mode);
+    record.errors = (error.RECEIVER_ERROR ? BLACKBOX_RECEIVER_ERROR : 0) |
+                    (error.IMU_ERROR ? BLACKBOX_IMU_ERROR : 0);
+
+    Blackbox::getInstance().record(record);
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "AxisPID3.h"
+#include "Logger.h"
+#include <cmath>
+
+template <typename T>
+static inline T clamp_symmetric(T value, T limit)
+{
+    return (value > limit) ? limit : (value < -limit) ? -limit
+                                                      : value;
+}
+
+template <typename T>
+AxisPID3<T>::AxisPID3(const AxisGains3<T> &gains, T maxIntegral, T outputLimit)
+    : gains(gains), maxIntegral(maxIntegral), outputLimit(outputLimit)
+{
+    // Il padding non deve contribuire al calcolo
+    this->gains.kp[AXIS_PID_LANES - 1] = 0;
+    this->gains.ki[AXIS_PID_LANES - 1] = 0;
+    this->gains.kd[AXIS_PID_LANES - 1] = 0;
+    this->gains.kf[AXIS_PID_LANES - 1] = 0;
+
+    for (int i = 0; i < AXIS_PID_LANES; ++i)
+        scale.kp[i] = scale.ki[i] = scale.kd[i] = scale.kf[i] = 1;
+
+#if PID_DTERM_FILTER == PID_DTERM_FILTER_BIQUAD
+    // Passa-basso Butterworth (Q = 1/sqrt(2)) alla frequenza nominale del loop
+    const double w0 = 2.0 * M_PI * PID_DTERM_CUTOFF_HZ / PID_DTERM_SAMPLE_HZ;
+    const double alpha = std::sin(w0) / (2.0 * M_SQRT1_2);
+    const double cs = std::cos(w0);
+    const double a0 = 1.0 + alpha;
+    b0 = static_cast<T>((1.0 - cs) / 2.0 / a0);
+    b1 = static_cast<T>((1.0 - cs) / a0);
+    b2 = b0;
+    a1 = static_cast<T>(-2.0 * cs / a0);
+    a2 = static_cast<T>((1.0 - alpha) / a0);
+#endif
+
+    reset();
+    Logger::getInstance().log(LogLevel::INFO, "3-axis PID controller initialized.");
+}
+
+template <typename T>
+void AxisPID3<T>::reset()
+{
+    for (int i = 0; i < AXIS_PID_LANES; ++i)
+    {
+        integral[i] = 0;
+#if PID_D_ON_MEASUREMENT
+        lastMeasurement[i] = 0;
+#else
+        lastError[i] = 0;
+#endif
+#if PID_DTERM_FILTER == PID_DTERM_FILTER_PT1
+        dtermState[i] = 0;
+#elif PID_DTERM_FILTER == PID_DTERM_FILTER_BIQUAD
+        dtermX1[i] = dtermX2[i] = dtermY1[i] = dtermY2[i] = 0;
+#endif
+    }
+}
+
+template <typename T>
+void AxisPID3<T>::set_gain_scale(const float kp[3], const float ki[3], const float kd[3])
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        scale.kp[i] = kp[i];
+        scale.ki[i] = ki[i];
+        scale.kd[i] = kd[i];
+    }
+}
+
+template <typename T>
+void AxisPID3<T>::transfer(const T error[3], const T measurement[3], const T setpoint[3],
+                           const AxisGains3<T> &offsets, const T output[3])
+{
+    reset();
+
+    for (int i = 0; i < 3; ++i)
+    {
+#if PID_D_ON_MEASUREMENT
+        lastMeasurement[i] = measurement[i];
+#else
+        (void)measurement;
+        lastError[i] = error[i];
+#endif
+
+#if PID_BUMPLESS_TRANSFER
+        // Integrale tale che P + I + FF riproduca l'output applicato finora
+        T ki = (gains.ki[i] + offsets.ki[i]) * scale.ki[i];
+        if (ki == 0)
+            continue;
+        T residual = output[i] - (gains.kp[i] + offsets.kp[i]) * scale.kp[i] * error[i];
+#if PID_FEEDFORWARD
+        residual -= (gains.kf[i] + offsets.kf[i]) * setpoint[i];
+#else
+        (void)setpoint;
+#endif
+        integral[i] = clamp_symmetric(residual / ki, maxIntegral);
+#else
+        (void)setpoint;
+        (void)offsets;
+        (void)output;
+#endif
+    }
+}
+
+template <typename T>
+void AxisPID3<T>::update(const T error[3], const T measurement[3], const T setpoint[3], T dt, T inv_dt,
+                         const AxisGains3<T> &offsets, T output[3])
+{
+    compute<false>(error, measurement, setpoint, dt, inv_dt, offsets, output);
+}
+
+template <typename T>
+void AxisPID3<T>::update_rate(const T error[3], const T error_rate[3], const T setpoint[3], T dt, T inv_dt,
+                              const AxisGains3<T> &offsets, T output[3])
+{
+#if PID_D_ON_MEASUREMENT
+    compute<true>(error, error_rate, setpoint, dt, inv_dt, offsets, output);
+#else
+    (void)error_rate;
+    compute<false>(error, error, setpoint, dt, inv_dt, offsets, output);
+#endif
+}
+
+template <typename T>
+template <bool KnownRate>
+inline void AxisPID3<T>::compute(const T error[3], const T source[3], const T setpoint[3], T dt, T inv_dt,
+                                 const AxisGains3<T> &offsets, T output[3])
+{
+    // Gli ingressi vengono letti direttamente: copiarli in array di lane per vettorizzare
+    // costa più del calcolo (store-forwarding fallito tra scritture scalari e letture vettoriali)
+    const T *e = error;
+    const T *sp = setpoint;
+    T *u = output;
+
+#if PID_DTERM_FILTER == PID_DTERM_FILTER_PT1
+    // Coefficiente del PT1 calcolato una volta per tutti gli assi
+    const T rc = static_cast<T>(1.0 / (2.0 * M_PI * PID_DTERM_CUTOFF_HZ));
+    const T k = dt / (rc + dt);
+#endif
+
+    for (int i = 0; i < 3; ++i)
+    {
+        // Calcolo del termine derivativo (senza divisioni)
+        T derivative;
+        if (KnownRate)
+        {
+            derivative = source[i];
+        }
+        else
+        {
+#if PID_D_ON_MEASUREMENT
+            derivative = (lastMeasurement[i] - source[i]) * inv_dt;
+            lastMeasurement[i] = source[i];
+#else
+            derivative = (e[i] - lastError[i]) * inv_dt;
+            lastError[i] = e[i];
+#endif
+        }
+
+#if PID_DTERM_FILTER == PID_DTERM_FILTER_PT1
+        dtermState[i] += k * (derivative - dtermState[i]);
+        derivative = dtermState[i];
+#elif PID_DTERM_FILTER == PID_DTERM_FILTER_BIQUAD
+        T filtered = b0 * derivative + b1 * dtermX1[i] + b2 * dtermX2[i] - a1 * dtermY1[i] - a2 * dtermY2[i];
+        dtermX2[i] = dtermX1[i];
+        dtermX1[i] = derivative;
+        dtermY2[i] = dtermY1[i];
+        dtermY1[i] = filtered;
+        derivative = filtered;
+#endif
+
+        T feedforward = 0;
+#if PID_FEEDFORWARD
+        feedforward = (gains.kf[i] + offsets.kf[i]) * sp[i];
+#else
+        (void)sp;
+#endif
+
+        const T kp = (gains.kp[i] + offsets.kp[i]) * scale.kp[i];
+        const T ki = (gains.ki[i] + offsets.ki[i]) * scale.ki[i];
+        const T kd = (gains.kd[i] + offsets.kd[i]) * scale.kd[i];
+
+#if PID_ANTIWINDUP_BACKCALC
+        // L'integrale viene aggiornato dopo il calcolo dell'output, retroazionando la saturazione
+        T unsaturated = kp * e[i] + ki * integral[i] + kd * derivative + feedforward;
+        T saturated = clamp_symmetric(unsaturated, outputLimit);
+        T integ = integral[i] + (e[i] + static_cast<T>(PID_BACKCALC_GAIN) * (saturated - unsaturated)) * dt;
+        integral[i] = clamp_symmetric(integ, maxIntegral);
+        u[i] = saturated;
+#else
+        // Calcolo del termine integrale con limitazione
+        T integ = clamp_symmetric(integral[i] + e[i] * dt, maxIntegral);
+        integral[i] = integ;
+
+        // Calcolo del valore di controllo PID
+        u[i] = kp * e[i] + ki * integ + kd * derivative + feedforward;
+#endif
+    }
+}
+
+// Istanziazioni esplicite: float per il target, double come riferimento
+template class AxisPID3<float>;
+template class AxisPID3<double>;
@@ -0,0 +1,389 @@
+#include "Blackbox.h"
+#include "Logger.h"
+#include "SerialCommands.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const char blockMagic[4] = {'B', 'B', 'X', '1'};
+
+// CRC-32 (polinomio riflesso 0xEDB88320, come zlib), aggiornabile a pezzi
+static uint32_t crc32_update(uint32_t crc, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+    while (size--)
+    {
+        crc ^= *bytes++;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+// Verifica che un buffer contenga solo byte cancellati (0xFF)
+static bool is_blank(const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        if (data[i] != 0xFF)
+            return false;
+    return true;
+}
+
+Blackbox::Blackbox()
+{
+    // Costruttore vuoto
+}
+
+Blackbox &Blackbox::getInstance()
+{
+    static Blackbox instance;
+    return instance;
+}
+
+bool Blackbox::begin()
+{
+    available = storage.begin(BLACKBOX_STORAGE, BLACKBOX_HOST_SIZE) && storage.size() >= BLACKBOX_BLOCK_SIZE;
+    if (!available)
+    {
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_NOT_AVAILABLE>();
+        return false;
+    }
+
+    scan();
+    if (!available)
+    {
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_READ_FAILED>();
+        return false;
+    }
+    Logger::getInstance().logEvent<LOG_ID::BLACKBOX_STATUS>(static_cast<uint32_t>(stats.used / 1024),
+                                                            static_cast<uint32_t>(storage.size() / 1024), stats.session);
+    return true;
+}
+
+void Blackbox::startBlackboxTask()
+{
+    // Il comando resta disponibile anche senza memoria, per segnalarne l'assenza
+    const bool ready = begin();
+    SerialCommands::getInstance().add("blackbox", handleCommand, this);
+    if (!ready)
+        return;
+
+    xTaskCreatePinnedToCore(
+        blackboxTask,   // Funzione del task
+        "BlackboxTask", // Nome del task
+        4096,           // Dimensione dello stack
+        this,           // Parametro passato al task
+        1,              // Priorità del task
+        nullptr,        // Handle del task
+        1               // Core su cui eseguire il task
+    );
+}
+
+void Blackbox::record(const BlackboxRecord &record)
+{
+    if (!available)
+        return;
+
+    // Registra da armati e nel ciclo del disarmo, che chiude la sessione
+    const bool active = record.state == static_cast<int8_t>(CONTROLLER_STATE::ARMED);
+    if (!active && !recording)
+        return;
+    if (!recording)
+        cycle = 0; // Nuova sessione
+
+    BlackboxRecord entry = record;
+    entry.telemetry.cycle = cycle++;
+    entry.dropped = queue.getDropped();
+    queue.push(entry);
+
+    recording = active;
+    armed.store(active, std::memory_order_relaxed);
+}
+
+void Blackbox::update()
+{
+    const BlackboxRecord *record;
+    while ((record = queue.front()) != nullptr)
+    {
+        // Il ciclo 0 apre una sessione nuova anche se il record di disarmo è andato perso
+        if (sessionActive && record->telemetry.cycle == 0)
+            endSession();
+        if (!sessionActive)
+            startSession();
+
+        if (blockCount == BLACKBOX_RECORDS_PER_BLOCK)
+        {
+            closeBlock();
+            openBlock();
+        }
+
+        // Si scrive solo su settori già cancellati: durante il volo la flash non viene mai cancellata
+        if (writeOffset + BLACKBOX_BLOCK_SIZE <= stats.prepared)
+        {
+            memcpy(block + (blockCount + 1) * sizeof(BlackboxRecord), record, sizeof(BlackboxRecord));
+            blockCrc = crc32_update(blockCrc, record, sizeof(BlackboxRecord));
+            blockCount++;
+            sessionRecords++;
+            stats.records++;
+        }
+        else
+        {
+            stats.lost++;
+        }
+
+        const bool closing = record->state != static_cast<int8_t>(CONTROLLER_STATE::ARMED);
+        queue.pop();
+        if (closing)
+            endSession();
+    }
+
+    if (sessionActive)
+    {
+        flush(false);
+        return;
+    }
+
+    prepare();
+    runCommands();
+}
+
+void Blackbox::scan()
+{
+    stats.session = 0;
+    writeOffset = storage.size();
+
+    for (size_t offset = 0; offset + BLACKBOX_BLOCK_SIZE <= storage.size(); offset += BLACKBOX_BLOCK_SIZE)
+    {
+        // Primo slot (header) e inizio del primo record
+        uint8_t head[sizeof(BlackboxRecord) + 8];
+        if (!storage.read(offset, head, sizeof(head)))
+        {
+            available = false; // Senza conoscere il contenuto non si cancella nulla
+            return;
+        }
+
+        BlackboxBlockHeader header;
+        memcpy(&header, head, sizeof(header));
+        if (memcmp(header.magic, blockMagic, sizeof(blockMagic)) == 0)
+        {
+            if (header.session > stats.session)
+                stats.session = header.session;
+            continue;
+        }
+
+        // Header cancellato: blocco libero, o interrotto se contiene record
+        const bool headerBlank = is_blank(head, sizeof(BlackboxRecord));
+        if (!headerBlank || is_blank(head + sizeof(BlackboxRecord), 8))
+        {
+            writeOffset = offset; // Dati estranei o blocco libero: la preparazione li cancella
+            break;
+        }
+
+        if (!storage.read(offset, block, BLACKBOX_BLOCK_SIZE))
+        {
+            available = false;
+            return;
+        }
+        uint16_t count = 0;
+        while (count < BLACKBOX_RECORDS_PER_BLOCK &&
+               !is_blank(block + (count + 1) * sizeof(BlackboxRecord), sizeof(BlackboxRecord)))
+            count++;
+
+        BlackboxRecord first;
+        memcpy(&first, block + sizeof(BlackboxRecord), sizeof(first));
+        if (first.telemetry.cycle == 0 || stats.session == 0)
+            stats.session++;
+
+        header = {{'B', 'B', 'X', '1'}, stats.session, count, sizeof(BlackboxRecord),
+                  crc32_update(0, block + sizeof(BlackboxRecord), count * sizeof(BlackboxRecord)),
+                  BLACKBOX_BLOCK_RECOVERED};
+        if (!storage.write(offset, &header, sizeof(header)))
+            stats.errors++;
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_RECOVERED>(count);
+    }
+
+    stats.used = writeOffset;
+    stats.prepared = writeOffset;
+}
+
+void Blackbox::startSession()
+{
+    // I comandi arrivati poco prima dell'armamento non vengono eseguiti al disarmo
+    if (pendingCommands.exchange(0, std::memory_order_relaxed) != 0)
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_BUSY>();
+
+    stats.session++;
+    sessionRecords = 0;
+    sessionActive = true;
+    openBlock();
+}
+
+void Blackbox::endSession()
+{
+    closeBlock();
+    sessionActive = false;
+    Logger::getInstance().logEvent<LOG_ID::BLACKBOX_SESSION_CLOSED>(stats.session, sessionRecords, stats.lost,
+                                                                    queue.getDropped());
+}
+
+void Blackbox::openBlock()
+{
+    memset(block, 0xFF, sizeof(block));
+    blockCount = 0;
+    blockCrc = 0;
+    flushed = sizeof(BlackboxRecord); // Lo slot dell'header viene scritto alla chiusura
+}
+
+void Blackbox::flush(bool close)
+{
+    if (blockCount == 0)
+        return;
+
+    // Solo pagine complete, tranne alla chiusura del blocco
+    size_t end = (blockCount + 1) * sizeof(BlackboxRecord);
+    if (!close)
+        end -= end % BLACKBOX_PAGE_SIZE;
+    if (end <= flushed)
+        return;
+
+    if (!storage.write(writeOffset + flushed, block + flushed, end - flushed))
+        stats.errors++;
+    flushed = end;
+}
+
+void Blackbox::closeBlock()
+{
+    if (blockCount == 0)
+        return;
+
+    flush(true);
+
+    BlackboxBlockHeader header = {{'B', 'B', 'X', '1'}, stats.session, blockCount, sizeof(BlackboxRecord),
+                                  blockCrc, 0};
+    if (!storage.write(writeOffset, &header, sizeof(header)))
+        stats.errors++;
+
+    stats.blocks++;
+    writeOffset += BLACKBOX_BLOCK_SIZE;
+    stats.used = writeOffset;
+    blockCount = 0;
+}
+
+bool Blackbox::isErased(size_t offset, size_t size)
+{
+    // Il buffer del blocco è libero fuori dalle sessioni
+    for (size_t done = 0; done < size; done += sizeof(block))
+    {
+        const size_t n = size - done < sizeof(block) ? size - done : sizeof(block);
+        if (!storage.read(offset + done, block, n) || !is_blank(block, n))
+            return false;
+    }
+    return true;
+}
+
+void Blackbox::prepare()
+{
+    // Verifica i settori successivi e ne cancella al massimo uno per iterazione:
+    // la cancellazione blocca la flash per decine di millisecondi
+    for (int i = 0; i < BLACKBOX_PREPARE_SECTORS && stats.prepared < storage.size(); ++i)
+    {
+        if (armed.load(std::memory_order_relaxed))
+            return;
+
+        if (isErased(stats.prepared, BLACKBOX_SECTOR_SIZE))
+        {
+            stats.prepared += BLACKBOX_SECTOR_SIZE;
+            continue;
+        }
+
+        if (!storage.erase(stats.prepared, BLACKBOX_SECTOR_SIZE))
+        {
+            stats.errors++;
+            return;
+        }
+        stats.prepared += BLACKBOX_SECTOR_SIZE;
+        return;
+    }
+}
+
+bool Blackbox::handleCommand(void *context, const char *arguments)
+{
+    Blackbox *blackbox = static_cast<Blackbox *>(context);
+
+    uint8_t command;
+    if (strcmp(arguments, "dump") == 0)
+        command = BLACKBOX_COMMAND_DUMP;
+    else if (strcmp(arguments, "erase") == 0)
+        command = BLACKBOX_COMMAND_ERASE;
+    else if (strcmp(arguments, "info") == 0)
+        command = BLACKBOX_COMMAND_INFO;
+    else
+        return false;
+
+    if (!blackbox->available)
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_NOT_AVAILABLE>();
+    else if (blackbox->armed.load(std::memory_order_relaxed))
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_BUSY>();
+    else
+        blackbox->pendingCommands.fetch_or(command, std::memory_order_relaxed);
+    return true;
+}
+
+void Blackbox::runCommands()
+{
+    // Nell'ordine: informazioni e dump descrivono la memoria prima di un'eventuale cancellazione
+    const uint8_t commands = pendingCommands.exchange(0, std::memory_order_relaxed);
+    if (commands & BLACKBOX_COMMAND_INFO)
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_INFO>(
+            static_cast<uint32_t>(stats.used / 1024), static_cast<uint32_t>(stats.prepared / 1024),
+            static_cast<uint32_t>(storage.size() / 1024), stats.records, stats.errors);
+    if (commands & BLACKBOX_COMMAND_DUMP)
+        dump();
+    if (commands & BLACKBOX_COMMAND_ERASE)
+    {
+        // La cancellazione procede in background da disarmati
+        writeOffset = 0;
+        stats.used = 0;
+        stats.prepared = 0;
+        Logger::getInstance().logEvent<LOG_ID::BLACKBOX_ERASE_STARTED>();
+    }
+}
+
+void Blackbox::dump()
+{
+    // Intestazione testuale, blocchi binari così come sono in flash, chiusura testuale; i log
+    // restano in coda fino alla fine, così nessuna riga si intercala con i dati binari
+    Logger &logger = Logger::getInstance();
+    logger.acquireSerial();
+    char line[48];
+    snprintf(line, sizeof(line), "BLACKBOX DUMP %u %u", static_cast<unsigned>(stats.used / BLACKBOX_BLOCK_SIZE),
+             static_cast<unsigned>(BLACKBOX_BLOCK_SIZE));
+    Serial.println(line);
+
+    for (size_t offset = 0; offset < stats.used; offset += BLACKBOX_BLOCK_SIZE)
+    {
+        if (!storage.read(offset, block, BLACKBOX_BLOCK_SIZE))
+        {
+            stats.errors++;
+            break;
+        }
+        Serial.write(block, BLACKBOX_BLOCK_SIZE);
+    }
+
+    Serial.println("BLACKBOX END");
+    logger.releaseSerial();
+}
+
+void Blackbox::blackboxTask(void *param)
+{
+    Blackbox *blackbox = static_cast<Blackbox *>(param);
+
+    while (true)
+    {
+        blackbox->update();
+        vTaskDelay(BLACKBOX_TASK_PERIOD_MS / portTICK_PERIOD_MS);
+    }
+}
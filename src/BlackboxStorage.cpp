@@ -0,0 +1,113 @@
+#include "BlackboxStorage.h"
+#include <string.h>
+
+#ifdef ARDUINO
+
+BlackboxStorage::~BlackboxStorage()
+{
+}
+
+bool BlackboxStorage::begin(const char *name, size_t)
+{
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, name);
+    if (partition == nullptr)
+        return false;
+    capacity = partition->size - partition->size % BLACKBOX_SECTOR_SIZE;
+    return true;
+}
+
+bool BlackboxStorage::read(size_t offset, void *data, size_t size)
+{
+    return partition != nullptr && offset + size <= capacity &&
+           esp_partition_read(partition, offset, data, size) == ESP_OK;
+}
+
+bool BlackboxStorage::write(size_t offset, const void *data, size_t size)
+{
+    return partition != nullptr && offset + size <= capacity &&
+           esp_partition_write(partition, offset, data, size) == ESP_OK;
+}
+
+bool BlackboxStorage::erase(size_t offset, size_t size)
+{
+    return partition != nullptr && offset + size <= capacity &&
+           esp_partition_erase_range(partition, offset, size) == ESP_OK;
+}
+
+#else
+
+BlackboxStorage::~BlackboxStorage()
+{
+    if (file != nullptr)
+        fclose(file);
+}
+
+bool BlackboxStorage::begin(const char *name, size_t size)
+{
+    file = fopen(name, "r+b");
+    if (file == nullptr)
+    {
+        // Nuovo file: contenuto di una flash appena cancellata
+        file = fopen(name, "w+b");
+        if (file == nullptr)
+            return false;
+        uint8_t erased[BLACKBOX_SECTOR_SIZE];
+        memset(erased, 0xFF, sizeof(erased));
+        for (size_t i = 0; i < size / BLACKBOX_SECTOR_SIZE; ++i)
+            fwrite(erased, 1, sizeof(erased), file);
+        fflush(file);
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    capacity = length > 0 ? static_cast<size_t>(length) - static_cast<size_t>(length) % BLACKBOX_SECTOR_SIZE : 0;
+    return true;
+}
+
+bool BlackboxStorage::read(size_t offset, void *data, size_t size)
+{
+    if (file == nullptr || offset + size > capacity)
+        return false;
+    fseek(file, static_cast<long>(offset), SEEK_SET);
+    return fread(data, 1, size, file) == size;
+}
+
+bool BlackboxStorage::write(size_t offset, const void *data, size_t size)
+{
+    if (file == nullptr || offset + size > capacity)
+        return false;
+
+    // Come sulla flash NOR la scrittura può solo azzerare bit
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint8_t chunk[BLACKBOX_PAGE_SIZE];
+    for (size_t done = 0; done < size;)
+    {
+        const size_t n = size - done < sizeof(chunk) ? size - done : sizeof(chunk);
+        if (!read(offset + done, chunk, n))
+            return false;
+        for (size_t i = 0; i < n; ++i)
+            chunk[i] &= bytes[done + i];
+        fseek(file, static_cast<long>(offset + done), SEEK_SET);
+        if (fwrite(chunk, 1, n, file) != n)
+            return false;
+        done += n;
+    }
+    return fflush(file) == 0;
+}
+
+bool BlackboxStorage::erase(size_t offset, size_t size)
+{
+    if (file == nullptr || offset % BLACKBOX_SECTOR_SIZE != 0 || size % BLACKBOX_SECTOR_SIZE != 0 ||
+        offset + size > capacity)
+        return false;
+
+    uint8_t erased[BLACKBOX_SECTOR_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    fseek(file, static_cast<long>(offset), SEEK_SET);
+    for (size_t i = 0; i < size / BLACKBOX_SECTOR_SIZE; ++i)
+        if (fwrite(erased, 1, sizeof(erased), file) != sizeof(erased))
+            return false;
+    return fflush(file) == 0;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include "DShotESC.h"
+#include "Logger.h"
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <freertos/ringbuf.h>
+
+static const uint8_t RMT_CLK_DIV = 1;          ///< Divisore del clock RMT (80 MHz, 12.5 ns per tick).
+static const uint32_t RMT_TICKS_PER_US = 80;   ///< Tick RMT per microsecondo.
+static const uint8_t RX_FILTER_TICKS = 10;     ///< Soglia del filtro anti-glitch in ricezione (tick).
+static const uint16_t RX_IDLE_BITS = 30;       ///< Bit di inattività che chiudono una risposta.
+
+DShotESC::DShotESC(int pin, int tx_channel, int rx_channel, ACTUATOR_PROTOCOL protocol, bool bidirectional)
+    : pin(pin),
+      tx_channel(static_cast<rmt_channel_t>(tx_channel)),
+      rx_channel(static_cast<rmt_channel_t>(rx_channel)),
+      bidirectional(bidirectional),
+      rx_buffer(nullptr)
+{
+    // Temporizzazioni del frame: T1H = 3/4 del bit, T0H = 3/8 del bit
+    uint32_t bitrate_kbps = (protocol == ACTUATOR_PROTOCOL::DSHOT300) ? 300 : 600;
+    bit_ticks = RMT_TICKS_PER_US * 1000 / bitrate_kbps;
+    t1h = bit_ticks * 3 / 4;
+    t0h = bit_ticks * 3 / 8;
+    // La risposta di telemetria viaggia a 5/4 del bitrate di comando
+    telemetry_bit_ticks = bit_ticks * 4 / 5;
+
+    items[DSHOT_FRAME_BITS] = {}; // Terminatore del frame
+
+    rmt_config_t tx_config = {};
+    tx_config.rmt_mode = RMT_MODE_TX;
+    tx_config.channel = this->tx_channel;
+    tx_config.gpio_num = pin;
+    tx_config.clk_div = RMT_CLK_DIV;
+    tx_config.mem_block_num = 1;
+    tx_config.tx_config.loop_en = false;
+    tx_config.tx_config.carrier_en = false;
+    tx_config.tx_config.idle_output_en = true;
+    // In modalità bidirezionale il segnale è invertito: la linea a riposo è alta
+    tx_config.tx_config.idle_level = bidirectional ? RMT_IDLE_LEVEL_HIGH : RMT_IDLE_LEVEL_LOW;
+
+    if (rmt_config(&tx_config) != ESP_OK || rmt_driver_install(this->tx_channel, 0, 0) != ESP_OK)
+    {
+        Logger::getInstance().log(LogLevel::ERROR, "DShot TX setup failed!");
+        return;
+    }
+
+    if (bidirectional)
+    {
+        rmt_config_t rx_config = {};
+        rx_config.rmt_mode = RMT_MODE_RX;
+        rx_config.channel = this->rx_channel;
+        rx_config.gpio_num = pin;
+        rx_config.clk_div = RMT_CLK_DIV;
+        rx_config.mem_block_num = 1;
+        rx_config.rx_config.filter_en = true;
+        rx_config.rx_config.filter_ticks_thresh = RX_FILTER_TICKS;
+        rx_config.rx_config.idle_threshold = telemetry_bit_ticks * RX_IDLE_BITS;
+
+        if (rmt_config(&rx_config) != ESP_OK ||
+            rmt_driver_install(this->rx_channel, 256, 0) != ESP_OK ||
+            rmt_get_ringbuf_handle(this->rx_channel, &rx_buffer) != ESP_OK)
+        {
+            Logger::getInstance().log(LogLevel::ERROR, "DShot RX setup failed! Telemetry disabled.");
+            this->bidirectional = false;
+        }
+        else
+        {
+            // TX e RX condividono il pin: open-drain con pull-up, l'ESC risponde portando la linea bassa
+            gpio_set_direction(static_cast<gpio_num_t>(pin), GPIO_MODE_INPUT_OUTPUT_OD);
+            gpio_set_pull_mode(static_cast<gpio_num_t>(pin), GPIO_PULLUP_ONLY);
+        }
+    }
+
+    Logger::getInstance().log(LogLevel::INFO, "DShot ESC setup complete.");
+}
+
+void DShotESC::read_telemetry()
+{
+    if (!rx_active)
+        return;
+
+    size_t length = 0;
+    rmt_item32_t *rx_items = static_cast<rmt_item32_t *>(xRingbufferReceive(rx_buffer, &length, 0));
+    telemetry_valid = false;
+
+    if (rx_items != nullptr)
+    {
+        // Estrae le durate dei livelli fino al terminatore
+        uint32_t durations[DSHOT_TELEMETRY_BITS];
+        size_t count = 0;
+        size_t item_count = length / sizeof(rmt_item32_t);
+        for (size_t i = 0; i < item_count && count < DSHOT_TELEMETRY_BITS; ++i)
+        {
+            if (rx_items[i].duration0 == 0)
+                break;
+            durations[count++] = rx_items[i].duration0;
+            if (rx_items[i].duration1 == 0 || count >= DSHOT_TELEMETRY_BITS)
+                break;
+            durations[count++] = rx_items[i].duration1;
+        }
+        vRingbufferReturnItem(rx_buffer, rx_items);
+
+        uint32_t raw;
+        if (dshot_decode_runs(durations, count, telemetry_bit_ticks, raw))
+        {
+            uint32_t value = dshot_decode_erpm(raw);
+            if (value != DSHOT_ERPM_INVALID)
+            {
+                erpm = value;
+                telemetry_valid = true;
+            }
+        }
+    }
+
+    rmt_rx_stop(rx_channel);
+    rx_active = false;
+}
+
+void DShotESC::write(uint16_t value)
+{
+    // La risposta al frame precedente deve essere letta prima di trasmettere,
+    // altrimenti il ricevitore catturerebbe il nuovo frame
+    if (bidirectional)
+        read_telemetry();
+
+    uint16_t frame = dshot_make_frame(value, false, bidirectional);
+    uint32_t active = bidirectional ? 0 : 1;
+
+    for (int i = 0; i < DSHOT_FRAME_BITS; ++i)
+    {
+        bool bit = (frame >> (DSHOT_FRAME_BITS - 1 - i)) & 1;
+        uint16_t high = bit ? t1h : t0h;
+        items[i].level0 = active;
+        items[i].duration0 = high;
+        items[i].level1 = !active;
+        items[i].duration1 = bit_ticks - high;
+    }
+
+    // Attende la fine del frame (circa 27 µs in DShot600) per poter avviare la ricezione
+    rmt_write_items(tx_channel, items, DSHOT_FRAME_BITS + 1, bidirectional);
+
+    if (bidirectional)
+    {
+        rmt_rx_start(rx_channel, true);
+        rx_active = true;
+    }
+}
+
+bool DShotESC::get_erpm(uint32_t &erpm) const
+{
+    if (!bidirectional || !telemetry_valid)
+        return false;
+    erpm = this->erpm;
+    return true;
+}
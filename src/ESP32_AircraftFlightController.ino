@@ -3,6 +3,7 @@
 #include "SystemController.h"
 #include "FlightController.h"
 #include "Logger.h"
+#include "Blackbox.h"
 #include "WiFiManager.h"
 
 // Credenziali della rete Wi-Fi
@@ -26,11 +27,15 @@ static const unsigned long loopInterval = 10; ///< Intervallo del loop in millis
 
 void setup()
 {
-    // Inizializzazione del monitor seriale
+    // Inizializzazione del monitor seriale: la trasmissione dei log procede da interrupt
+    Serial.setTxBufferSize(LOG_SERIAL_TX_BUFFER);
     Serial.begin(115200);
 
-    // Inizializzazione del logger
+    // Inizializzazione del logger: setup e loop girano nello stesso task, quello di controllo
+    Logger::getInstance().registerControlTask();
+    Logger::getInstance().allocateBuffers(); // Code verso il server, in PSRAM se presente
     Logger::getInstance().startLogTask();
+    Blackbox::getInstance().startBlackboxTask();
 
     // Inizializzazione delle connessioni
     WiFiManager::getInstance().begin(ssid, password);
@@ -50,7 +55,8 @@ void loop()
     unsigned long t = millis();    // Ottieni il timestamp attuale
     if (t - tPrev >= loopInterval) // Verifica se è passato l'intervallo necessario
     {
-        double dt = (t - tPrev) / 1000.0; // Calcola l'intervallo di tempo in secondi
+        const uint32_t cycleStart = micros(); // Inizio del ciclo, per la durata registrata nel blackbox
+        CONTROL_SCALAR dt = (t - tPrev) / static_cast<CONTROL_SCALAR>(1000); // Calcola l'intervallo di tempo in secondi
         tPrev = t;                        // Aggiorna il timestamp precedente
 
         // Aggiorna i dati del sistema
@@ -71,7 +77,8 @@ void loop()
         aircraft->update_leds(systemController.assist_mode, systemController.state);
         aircraft->write_actuators();
 
-        // Aggiorna il logger
+        // Aggiorna il logger e il blackbox
         aircraft->update_data_logger();
+        aircraft->update_blackbox(systemController.state, systemController.assist_mode, systemController.controller_mode, systemController.error, cycleStart);
     }
 }
@@ -3,28 +3,48 @@
 #include "Logger.h"
 #include <Arduino.h>
 
-FlightController::FlightController(ReceiverData &receiver_data, ImuData &imu_data, Output &output)
-    : pid_attitude_x(KP_ATTITUDE_X, KI_ATTITUDE_X, KD_ATTITUDE_X, MAX_INTEGRAL_ATTITUDE),
-      pid_attitude_y(KP_ATTITUDE_Y, KI_ATTITUDE_Y, KD_ATTITUDE_Y, MAX_INTEGRAL_ATTITUDE),
-      pid_attitude_z(KP_ATTITUDE_Z, KI_ATTITUDE_Z, KD_ATTITUDE_Z, MAX_INTEGRAL_ATTITUDE),
-      pid_gyro_x(KP_GYRO_X, KI_GYRO_X, KD_GYRO_X, MAX_INTEGRAL_GYRO),
-      pid_gyro_y(KP_GYRO_Y, KI_GYRO_Y, KD_GYRO_Y, MAX_INTEGRAL_GYRO),
-      pid_gyro_z(KP_GYRO_Z, KI_GYRO_Z, KD_GYRO_Z, MAX_INTEGRAL_GYRO)
+static const float input_expo[3] = {INPUT_EXPO_X, INPUT_EXPO_Y, INPUT_EXPO_Z}; ///< Expo degli stick per asse.
+static const float input_rate[3] = {INPUT_RATE_X, INPUT_RATE_Y, INPUT_RATE_Z}; ///< Setpoint a stick completo per asse.
+
+template <typename T>
+FlightControllerT<T>::FlightControllerT(ReceiverData &receiver_data, ImuData &imu_data, Output &output)
+    : pid_attitude({{KP_ATTITUDE_X, KP_ATTITUDE_Y, KP_ATTITUDE_Z},
+                    {KI_ATTITUDE_X, KI_ATTITUDE_Y, KI_ATTITUDE_Z},
+                    {KD_ATTITUDE_X, KD_ATTITUDE_Y, KD_ATTITUDE_Z},
+                    {KF_ATTITUDE_X, KF_ATTITUDE_Y, KF_ATTITUDE_Z}},
+                   MAX_INTEGRAL_ATTITUDE, PID_OUTPUT_LIMIT_ATTITUDE),
+      pid_gyro({{KP_GYRO_X, KP_GYRO_Y, KP_GYRO_Z},
+                {KI_GYRO_X, KI_GYRO_Y, KI_GYRO_Z},
+                {KD_GYRO_X, KD_GYRO_Y, KD_GYRO_Z},
+                {KF_GYRO_X, KF_GYRO_Y, KF_GYRO_Z}},
+               MAX_INTEGRAL_GYRO, PID_OUTPUT_LIMIT_GYRO),
+      lqr(LQR_GAINS, LQR_OUTPUT_LIMIT),
+      input_shaper(input_expo, input_rate),
+      gain_scheduler(&GainScheduler::default_speed_table(), nullptr),
+      autotune(AUTOTUNE_RELAY_GYRO, AUTOTUNE_HYSTERESIS_GYRO, AUTOTUNE_CYCLES, AUTOTUNE_TIMEOUT)
 {
     // Inizializza gli errori e i parametri del controller di volo
     error_gyro = {0, 0, 0};
+    setpoint_gyro = {0, 0, 0};
     error_attitude = {0, 0, 0, 0};
     desired_attitude = {1, 0, 0, 0};
-    pid_tuning_offset_gyro = {0, 0, 0, 0};
-    pid_tuning_offset_attitude = {0, 0, 0, 0};
+    desired_input = {0, 0, 0};
+    pid_tuning_offset_gyro = {};
+    pid_tuning_offset_attitude = {};
     error = {0};
+    active_mode = ASSIST_MODE::MANUAL;
+    controller_mode = CONTROLLER_MODE::STANDARD;
+    autotune_mode = ASSIST_MODE::MANUAL;
+    autotune_axis = TUNING_TARGET_AXIS;
+    autotune_reported = false;
     Logger::getInstance().log(LogLevel::INFO, "Flight controller initialized.");
 }
 
-void FlightController::compute_pid_offset(ASSIST_MODE assist_mode, CONTROLLER_MODE controller_mode, ReceiverData &receiver_data)
+template <typename T>
+void FlightControllerT<T>::compute_pid_offset(ASSIST_MODE assist_mode, CONTROLLER_MODE controller_mode, ReceiverData &receiver_data)
 {
     // Aggiorna gli offset PID dinamici in base alla modalità operativa
-    PID *target_pid = nullptr;
+    AxisGains3<T> *target_pid = nullptr;
 
     if (assist_mode == ASSIST_MODE::GYRO_STABILIZED)
     {
@@ -35,49 +55,58 @@ void FlightController::compute_pid_offset(ASSIST_MODE assist_mode, CONTROLLER_MO
         target_pid = &pid_tuning_offset_attitude;
     }
 
+    // Il regolatore LQR non ha guadagni calibrabili dal radiocomando
+    if (target_pid == nullptr)
+        return;
+
+    T *target_gain = nullptr;
+    LOG_ID message = LOG_ID::TEXT;
+
     switch (controller_mode)
     {
     case CONTROLLER_MODE::KP_CALIBRATION:
-        if (target_pid->kp == receiver_data.swb)
-            return;
-        target_pid->kp = receiver_data.swb;
-        Logger::getInstance().log(LogLevel::INFO, "Kp updated");
+        target_gain = target_pid->kp;
+        message = LOG_ID::KP_UPDATED;
         break;
     case CONTROLLER_MODE::KI_CALIBRATION:
-        if (target_pid->ki == receiver_data.swb)
-            return;
-        target_pid->ki = receiver_data.swb;
-        Logger::getInstance().log(LogLevel::INFO, "Ki updated");
+        target_gain = target_pid->ki;
+        message = LOG_ID::KI_UPDATED;
         break;
     case CONTROLLER_MODE::KD_CALIBRATION:
-        if (target_pid->kd == receiver_data.swb)
-            return;
-        target_pid->kd = receiver_data.swb;
-        Logger::getInstance().log(LogLevel::INFO, "Kd updated");
+        target_gain = target_pid->kd;
+        message = LOG_ID::KD_UPDATED;
         break;
     default:
-        break;
+        return;
     }
+
+    // L'offset viene applicato a tutti e tre gli assi
+    const T offset = receiver_data.swb;
+    if (target_gain[0] == offset && target_gain[1] == offset && target_gain[2] == offset)
+        return;
+    target_gain[0] = target_gain[1] = target_gain[2] = offset;
+    Logger::getInstance().logEvent(message);
 }
 
-void FlightController::compute_desired_attitude(float roll, float pitch, float yaw, Quaternion &result)
+template <typename T>
+void FlightControllerT<T>::compute_desired_attitude(float roll, float pitch, float yaw, Quaternion &result)
 {
     // Calcola l'attitudine desiderata basandosi su input di rollio, beccheggio e imbardata
-    Quaternion q_roll, q_pitch, q_yaw, quaternions[3];
-    quaternion_from_axis_angle(axis[0], roll, q_roll);
-    quaternion_from_axis_angle(axis[1], pitch, q_pitch);
-    quaternion_from_axis_angle(axis[2], yaw, q_yaw);
-
-    quaternions[0] = q_roll;
-    quaternions[1] = q_pitch;
-    quaternions[2] = q_yaw;
-    quaternion_compose(quaternions, 3, result);
+    quaternion_from_euler(roll, pitch, yaw, result);
 }
 
-void FlightController::compute_data(double dt, ReceiverData &receiver_data, ImuData &imu_data,
+template <typename T>
+void FlightControllerT<T>::compute_data(T dt, ReceiverData &receiver_data, ImuData &imu_data,
                                     Output &output, ASSIST_MODE assist_mode,
                                     CONTROLLER_STATE state, Errors error, CONTROLLER_MODE controller_mode)
 {
+    this->controller_mode = controller_mode;
+
+    // Sagomatura degli stick, aggiornata anche in manuale così il filtro non riparte da valori vecchi
+    const float sticks[3] = {receiver_data.x, receiver_data.y, receiver_data.z};
+    float shaped[3];
+    input_shaper.update(sticks, static_cast<float>(dt), shaped);
+
     if (assist_mode == ASSIST_MODE::MANUAL || error.IMU_ERROR)
     {
         return; // Nessuna elaborazione necessaria in modalità manuale o in caso di errore IMU
@@ -88,52 +117,189 @@ void FlightController::compute_data(double dt, ReceiverData &receiver_data, ImuD
     if (assist_mode == ASSIST_MODE::GYRO_STABILIZED)
     {
         // Calcola gli errori angolari per la stabilizzazione giroscopica
-        error_gyro.x = receiver_data.x - imu_data.gyro.x;
-        error_gyro.y = receiver_data.y - imu_data.gyro.y;
-        error_gyro.z = receiver_data.z - imu_data.gyro.z;
+        setpoint_gyro = {shaped[0], shaped[1], shaped[2]};
+        error_gyro.x = setpoint_gyro.x - imu_data.gyro.x;
+        error_gyro.y = setpoint_gyro.y - imu_data.gyro.y;
+        error_gyro.z = setpoint_gyro.z - imu_data.gyro.z;
         return;
     }
 
-    if (assist_mode == ASSIST_MODE::ATTITUDE_CONTROL)
+    if (assist_mode == ASSIST_MODE::ATTITUDE_CONTROL || assist_mode == ASSIST_MODE::LQR_CONTROL)
     {
         // Calcola l'attitudine desiderata
-        float roll = error.RECEIVER_ERROR ? AUTO_LAND_X : receiver_data.x;
-        float pitch = error.RECEIVER_ERROR ? AUTO_LAND_Y : receiver_data.y;
-        float yaw = error.RECEIVER_ERROR ? AUTO_LAND_Z : receiver_data.z;
+        float roll = error.RECEIVER_ERROR ? AUTO_LAND_X : shaped[0];
+        float pitch = error.RECEIVER_ERROR ? AUTO_LAND_Y : shaped[1];
+        float yaw = error.RECEIVER_ERROR ? AUTO_LAND_Z : shaped[2];
 
-        compute_desired_attitude(roll, pitch, yaw, desired_attitude);
-
-        quaternion_normalize(desired_attitude);
+        // L'attitudine desiderata (unitaria per costruzione) cambia solo con gli input
+        if (roll != desired_input.x || pitch != desired_input.y || yaw != desired_input.z)
+        {
+            compute_desired_attitude(roll, pitch, yaw, desired_attitude);
+            desired_input = {roll, pitch, yaw};
+        }
 
         // Calcola l'errore tra attitudine desiderata e attuale
         quaternion_error(desired_attitude, imu_data.quat, error_attitude);
     }
 }
 
-void FlightController::compute_gyro_pid(const Euler &errors, const PID &pid_offsets, double dt,
-                                        Output &output)
+template <typename T>
+void FlightControllerT<T>::compute_gyro_pid(const Euler &errors, const Euler &setpoint, const Euler &gyro,
+                                            const AxisGains3<T> &pid_offsets, T dt, T inv_dt, Output &output)
 {
     // Calcola gli output PID per la velocità angolare
-    output.x = pid_gyro_x.pid(errors.x, dt, pid_offsets.kp, pid_offsets.ki, pid_offsets.kd);
-    output.y = pid_gyro_y.pid(errors.y, dt, pid_offsets.kp, pid_offsets.ki, pid_offsets.kd);
-    output.z = pid_gyro_z.pid(errors.z, dt, pid_offsets.kp, pid_offsets.ki, pid_offsets.kd);
+    const T error[3] = {errors.x, errors.y, errors.z};
+    const T measurement[3] = {gyro.x, gyro.y, gyro.z};
+    const T target[3] = {setpoint.x, setpoint.y, setpoint.z};
+    T result[3];
+    pid_gyro.update(error, measurement, target, dt, inv_dt, pid_offsets, result);
+
+    // In autotuning sull'anello del gyro il relè sostituisce l'output dell'asse target
+    if (autotune.get_state() == AUTOTUNE_STATE::RUNNING && autotune_mode == ASSIST_MODE::GYRO_STABILIZED)
+        result[autotune_axis] = autotune.update(error[autotune_axis], dt);
+    output.x = result[0];
+    output.y = result[1];
+    output.z = result[2];
 }
 
-void FlightController::compute_attitude_pid(const Quaternion &errors, const PID &pid_offsets, double dt,
-                                            Output &output)
+template <typename T>
+void FlightControllerT<T>::compute_attitude_pid(const Quaternion &errors, const Quaternion &attitude, const Euler &gyro,
+                                                const AxisGains3<T> &pid_offsets, T dt, T inv_dt, Output &output)
 {
     // Calcola gli output PID per l'attitudine
-    float desired_gyro_x = pid_attitude_x.pid(errors.x, dt, pid_offsets.kp, pid_offsets.ki, pid_offsets.kd);
-    float desired_gyro_y = pid_attitude_y.pid(errors.y, dt, pid_offsets.kp, pid_offsets.ki, pid_offsets.kd);
-    float desired_gyro_z = pid_attitude_z.pid(errors.z, dt, pid_offsets.kp, pid_offsets.ki, pid_offsets.kd);
-    compute_gyro_pid({desired_gyro_x, desired_gyro_y, desired_gyro_z}, pid_offsets, dt, output);
+    // La parte vettoriale del quaternione non è una misura da derivare: la derivata
+    // dell'errore si ricava dalle velocità angolari, valida anche lontano dall'identità
+    Quaternion error_rate;
+    quaternion_error_rate(desired_attitude, attitude, gyro, error_rate);
+
+    const T error[3] = {errors.x, errors.y, errors.z};
+    const T rate[3] = {error_rate.x, error_rate.y, error_rate.z};
+    const T no_setpoint[3] = {0, 0, 0};
+    T desired_gyro[3];
+    pid_attitude.update_rate(error, rate, no_setpoint, dt, inv_dt, pid_offsets, desired_gyro);
+
+    // In autotuning sull'anello di assetto il relè sostituisce la velocità angolare richiesta
+    if (autotune.get_state() == AUTOTUNE_STATE::RUNNING && autotune_mode == ASSIST_MODE::ATTITUDE_CONTROL)
+        desired_gyro[autotune_axis] = autotune.update(error[autotune_axis], dt);
+
+    // L'output dell'anello di assetto è l'errore dell'anello interno, come nella taratura
+    // attuale di KP/KI/KD_GYRO: la misura negata riproduce la derivata sull'errore
+    Euler rate_command = {static_cast<float>(desired_gyro[0]), static_cast<float>(desired_gyro[1]), static_cast<float>(desired_gyro[2])};
+    Euler rate_measurement = {-rate_command.x, -rate_command.y, -rate_command.z};
+    compute_gyro_pid(rate_command, rate_command, rate_measurement, pid_offsets, dt, inv_dt, output);
 }
 
-void FlightController::logData(const Output &output)
+template <typename T>
+void FlightControllerT<T>::compute_lqr(const Quaternion &errors, const Euler &gyro, Output &output)
 {
+    // Per piccoli angoli la parte vettoriale dell'errore vale metà della rotazione (rad) verso
+    // l'attitudine desiderata: lo stato è la rotazione opposta, in gradi
+    const float to_state = -2.0f / DEG_TO_RAD_F;
+    const float state[LQR_STATES] = {errors.x * to_state, errors.y * to_state, errors.z * to_state,
+                                     gyro.x, gyro.y, gyro.z};
+    const float reference[LQR_STATES] = {0, 0, 0, 0, 0, 0};
+    float result[LQR_INPUTS];
+    lqr.update(state, reference, result);
+    output.x = result[0];
+    output.y = result[1];
+    output.z = result[2];
 }
 
-void FlightController::control(double dt, ImuData &imu_data, ReceiverData &receiver_data,
+template <typename T>
+void FlightControllerT<T>::transfer(ASSIST_MODE assist_mode, const ImuData &imu_data, const Output &output)
+{
+    // L'output applicato è già scalato dal gain scheduling: il PID deve riprodurre il valore
+    // prima della scala del ciclo corrente
+    T applied[3] = {output.x, output.y, output.z};
+    for (int i = 0; i < 3; ++i)
+    {
+        if (schedule.output()[i] != 0.0f)
+            applied[i] /= schedule.output()[i];
+    }
+    const T gyro[3] = {imu_data.gyro.x, imu_data.gyro.y, imu_data.gyro.z};
+
+    if (assist_mode == ASSIST_MODE::GYRO_STABILIZED)
+    {
+        const T error[3] = {error_gyro.x, error_gyro.y, error_gyro.z};
+        const T setpoint[3] = {setpoint_gyro.x, setpoint_gyro.y, setpoint_gyro.z};
+        pid_gyro.transfer(error, gyro, setpoint, pid_tuning_offset_gyro, applied);
+    }
+    else if (assist_mode == ASSIST_MODE::ATTITUDE_CONTROL)
+    {
+        // L'anello esterno parte richiedendo la velocità angolare attuale, quello interno l'output attuale
+        const T error[3] = {error_attitude.x, error_attitude.y, error_attitude.z};
+        const T attitude[3] = {imu_data.quat.x, imu_data.quat.y, imu_data.quat.z};
+        const T no_setpoint[3] = {0, 0, 0};
+        const T negated_gyro[3] = {-gyro[0], -gyro[1], -gyro[2]};
+        pid_attitude.transfer(error, attitude, no_setpoint, pid_tuning_offset_attitude, gyro);
+        pid_gyro.transfer(gyro, negated_gyro, gyro, pid_tuning_offset_attitude, applied);
+    }
+
+    active_mode = assist_mode;
+    Logger::getInstance().logEvent<LOG_ID::PID_STATE_TRANSFERRED>();
+}
+
+template <typename T>
+void FlightControllerT<T>::update_autotune(ASSIST_MODE assist_mode, const ImuData &imu_data, const Output &output)
+{
+    const AUTOTUNE_STATE tune_state = autotune.get_state();
+
+    // Uscita dalla modalità o cambio di anello: l'esperimento viene interrotto.
+    // Il regolatore LQR non ha anelli PID da identificare.
+    if (controller_mode != CONTROLLER_MODE::AUTOTUNE || assist_mode == ASSIST_MODE::LQR_CONTROL ||
+        (tune_state != AUTOTUNE_STATE::IDLE && assist_mode != autotune_mode))
+    {
+        if (tune_state == AUTOTUNE_STATE::RUNNING)
+        {
+            transfer(assist_mode, imu_data, output);
+            Logger::getInstance().logEvent<LOG_ID::AUTOTUNE_ABORTED>();
+        }
+        if (tune_state != AUTOTUNE_STATE::IDLE)
+            autotune.stop();
+        return;
+    }
+
+    if (tune_state == AUTOTUNE_STATE::IDLE)
+    {
+        autotune_mode = assist_mode;
+        autotune_reported = false;
+        if (assist_mode == ASSIST_MODE::GYRO_STABILIZED)
+            autotune.start(AUTOTUNE_RELAY_GYRO, AUTOTUNE_HYSTERESIS_GYRO);
+        else
+            autotune.start(AUTOTUNE_RELAY_ATTITUDE, AUTOTUNE_HYSTERESIS_ATTITUDE);
+        Logger::getInstance().logEvent<LOG_ID::AUTOTUNE_STARTED>(autotune_axis);
+        return;
+    }
+
+    if (tune_state == AUTOTUNE_STATE::RUNNING || autotune_reported)
+        return;
+
+    // Esperimento concluso: l'anello torna al PID senza salti e il risultato viene registrato una volta
+    autotune_reported = true;
+    transfer(assist_mode, imu_data, output);
+
+    if (tune_state == AUTOTUNE_STATE::FAILED)
+    {
+        Logger::getInstance().logEvent<LOG_ID::AUTOTUNE_FAILED>();
+        return;
+    }
+
+    const AutotuneResult &result = autotune.get_result();
+    if (autotune_mode == ASSIST_MODE::GYRO_STABILIZED)
+        Logger::getInstance().logEvent<LOG_ID::AUTOTUNE_GYRO_RESULT>(autotune_axis, result.ku, result.tu,
+                                                                     result.kp, result.ki, result.kd);
+    else
+        Logger::getInstance().logEvent<LOG_ID::AUTOTUNE_ATTITUDE_RESULT>(autotune_axis, result.ku, result.tu,
+                                                                         result.kp, result.ki, result.kd);
+}
+
+template <typename T>
+void FlightControllerT<T>::logData(const Output &output)
+{
+}
+
+template <typename T>
+void FlightControllerT<T>::control(T dt, ImuData &imu_data, ReceiverData &receiver_data,
                                Output &output, ASSIST_MODE assist_mode,
                                CONTROLLER_STATE state, CALIBRATION_TARGET calibration_target)
 {
@@ -141,27 +307,51 @@ void FlightController::control(double dt, ImuData &imu_data, ReceiverData &recei
         output.x = receiver_data.x;
         output.y = receiver_data.y;
         output.z = receiver_data.z;
+        active_mode = ASSIST_MODE::MANUAL;
+        controller_mode = CONTROLLER_MODE::STANDARD;
+        // In manuale il relè non comanda nulla: un esperimento in corso va interrotto
+        if (autotune.get_state() != AUTOTUNE_STATE::IDLE)
+            autotune.stop();
+        autotune_mode = ASSIST_MODE::MANUAL;
+        autotune_axis = TUNING_TARGET_AXIS;
+        autotune_reported = false;
         return;
-}
+    }
+
+    // Gain scheduling: i fattori dei guadagni si applicano all'anello del gyro, che comanda gli attuatori
+    gain_scheduler.evaluate(imu_data.vel, receiver_data.throttle, schedule);
+    pid_gyro.set_gain_scale(schedule.kp(), schedule.ki(), schedule.kd());
+
+    // Riallinea i PID al cambio di modalità (reset / trasferimento bumpless)
+    if (assist_mode != active_mode)
+        transfer(assist_mode, imu_data, output);
+
+    // Gestione dell'esperimento di autotuning sull'asse target
+    autotune_axis = static_cast<int>(calibration_target);
+    update_autotune(assist_mode, imu_data, output);
+
+    // Reciproco calcolato una sola volta per ciclo
+    const T inv_dt = T(1) / dt;
+
     if (assist_mode == ASSIST_MODE::GYRO_STABILIZED)
     {
-        compute_gyro_pid(error_gyro, pid_tuning_offset_gyro, dt, output);
+        compute_gyro_pid(error_gyro, setpoint_gyro, imu_data.gyro, pid_tuning_offset_gyro, dt, inv_dt, output);
     }
     else if (assist_mode == ASSIST_MODE::ATTITUDE_CONTROL)
     {
-        compute_attitude_pid(error_attitude, pid_tuning_offset_attitude, dt, output);
+        compute_attitude_pid(error_attitude, imu_data.quat, imu_data.gyro, pid_tuning_offset_attitude, dt, inv_dt, output);
+    }
+    else if (assist_mode == ASSIST_MODE::LQR_CONTROL)
+    {
+        compute_lqr(error_attitude, imu_data.gyro, output);
     }
 
-    // Applica un fattore di riduzione per velocità elevate
-    double forward_speed = imu_data.vel;
-    double reduction_factor = 1.0;
-    reduction_factor = (forward_speed > 0)
-                           ? ((forward_speed <= FORWARD_SPEED_THRESHOLD)
-                                  ? 1.0 - (1.0 - SERVO_REDUCTION_FACTOR) * (forward_speed / FORWARD_SPEED_THRESHOLD)
-                                  : SERVO_REDUCTION_FACTOR)
-                           : 1.0;
-
-    output.x *= reduction_factor;
-    output.y *= reduction_factor;
-    output.z *= reduction_factor;
+    // Applica i fattori di scala dell'output calcolati dal gain scheduling
+    output.x *= schedule.output()[0];
+    output.y *= schedule.output()[1];
+    output.z *= schedule.output()[2];
 }
+
+// Istanziazioni esplicite: float per il target, double come riferimento
+template class FlightControllerT<float>;
+template class FlightControllerT<double>;
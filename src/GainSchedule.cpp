@@ -0,0 +1,103 @@
+#include "GainSchedule.h"
+#include "FlightControllerConfig.h"
+#include "Logger.h"
+
+GainScheduleTable::GainScheduleTable(const float *breakpoints, const GainScheduleEntry *values, size_t count)
+    : count(count > GAIN_SCHEDULE_MAX_POINTS ? GAIN_SCHEDULE_MAX_POINTS : count)
+{
+    if (count > GAIN_SCHEDULE_MAX_POINTS)
+        Logger::getInstance().logEvent<LOG_ID::GAIN_TABLE_TRUNCATED>();
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+        this->breakpoints[i] = breakpoints[i];
+        this->values[i] = values[i];
+        slopes[i] = {};
+    }
+
+    // Pendenze precalcolate: l'unica divisione avviene qui
+    for (size_t i = 0; i + 1 < this->count; ++i)
+    {
+        float span = this->breakpoints[i + 1] - this->breakpoints[i];
+        if (span <= 0)
+        {
+            Logger::getInstance().logEvent<LOG_ID::GAIN_BREAKPOINTS_NOT_INCREASING>();
+            continue;
+        }
+        float inv_span = 1.0f / span;
+        const float *a = this->values[i].field;
+        const float *b = this->values[i + 1].field;
+        float *s = slopes[i].field;
+        for (int k = 0; k < GAIN_SCHEDULE_FIELDS; ++k)
+            s[k] = (b[k] - a[k]) * inv_span;
+    }
+}
+
+void GainScheduleTable::evaluate(float x, GainScheduleEntry &result) const
+{
+    if (count == 0)
+        return;
+
+    // Ricerca lineare: le tabelle hanno pochi breakpoint
+    size_t i = 0;
+    while (i + 1 < count && x >= breakpoints[i + 1])
+        ++i;
+
+    // Sotto il primo o oltre l'ultimo breakpoint il valore resta costante
+    float dx = (x > breakpoints[i] && i + 1 < count) ? x - breakpoints[i] : 0;
+
+    const float *v = values[i].field;
+    const float *s = slopes[i].field;
+    float *r = result.field;
+    for (int k = 0; k < GAIN_SCHEDULE_FIELDS; ++k)
+        r[k] = v[k] + s[k] * dx;
+}
+
+GainScheduler::GainScheduler(const GainScheduleTable *speed_table, const GainScheduleTable *throttle_table)
+    : speed_table(speed_table), throttle_table(throttle_table)
+{
+    Logger::getInstance().log(LogLevel::INFO, "Gain scheduler initialized.");
+}
+
+const GainScheduleTable *GainScheduler::set_speed_table(const GainScheduleTable *table)
+{
+    return speed_table.exchange(table, std::memory_order_acq_rel);
+}
+
+const GainScheduleTable *GainScheduler::set_throttle_table(const GainScheduleTable *table)
+{
+    return throttle_table.exchange(table, std::memory_order_acq_rel);
+}
+
+void GainScheduler::evaluate(float speed, float throttle, GainScheduleEntry &result) const
+{
+    float *r = result.field;
+    for (int k = 0; k < GAIN_SCHEDULE_FIELDS; ++k)
+        r[k] = 1.0f;
+
+    const GainScheduleTable *by_speed = speed_table.load(std::memory_order_acquire);
+    const GainScheduleTable *by_throttle = throttle_table.load(std::memory_order_acquire);
+
+    if (by_speed)
+        by_speed->evaluate(speed, result);
+
+    if (by_throttle)
+    {
+        GainScheduleEntry factor;
+        by_throttle->evaluate(throttle, factor);
+        const float *f = factor.field;
+        for (int k = 0; k < GAIN_SCHEDULE_FIELDS; ++k)
+            r[k] *= f[k];
+    }
+}
+
+const GainScheduleTable &GainScheduler::default_speed_table()
+{
+    static const float breakpoints[] = {0, FORWARD_SPEED_THRESHOLD};
+    static const float reduction = SERVO_REDUCTION_FACTOR;
+    static const GainScheduleEntry values[] = {
+        {{1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}},
+        {{1, 1, 1, 1, 1, 1, 1, 1, 1, reduction, reduction, reduction}}};
+    static const GainScheduleTable table(breakpoints, values, 2);
+    return table;
+}
@@ -0,0 +1,131 @@
+#include "IBusParser.h"
+#include "AirframeConfig.h"
+#include <string.h>
+
+IBusParser::IBusParser() : bufferIndex(0), stats{}
+{
+    reset();
+}
+
+void IBusParser::reset()
+{
+    bufferIndex = 0;
+    memset(buffer, 0, PACKET_SIZE);
+}
+
+bool IBusParser::decodePacket(ReceiverData &data)
+{
+    if (buffer[0] != HEADER_1 || buffer[1] != HEADER_2)
+        return false;
+
+    // Calcola il checksum
+    uint16_t checksum = 0xFFFF;
+    for (int i = 0; i < 30; ++i)
+    {
+        checksum -= buffer[i];
+    }
+
+    uint16_t receivedChecksum = buffer[30] | (buffer[31] << 8);
+    if (checksum != receivedChecksum)
+    {
+        stats.checksumErrors++;
+        return false;
+    }
+
+    // Estrae e valida tutti i canali prima di aggiornare i dati
+    int16_t pwm_values[CHANNELS];
+    for (int i = 0; i < CHANNELS; ++i)
+    {
+        pwm_values[i] = buffer[2 + i * 2] | (buffer[3 + i * 2] << 8);
+        if (pwm_values[i] < 0)
+            return false;
+    }
+
+    // Fattori di scala precalcolati in compilazione: un prodotto e un clamp per canale
+    static_assert(sizeof(ActiveAirframe::receiver) / sizeof(ActiveAirframe::receiver[0]) == CHANNELS,
+                  "Conversioni dei canali non allineate al numero di canali iBus");
+    const ChannelMap *map = ActiveAirframe::receiver;
+    data.x = map[0].apply(pwm_values[0]);
+    data.y = map[1].apply(pwm_values[1]);
+    data.throttle = map[2].apply(pwm_values[2]);
+    data.z = map[3].apply(pwm_values[3]);
+    data.swa = map[4].apply(pwm_values[4]);
+    data.swb = map[5].apply(pwm_values[5]);
+    data.swc = map[6].apply(pwm_values[6]);
+    data.swd = map[7].apply(pwm_values[7]);
+    data.vra = map[8].apply(pwm_values[8]);
+    data.vrb = map[9].apply(pwm_values[9]);
+
+    return true;
+}
+
+size_t IBusParser::resync(size_t from)
+{
+    // Cerca il primo byte che può essere l'inizio di un pacchetto
+    size_t i = from;
+    while (i < bufferIndex &&
+           !(buffer[i] == HEADER_1 && (i + 1 >= bufferIndex || buffer[i + 1] == HEADER_2)))
+    {
+        ++i;
+    }
+
+    if (i == 0)
+        return 0;
+
+    // Scarta i byte precedenti con un solo spostamento
+    size_t remaining = bufferIndex - i;
+    memmove(buffer, buffer + i, remaining);
+    bufferIndex = remaining;
+    stats.bytesDiscarded += i;
+
+    return i + remaining;
+}
+
+bool IBusParser::parse(const uint8_t *bytes, size_t length, ReceiverData &data)
+{
+    bool packetDecoded = false;
+    size_t consumed = 0;
+    size_t work = 0;
+
+    while (consumed < length)
+    {
+        size_t chunk = length - consumed;
+        if (chunk > PACKET_SIZE - bufferIndex)
+            chunk = PACKET_SIZE - bufferIndex; // Non superare lo spazio disponibile nel buffer
+
+        memcpy(buffer + bufferIndex, bytes + consumed, chunk);
+        bufferIndex += chunk;
+        consumed += chunk;
+        work += chunk;
+
+        // Mantiene il buffer allineato all'header
+        work += resync(0);
+
+        // Gestire pacchetti completi
+        if (bufferIndex == PACKET_SIZE)
+        {
+            work += PACKET_SIZE;
+            if (decodePacket(data))
+            {
+                // Continua a leggere: l'ultimo pacchetto valido è il più recente
+                stats.packetsValid++;
+                packetDecoded = true;
+                bufferIndex = 0;
+            }
+            else
+            {
+                // Scarta l'header non valido e cerca il successivo
+                work += resync(1);
+            }
+        }
+    }
+
+    stats.bytesRead += length;
+    if (length > stats.maxBytesPerRead)
+        stats.maxBytesPerRead = length;
+    if (work > stats.maxWorkPerRead)
+        stats.maxWorkPerRead = work;
+
+    // I byte di un pacchetto incompleto restano nel buffer per la chiamata successiva
+    return packetDecoded;
+}
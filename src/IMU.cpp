@@ -1,5 +1,6 @@
 #include "IMU.h"
 #include "Logger.h"
+#include "FastMath.h"
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BNO055.h>
 #include <Arduino.h>
@@ -7,10 +8,10 @@
 // Inizializzazione dell'oggetto sensore BNO055
 Adafruit_BNO055 bno055 = Adafruit_BNO055(55, 0x28, &Wire);
 
-uint16_t BNO055_SAMPLERATE_DELAY_MS = 10;                                          ///< Frequenza di campionamento in millisecondi.
-const double ACCEL_VEL_TRANSITION = (double)(BNO055_SAMPLERATE_DELAY_MS) / 1000.0; ///< Fattore per velocità da accelerazione.
-const double ACCEL_POS_TRANSITION = 0.5 * ACCEL_VEL_TRANSITION * ACCEL_VEL_TRANSITION;
-const double DEG_2_RAD = 0.01745329251; ///< Conversione da gradi a radianti.
+uint16_t BNO055_SAMPLERATE_DELAY_MS = 10;                                           ///< Frequenza di campionamento in millisecondi.
+const float ACCEL_VEL_TRANSITION = (float)(BNO055_SAMPLERATE_DELAY_MS) / 1000.0f;   ///< Fattore per velocità da accelerazione.
+const float ACCEL_POS_TRANSITION = 0.5f * ACCEL_VEL_TRANSITION * ACCEL_VEL_TRANSITION; ///< Fattore per posizione da accelerazione.
+const float DEG_2_RAD = 0.01745329251f; ///< Conversione da gradi a radianti.
 
 IMU::IMU()
 {
@@ -32,24 +33,6 @@ IMU::IMU()
     Logger::getInstance().log(LogLevel::INFO, "IMU setup complete.");
 }
 
-void IMU::logData(const ImuData &data)
-{
-    Logger::getInstance().logData("G_X", data.gyro.x);
-    Logger::getInstance().logData("G_Y", data.gyro.y);
-    Logger::getInstance().logData("G_Z", data.gyro.z);
-
-    Logger::getInstance().logData("Ac_X", data.accel.x);
-    Logger::getInstance().logData("Ac_Y", data.accel.y);
-    Logger::getInstance().logData("Ac_Z", data.accel.z);
-
-    Logger::getInstance().logData("Q_W", data.quat.w);
-    Logger::getInstance().logData("Q_X", data.quat.x);
-    Logger::getInstance().logData("Q_Y", data.quat.y);
-    Logger::getInstance().logData("Q_Z", data.quat.z);
-
-    Logger::getInstance().logData("V", data.vel);
-}
-
 bool IMU::read(ImuData &data)
 {
     // Legge i dati dai sensori dell'IMU
@@ -81,7 +64,7 @@ bool IMU::read(ImuData &data)
     data.accel.z = linearAccelData.acceleration.z;
 
     // Velocità lineare
-    data.vel = ACCEL_VEL_TRANSITION * linearAccelData.acceleration.x / cos(DEG_2_RAD * orientationData.orientation.x);
+    data.vel = ACCEL_VEL_TRANSITION * linearAccelData.acceleration.x / fast_cos(DEG_2_RAD * orientationData.orientation.x);
 
     // Log dei dati
     return true;
@@ -0,0 +1,88 @@
+#include "InputShaper.h"
+#include "Logger.h"
+#include <math.h>
+
+InputShaper::InputShaper(const float expo[3], const float rate[3])
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        for (int i = 0; i <= INPUT_SHAPER_LUT_SIZE; ++i)
+        {
+            const float n = static_cast<float>(i) / INPUT_SHAPER_LUT_SIZE;
+            lut[axis][i] = rate[axis] * (expo[axis] * n * n * n + (1.0f - expo[axis]) * n);
+        }
+        for (int i = 0; i < INPUT_SHAPER_LUT_SIZE; ++i)
+            slope[axis][i] = lut[axis][i + 1] - lut[axis][i];
+    }
+
+    const float centered[3] = {0, 0, 0};
+    reset(centered);
+    Logger::getInstance().log(LogLevel::INFO, "Input shaper initialized.");
+}
+
+float InputShaper::shape(int axis, float stick) const
+{
+    // Posizione nella tabella: parte intera come indice, parte frazionaria per l'interpolazione
+    const float scale = static_cast<float>(INPUT_SHAPER_LUT_SIZE) / INPUT_STICK_MAX;
+    float position = fabsf(stick) * scale;
+    if (position >= INPUT_SHAPER_LUT_SIZE)
+        return (stick < 0) ? -lut[axis][INPUT_SHAPER_LUT_SIZE] : lut[axis][INPUT_SHAPER_LUT_SIZE];
+
+    const int i = static_cast<int>(position);
+    const float value = lut[axis][i] + slope[axis][i] * (position - i);
+    return (stick < 0) ? -value : value;
+}
+
+void InputShaper::update(const float stick[3], float dt, float setpoint[3])
+{
+#if INPUT_SMOOTHING == INPUT_SMOOTHING_PT1
+    // Coefficiente del PT1 calcolato una volta per tutti gli assi
+    const float rc = static_cast<float>(1.0 / (2.0 * M_PI * INPUT_SMOOTHING_CUTOFF_HZ));
+    const float k = dt / (rc + dt);
+#elif INPUT_SMOOTHING == INPUT_SMOOTHING_INTERPOLATE
+    // Cicli di controllo per frame del ricevitore (almeno uno se il loop è più lento dei frame)
+    int steps = static_cast<int>(INPUT_FRAME_INTERVAL_MS * 0.001f / dt + 0.5f);
+    if (steps < 1)
+        steps = 1;
+#else
+    (void)dt;
+#endif
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float shaped = shape(axis, stick[axis]);
+
+#if INPUT_SMOOTHING == INPUT_SMOOTHING_PT1
+        smoothed[axis] += k * (shaped - smoothed[axis]);
+#elif INPUT_SMOOTHING == INPUT_SMOOTHING_INTERPOLATE
+        // Un nuovo frame fa ripartire la rampa dal valore corrente
+        if (shaped != target[axis])
+        {
+            target[axis] = shaped;
+            step[axis] = (shaped - smoothed[axis]) / steps;
+            remaining[axis] = steps;
+        }
+        if (remaining[axis] > 0 && --remaining[axis] > 0)
+            smoothed[axis] += step[axis];
+        else
+            smoothed[axis] = target[axis];
+#else
+        smoothed[axis] = shaped;
+#endif
+
+        setpoint[axis] = smoothed[axis];
+    }
+}
+
+void InputShaper::reset(const float stick[3])
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        smoothed[axis] = shape(axis, stick[axis]);
+#if INPUT_SMOOTHING == INPUT_SMOOTHING_INTERPOLATE
+        target[axis] = smoothed[axis];
+        step[axis] = 0;
+        remaining[axis] = 0;
+#endif
+    }
+}
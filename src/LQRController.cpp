@@ -0,0 +1,33 @@
+#include "LQRController.h"
+#include "Logger.h"
+
+LQRController::LQRController(const float gains[LQR_INPUTS][LQR_STATES], float outputLimit)
+    : outputLimit(outputLimit)
+{
+    set_gains(gains);
+    Logger::getInstance().log(LogLevel::INFO, "LQR controller initialized.");
+}
+
+void LQRController::set_gains(const float gains[LQR_INPUTS][LQR_STATES])
+{
+    for (int i = 0; i < LQR_INPUTS; ++i)
+        for (int j = 0; j < LQR_STATES; ++j)
+            this->gains[i][j] = gains[i][j];
+}
+
+void LQRController::update(const float state[LQR_STATES], const float reference[LQR_STATES], float output[LQR_INPUTS]) const
+{
+    // Scostamento dal riferimento, calcolato una volta per tutti gli ingressi
+    float deviation[LQR_STATES];
+    for (int j = 0; j < LQR_STATES; ++j)
+        deviation[j] = state[j] - reference[j];
+
+    for (int i = 0; i < LQR_INPUTS; ++i)
+    {
+        float u = 0.0f;
+        for (int j = 0; j < LQR_STATES; ++j)
+            u -= gains[i][j] * deviation[j];
+        output[i] = (u > outputLimit) ? outputLimit : (u < -outputLimit) ? -outputLimit
+                                                                         : u;
+    }
+}
@@ -0,0 +1,63 @@
+#include "LogMessages.h"
+#include <stdio.h>
+
+size_t log_render(LOG_ID id, const uint32_t *args, uint8_t argc, char *buffer, size_t size)
+{
+    if (size == 0)
+        return 0;
+
+    const char *format = log_message_info(id).format;
+    size_t length = 0;
+    uint8_t next = 0;
+
+    for (const char *p = format; *p != '\0' && length < size - 1;)
+    {
+        if (*p != '%')
+        {
+            buffer[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            buffer[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Specifica singola (flag, larghezza, precisione, conversione) formattata con il tipo giusto
+        char spec[16];
+        size_t n = 0;
+        spec[n++] = *p++;
+        while (*p != '\0' && strchr("-+ #0123456789.", *p) != nullptr && n < sizeof(spec) - 2)
+            spec[n++] = *p++;
+        if (*p == '\0')
+            break;
+        const char conversion = *p++;
+        spec[n++] = conversion;
+        spec[n] = '\0';
+
+        const uint32_t word = next < argc ? args[next] : 0;
+        next++;
+
+        int written;
+        if (conversion == 'f')
+        {
+            float value;
+            memcpy(&value, &word, sizeof(value));
+            written = snprintf(buffer + length, size - length, spec, static_cast<double>(value));
+        }
+        else if (conversion == 'd' || conversion == 'i')
+        {
+            written = snprintf(buffer + length, size - length, spec, static_cast<int>(static_cast<int32_t>(word)));
+        }
+        else
+        {
+            written = snprintf(buffer + length, size - length, spec, static_cast<unsigned>(word));
+        }
+        if (written > 0)
+            length += static_cast<size_t>(written) < size - length ? static_cast<size_t>(written) : size - length - 1;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
@@ -1,8 +1,13 @@
 #include "Logger.h"
+#include "SerialCommands.h"
 #include "WiFiManager.h"
 #include <Arduino.h>
 #include <WiFi.h>
 #include <HTTPClient.h>
+#include <esp_heap_caps.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
 
 Logger::Logger()
 {
@@ -15,8 +20,85 @@ Logger &Logger::getInstance()
     return instance;
 }
 
+// Potenza di 2 più grande non superiore a n (0 se n < 2: la coda resta senza memoria)
+static size_t floor_pow2(size_t n)
+{
+    if (n < 2)
+        return 0;
+    size_t p = 1;
+    while (p <= n / 2)
+        p *= 2;
+    return p;
+}
+
+void Logger::allocateBuffers()
+{
+    static_assert(std::is_trivially_copyable<LogMessage>::value && std::is_trivially_copyable<TelemetryRecord>::value,
+                  "Gli elementi delle code stanno in memoria non inizializzata");
+    static_assert(LOG_BUDGET_INTERNAL >= 2 * LOG_QUEUE_SIZE * sizeof(LogMessage) + 2 * sizeof(TelemetryRecord),
+                  "Budget in RAM interna insufficiente per le code minime");
+
+    if (bufferMemory != nullptr)
+        return;
+
+    // In PSRAM se presente; altrimenti, o se l'allocazione fallisce, il budget ridotto in RAM interna
+    size_t budget = LOG_BUDGET_PSRAM;
+    bool psram = psramFound();
+    if (psram)
+        bufferMemory = heap_caps_malloc(budget, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (bufferMemory == nullptr)
+    {
+        psram = false;
+        budget = LOG_BUDGET_INTERNAL;
+        bufferMemory = heap_caps_malloc(budget, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (bufferMemory == nullptr)
+    {
+        logEvent<LOG_ID::LOGGER_BUFFERS_FAILED>(static_cast<uint32_t>(budget));
+        return;
+    }
+    bufferBudget = budget;
+    bufferInPsram = psram;
+
+    // Code di log prima (gli elementi più grandi), poi i record nel resto del budget
+    size_t logCapacity = floor_pow2(budget / LOG_BUDGET_LOG_DIVISOR / sizeof(LogMessage));
+    if (logCapacity < LOG_QUEUE_SIZE)
+        logCapacity = LOG_QUEUE_SIZE;
+    LogMessage *logs = static_cast<LogMessage *>(bufferMemory);
+    controlLogQueue.attach(logs, logCapacity);
+    backgroundLogQueue.attach(logs + logCapacity, logCapacity);
+
+    const size_t logBytes = 2 * logCapacity * sizeof(LogMessage);
+    const size_t dataCapacity = floor_pow2((budget - logBytes) / sizeof(TelemetryRecord));
+    dataBuffer.attach(reinterpret_cast<TelemetryRecord *>(static_cast<char *>(bufferMemory) + logBytes), dataCapacity);
+
+    const uint32_t usedKB = static_cast<uint32_t>((logBytes + dataCapacity * sizeof(TelemetryRecord)) / 1024);
+    if (psram)
+        logEvent<LOG_ID::LOGGER_BUFFERS_PSRAM>(static_cast<uint32_t>(dataCapacity), static_cast<uint32_t>(logCapacity), usedKB);
+    else
+        logEvent<LOG_ID::LOGGER_BUFFERS_INTERNAL>(static_cast<uint32_t>(dataCapacity), static_cast<uint32_t>(logCapacity), usedKB);
+}
+
+LoggerMemoryStats Logger::getMemoryStats() const
+{
+    LoggerMemoryStats stats;
+    stats.budget = bufferBudget;
+    stats.psram = bufferInPsram;
+    stats.dataCapacity = static_cast<uint32_t>(dataBuffer.capacity());
+    stats.dataHighWater = dataBuffer.getHighWater();
+    stats.dataDropped = dataBuffer.getDropped();
+    stats.logCapacity = static_cast<uint32_t>(controlLogQueue.capacity());
+    stats.logHighWater = controlLogQueue.getHighWater() > backgroundLogQueue.getHighWater()
+                             ? controlLogQueue.getHighWater()
+                             : backgroundLogQueue.getHighWater();
+    stats.logDropped = controlLogQueue.getDropped() + backgroundLogQueue.getDropped();
+    return stats;
+}
+
 void Logger::startLogTask()
 {
+    SerialCommands::getInstance().add("telemetry", telemetryCommand, this);
+
     xTaskCreatePinnedToCore(
         logTask,   // Funzione del task
         "LogTask", // Nome del task
@@ -26,40 +108,101 @@ void Logger::startLogTask()
         nullptr,   // Handle del task
         1          // Core su cui eseguire il task
     );
+
+    // Stessa priorità del ciclo di controllo, che non cede mai la CPU: con una priorità
+    // inferiore il task non verrebbe mai eseguito sul core 1. Non attende mai la linea.
+    xTaskCreatePinnedToCore(
+        serialLogTask,   // Funzione del task
+        "SerialLogTask", // Nome del task
+        4096,            // Dimensione dello stack
+        this,            // Parametro passato al task
+        1,               // Priorità del task
+        nullptr,         // Handle del task
+        1                // Core su cui eseguire il task
+    );
 }
 
-void Logger::log(LogLevel level, const std::string &message, bool sendToServer)
+void Logger::registerControlTask()
+{
+    controlTask = xTaskGetCurrentTaskHandle();
+}
+
+// Scrive un testo direttamente nello slot della coda, senza copiare il messaggio intero
+static void queue_text(SPSCRing<LogMessage> &queue, uint32_t timestamp, LogLevel level,
+                       const char *text, size_t length)
 {
-    static bool bufferFull = false;
-    std::lock_guard<std::mutex> lock(mutex);
-    std::string formattedLog = formatLog(level, message);
-    Serial.println(formattedLog.c_str());
-    if (!sendToServer)
+    LogMessage *entry = queue.prepare();
+    if (entry == nullptr)
         return;
-    if (logBuffer.size() >= maxBufferSize)
+    entry->timestamp_ms = timestamp;
+    entry->level = level;
+    entry->id = LOG_ID::TEXT;
+    entry->argc = 0;
+    memcpy(entry->text, text, length);
+    entry->text[length] = '\0';
+    queue.commit();
+}
+
+// Scrive identificativo e argomenti direttamente nello slot della coda
+static void queue_event(SPSCRing<LogMessage> &queue, uint32_t timestamp, LOG_ID id,
+                        const uint32_t *args, uint8_t argc)
+{
+    LogMessage *entry = queue.prepare();
+    if (entry == nullptr)
+        return;
+    entry->timestamp_ms = timestamp;
+    entry->level = log_message_info(id).level;
+    entry->id = id;
+    entry->argc = argc;
+    for (uint8_t i = 0; i < argc; ++i)
+        entry->args[i] = args[i];
+    queue.commit();
+}
+
+void Logger::log(LogLevel level, const std::string &message, bool sendToServer)
+{
+    // Solo la copia del testo: timestamp e livello vengono formattati da chi scrive la riga
+    const uint32_t now = millis();
+    const size_t length = message.size() < LOG_MESSAGE_SIZE - 1 ? message.size() : LOG_MESSAGE_SIZE - 1;
+
+    // Il ciclo di controllo ha code proprie e non attende mai gli altri task né la UART
+    if (controlTask != nullptr && xTaskGetCurrentTaskHandle() == controlTask)
     {
-        logBuffer.pop_front();
-        if (!bufferFull)
-        {
-            Logger::getInstance().log(LogLevel::WARNING, "LogBuffer is full. Older logs will be discarded.");
-            bufferFull = true;
-        }
+        queue_text(controlSerialQueue, now, level, message.data(), length);
+        if (sendToServer)
+            queue_text(controlLogQueue, now, level, message.data(), length);
+        return;
     }
-    else
+
+    std::lock_guard<std::mutex> lock(backgroundMutex);
+    queue_text(backgroundSerialQueue, now, level, message.data(), length);
+    if (sendToServer)
+        queue_text(backgroundLogQueue, now, level, message.data(), length);
+}
+
+void Logger::pushEvent(LOG_ID id, const uint32_t *args, uint8_t argc)
+{
+    const uint32_t now = millis();
+
+    if (controlTask != nullptr && xTaskGetCurrentTaskHandle() == controlTask)
     {
-        if (bufferFull)
-        {
-            Logger::getInstance().log(LogLevel::WARNING, "LogBuffer is no longer full.");
-            bufferFull = false;
-        }
+        queue_event(controlSerialQueue, now, id, args, argc);
+        queue_event(controlLogQueue, now, id, args, argc);
+        return;
     }
-    logBuffer.push_back(formattedLog);
+
+    std::lock_guard<std::mutex> lock(backgroundMutex);
+    queue_event(backgroundSerialQueue, now, id, args, argc);
+    queue_event(backgroundLogQueue, now, id, args, argc);
 }
 
-std::string Logger::formatLog(LogLevel level, const std::string &message) const
+size_t Logger::formatLog(const LogMessage &message, char *buffer, size_t size) const
 {
-    std::string levelStr;
-    switch (level)
+    if (size == 0)
+        return 0;
+
+    const char *levelStr = "";
+    switch (message.level)
     {
     case LogLevel::ERROR:
         levelStr = "ERROR";
@@ -72,18 +215,31 @@ std::string Logger::formatLog(LogLevel level, const std::string &message) const
         break;
     }
 
-    unsigned long currentTime = millis();
+    unsigned long currentTime = message.timestamp_ms;
     unsigned long seconds = (currentTime / 1000) % 60;
     unsigned long minutes = (currentTime / 60000) % 60;
     unsigned long hours = currentTime / 3600000;
 
-    char timestamp[16];
-    snprintf(timestamp, sizeof(timestamp), "%02lu:%02lu:%02lu", hours, minutes, seconds);
+    const int prefix = snprintf(buffer, size, "[%02lu:%02lu:%02lu] %s: ", hours, minutes, seconds, levelStr);
+    if (prefix < 0)
+    {
+        buffer[0] = '\0';
+        return 0;
+    }
+    size_t length = static_cast<size_t>(prefix) < size ? static_cast<size_t>(prefix) : size - 1;
+
+    if (message.id != LOG_ID::TEXT)
+        return length + log_render(message.id, message.args, message.argc, buffer + length, size - length);
 
-    return "[" + std::string(timestamp) + "] " + levelStr + ": " + message;
+    const size_t text = strnlen(message.text, LOG_MESSAGE_SIZE - 1);
+    const size_t n = text < size - 1 - length ? text : size - 1 - length;
+    memcpy(buffer + length, message.text, n);
+    length += n;
+    buffer[length] = '\0';
+    return length;
 }
 
-void Logger::sendLogToServer(const std::string &log)
+void Logger::sendLogToServer(const char *log)
 {
     WiFiManager &wifiManager = WiFiManager::getInstance();
     const char *serverAddress = wifiManager.serverAddress;
@@ -95,11 +251,11 @@ void Logger::sendLogToServer(const std::string &log)
     http.begin(serverUrl.c_str());
     http.addHeader("Content-Type", "text/plain");
 
-    int httpResponseCode = http.POST(log.c_str());
+    int httpResponseCode = http.POST(log);
 
     if (httpResponseCode <= 0)
     {
-        Serial.println("Failed to send log to server. HTTP error: " + String(httpResponseCode));
+        Logger::getInstance().log(LogLevel::ERROR, "Failed to send log to server. HTTP error: " + std::to_string(httpResponseCode), false);
     }
 
     http.end();
@@ -107,169 +263,430 @@ void Logger::sendLogToServer(const std::string &log)
 
 void Logger::incrementCycle()
 {
-    std::lock_guard<std::mutex> lock(mutex);
     currentCycle++;
 }
 
-void Logger::logData(const std::string &varName, double value, int decimalPlaces)
+void Logger::logData(const TelemetryRecord &record)
 {
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // Troncamento del valore al numero di cifre decimali specificate
-    double scalingFactor = pow(10, decimalPlaces);
-    value = floor(value * scalingFactor) / scalingFactor;
+    lastRecord = record;
+    lastRecord.cycle = currentCycle;
 
-    // Conversione a stringa
-    std::string valueStr = std::to_string(value);
+    // Il primo record fissa l'istante di inizio riportato nell'header; la pubblicazione del
+    // record nella coda lo rende visibile al task di invio
+    if (startTimestamp[0] == '\0')
+    {
+        time_t now = time(nullptr);
+        strftime(startTimestamp, sizeof(startTimestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    }
 
-    // Aggiunta della variabile e del valore alla riga temporanea
-    tempDataRow.push_back(varName);  // Nome variabile
-    tempDataRow.push_back(valueStr); // Valore troncato
+    // Copia nella coda preallocata: nessuna conversione, allocazione o lock nel ciclo di controllo
+    dataBuffer.push(lastRecord);
 }
 
-void Logger::prepareDataBuffer()
+void Logger::sendDataToServer()
 {
-    std::lock_guard<std::mutex> lock(mutex);
+#if TELEMETRY_TRANSPORT == TELEMETRY_TRANSPORT_UDP
+    const char *serverAddress = WiFiManager::getInstance().serverAddress;
 
-    if (tempDataRow.empty())
+    // Un datagramma per gruppo di record, finché restano record, byte e tempo
+    const unsigned long start = micros();
+    size_t budget = TELEMETRY_BATCH_BYTES;
+    while (budget >= TELEMETRY_FRAME_BYTES && micros() - start < TELEMETRY_BATCH_TIME_US)
     {
-        Logger::getInstance().log(LogLevel::ERROR, "No data to log.");
-        return;
-    }
-
-    static bool bufferFull = false;
-
-    // Se il ciclo è 0, aggiungi i nomi delle variabili
-    if (currentCycle == 0)
-    {
-        std::vector<std::string> headerRow;
-        // Aggiungi il timestamp formattato
-        time_t now = time(nullptr);
-        char timestamp[20];
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        headerRow.push_back(timestamp);
-
-        // Aggiungi i nomi delle variabili (ogni elemento dispari in tempDataRow)
-        for (size_t i = 0; i < tempDataRow.size(); i += 2)
+        if (dataBuffer.size() == 0)
+            break;
+
+#if TELEMETRY_ENCODING == TELEMETRY_ENCODING_DELTA
+        // Lo schema precede i dati e viene ripetuto, così anche un ricevitore avviato dopo decodifica;
+        // una configurazione dei canali nuova viene annunciata subito
+        if (encoder.configure(channels))
+            framesSinceSchema = TELEMETRY_SCHEMA_INTERVAL;
+        if (framesSinceSchema >= TELEMETRY_SCHEMA_INTERVAL)
         {
-            headerRow.push_back(tempDataRow[i]);
+            uint8_t schema[TELEMETRY_SCHEMA_BYTES];
+            const size_t schemaSize = encoder.formatSchema(schema, sizeof(schema));
+            stream.begin(TELEMETRY_FRAME::SCHEMA);
+            if (schemaSize > 0 && stream.append(schema, schemaSize) &&
+                stream.send(serverAddress, TELEMETRY_UDP_PORT) > 0)
+                framesSinceSchema = 0;
         }
 
-        // Aggiungi l'header al buffer
-        if (dataBuffer.size() >= maxBufferSize)
-        {
-            dataBuffer.pop_front();
-            bufferFull = true;
-        }
-        dataBuffer.push_back(headerRow);
-    }
-    else
-    {
-        // Aggiungi i valori delle variabili
-        std::vector<std::string> dataRow;
-        dataRow.push_back(std::to_string(currentCycle)); // Numero ciclo
-        for (size_t i = 1; i < tempDataRow.size(); i += 2)
+        // Ogni datagramma riparte da zero e riporta la generazione dello schema con cui è
+        // codificato: una perdita non compromette i successivi
+        const uint16_t generation = encoder.getGeneration();
+        stream.begin(TELEMETRY_FRAME::DELTA, &generation, sizeof(generation));
+        encoder.reset();
+        uint8_t row[TELEMETRY_ENCODED_MAX];
+        size_t rows = 0;
+        const TelemetryRecord *record;
+        while ((record = dataBuffer.peek(rows)) != nullptr && stream.append(row, encoder.encode(*record, row)))
+            rows++;
+        framesSinceSchema++;
+#else
+        stream.begin(TELEMETRY_FRAME::DATA);
+        size_t rows = 0;
+        const TelemetryRecord *record;
+        while ((record = dataBuffer.peek(rows)) != nullptr && stream.append(record, sizeof(TelemetryRecord)))
+            rows++;
+#endif
+
+        // UDP non ritrasmette: i record escono dalla coda comunque e la sequenza segnala la perdita
+        const size_t frameBytes = stream.size();
+        const size_t sent = stream.send(serverAddress, TELEMETRY_UDP_PORT);
+        dataBuffer.pop(rows);
+        budget -= frameBytes;
+
+        if (sent > 0)
         {
-            dataRow.push_back(tempDataRow[i]); // Valori delle variabili
+            uploadStats.rows += rows;
+            uploadStats.bytes += sent;
+            uploadStats.requests++;
+            statsWindowRows += rows;
+            statsWindowBytes += sent;
         }
-
-        // Aggiungi i dati al buffer
-        if (dataBuffer.size() >= maxBufferSize)
+        else
         {
-            dataBuffer.pop_front();
-            bufferFull = true;
+            uploadStats.failures++;
         }
-        dataBuffer.push_back(dataRow);
     }
-
-    // Svuota la riga temporanea
-    tempDataRow.clear();
-}
-
-void Logger::sendDataToServer()
-{
+#else
     WiFiManager &wifiManager = WiFiManager::getInstance();
     const char *serverAddress = wifiManager.serverAddress;
     uint16_t serverPort = wifiManager.serverPort;
 
-    String serverUrl = String("http://") + serverAddress + ":" + String(serverPort) + "/receive_data";
-
-    if (dataBuffer.empty())
+    if (dataBuffer.front() == nullptr)
         return;
 
-    std::vector<std::string> row;
-
+    // Il batch è un array JSON di righe; la prima riga mai inviata è l'header con i nomi delle colonne
+    const unsigned long start = micros();
+    const bool sendingHeader = !headerInitialized;
+    size_t length = 0;
+    dataBatch[length++] = '[';
+    if (sendingHeader)
+        length += telemetry_format_header(channels, startTimestamp, dataBatch + length, sizeof(dataBatch) - length);
+
+    // Aggiunge righe finché restano record, spazio (separatore e chiusura inclusi) e tempo
+    size_t rows = 0;
+    while (micros() - start < TELEMETRY_BATCH_TIME_US)
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        row = dataBuffer.front();
+        const TelemetryRecord *record = dataBuffer.peek(rows);
+        if (record == nullptr)
+            break;
+
+        const size_t separator = (length > 1) ? 1 : 0;
+        const size_t available = sizeof(dataBatch) - length - separator - 1;
+        if (available < 2)
+            break;
+        const size_t written = telemetry_format_record(channels, *record, dataBatch + length + separator, available);
+        if (written + 1 >= available)
+            break; // Riga troncata: resta per il batch successivo
+
+        if (separator)
+            dataBatch[length] = ',';
+        length += separator + written;
+        rows++;
     }
 
-    String jsonData = "[";
-    for (size_t i = 0; i < row.size(); ++i)
-    {
-        jsonData += "\"" + String(row[i].c_str()) + "\"";
-        if (i < row.size() - 1)
-            jsonData += ",";
-    }
-    jsonData += "]";
+    if (rows == 0 && !sendingHeader)
+        return;
+    dataBatch[length++] = ']';
+
+    String serverUrl = String("http://") + serverAddress + ":" + String(serverPort) + "/receive_data";
 
     HTTPClient http;
     http.begin(serverUrl.c_str());
     http.addHeader("Content-Type", "application/json");
 
-    int httpResponseCode = http.POST(jsonData);
+    int httpResponseCode = http.POST(reinterpret_cast<uint8_t *>(dataBatch), length);
 
     if (httpResponseCode > 0)
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        dataBuffer.pop_front();
+        headerInitialized = true;
+        dataBuffer.pop(rows);
+        uploadStats.rows += rows;
+        uploadStats.bytes += length;
+        uploadStats.requests++;
+        statsWindowRows += rows;
+        statsWindowBytes += length;
     }
     else
     {
-        String response = "Failed to send data logs to server. HTTP error: " + String(httpResponseCode);
-        Logger::getInstance().log(LogLevel::ERROR, response.c_str());
+        uploadStats.failures++;
+        logEvent<LOG_ID::DATA_UPLOAD_FAILED>(httpResponseCode);
     }
 
     http.end();
+#endif
+}
+
+void Logger::reportUploadStats()
+{
+    const uint32_t now = millis();
+    const uint32_t elapsed = now - statsWindowStart;
+    if (elapsed < TELEMETRY_STATS_INTERVAL_MS)
+        return;
+
+    const float seconds = elapsed * 0.001f;
+    uploadStats.rowsPerSecond = statsWindowRows / seconds;
+    uploadStats.bytesPerSecond = statsWindowBytes / seconds;
+    statsWindowStart = now;
+    statsWindowRows = 0;
+    statsWindowBytes = 0;
+    reportHighWater();
+
+    if (uploadStats.rowsPerSecond > 0)
+        logEvent<LOG_ID::TELEMETRY_UPLOAD>(static_cast<uint32_t>(uploadStats.rowsPerSecond),
+                                           static_cast<uint32_t>(uploadStats.bytesPerSecond),
+                                           static_cast<uint32_t>(dataBuffer.size()));
 }
 
 void Logger::printCurrentCycleData() const
 {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex &>(mutex));
-    for (const auto &cell : tempDataRow)
+    char text[TELEMETRY_TEXT_SIZE];
+    telemetry_format_record(channels, lastRecord, text, sizeof(text));
+    Serial.println(text);
+}
+
+void Logger::reportDrops()
+{
+    const uint32_t logDrops = controlLogQueue.getDropped() + backgroundLogQueue.getDropped();
+    const uint32_t dataDrops = dataBuffer.getDropped();
+
+    if (logDrops != reportedLogDrops)
+    {
+        logEvent<LOG_ID::LOG_QUEUE_FULL>(logDrops - reportedLogDrops);
+        // Se anche questo avviso viene scartato non deve generarne un altro
+        reportedLogDrops = controlLogQueue.getDropped() + backgroundLogQueue.getDropped();
+    }
+    if (dataDrops != reportedDataDrops)
     {
-        Serial.print(cell.c_str());
-        Serial.print("\t");
+        logEvent<LOG_ID::DATA_QUEUE_FULL>(dataDrops - reportedDataDrops);
+        reportedDataDrops = dataDrops;
+        reportedLogDrops = controlLogQueue.getDropped() + backgroundLogQueue.getDropped();
     }
-    Serial.println();
 }
 
-void Logger::logTask(void *param)
+void Logger::reportHighWater()
 {
-    Logger *logger = static_cast<Logger *>(param);
+    // Solo i nuovi massimi: durante un'interruzione del WiFi mostra quanto manca agli scarti
+    const LoggerMemoryStats stats = getMemoryStats();
+    if (stats.dataHighWater <= reportedDataHighWater && stats.logHighWater <= reportedLogHighWater)
+        return;
+    reportedDataHighWater = stats.dataHighWater;
+    reportedLogHighWater = stats.logHighWater;
+    logEvent<LOG_ID::BUFFER_HIGH_WATER>(stats.dataHighWater, stats.dataCapacity, stats.logHighWater, stats.logCapacity);
+}
 
-    while (true)
+void Logger::sendLogsToServer()
+{
+#if TELEMETRY_TRANSPORT == TELEMETRY_TRANSPORT_UDP
+    const char *serverAddress = WiFiManager::getInstance().serverAddress;
+
+    static constexpr uint32_t tableHash = log_table_hash();
+
+    // Messaggi di entrambe le code impacchettati negli stessi datagrammi, a partire dal ciclo di
+    // controllo: i messaggi della tabella come identificativo e argomenti grezzi (EVENT), il
+    // testo libero già formattato (LOG)
+    SPSCRing<LogMessage> *queues[] = {&controlLogQueue, &backgroundLogQueue};
+    TELEMETRY_FRAME frameType = TELEMETRY_FRAME::EVENT;
+    for (auto *queue : queues)
     {
-        if (WiFiManager::getInstance().isServerActive())
+        const LogMessage *message;
+        while ((message = queue->front()) != nullptr)
         {
-            // Invio dei log
-            std::string logMessage;
+            const TELEMETRY_FRAME type = message->id == LOG_ID::TEXT ? TELEMETRY_FRAME::LOG : TELEMETRY_FRAME::EVENT;
+            if (stream.pending() > 0 && type != frameType && stream.send(serverAddress, TELEMETRY_UDP_PORT) == 0)
+                return;
+            if (stream.pending() == 0)
+            {
+                // L'impronta della tabella apre ogni datagramma EVENT
+                if (type == TELEMETRY_FRAME::EVENT)
+                    stream.begin(type, &tableHash, sizeof(tableHash));
+                else
+                    stream.begin(type);
+                frameType = type;
+            }
 
+            uint8_t item[LOG_LINE_SIZE];
+            size_t size;
+            if (type == TELEMETRY_FRAME::EVENT)
+            {
+                const uint16_t id = static_cast<uint16_t>(message->id);
+                memcpy(item, &message->timestamp_ms, sizeof(uint32_t));
+                memcpy(item + 4, &id, sizeof(id));
+                item[6] = message->argc;
+                memcpy(item + 7, message->args, message->argc * sizeof(uint32_t));
+                size = 7 + message->argc * sizeof(uint32_t);
+            }
+            else
             {
-                std::lock_guard<std::mutex> lock(logger->mutex);
-                if (!logger->logBuffer.empty())
-                {
-                    logMessage = logger->logBuffer.front();
-                    logger->logBuffer.pop_front();
-                }
+                size = formatLog(*message, reinterpret_cast<char *>(item), sizeof(item)) + 1;
             }
 
-            if (!logMessage.empty())
+            if (!stream.append(item, size))
             {
-                logger->sendLogToServer(logMessage);
+                // Datagramma pieno: il messaggio va nel successivo
+                if (stream.send(serverAddress, TELEMETRY_UDP_PORT) == 0)
+                    return;
+                continue;
             }
+            queue->pop();
+        }
+    }
+    if (stream.pending() > 0)
+        stream.send(serverAddress, TELEMETRY_UDP_PORT);
+#else
+    // Un messaggio per coda, a partire dal ciclo di controllo, formattato qui
+    char line[LOG_LINE_SIZE];
+    const LogMessage *message = controlLogQueue.front();
+    if (message != nullptr)
+    {
+        formatLog(*message, line, sizeof(line));
+        sendLogToServer(line);
+        controlLogQueue.pop();
+    }
+
+    message = backgroundLogQueue.front();
+    if (message != nullptr)
+    {
+        formatLog(*message, line, sizeof(line));
+        sendLogToServer(line);
+        backgroundLogQueue.pop();
+    }
+#endif
+}
+
+bool Logger::nextSerialLine()
+{
+    // Gli scarti vengono segnalati sulla seriale stessa, prima delle righe successive
+    const uint32_t drops = controlSerialQueue.getDropped() + backgroundSerialQueue.getDropped();
+    if (drops != reportedSerialDrops)
+    {
+        LogMessage notice = {};
+        notice.timestamp_ms = millis();
+        notice.level = log_message_info(LOG_ID::SERIAL_QUEUE_FULL).level;
+        notice.id = LOG_ID::SERIAL_QUEUE_FULL;
+        notice.argc = 1;
+        notice.args[0] = drops - reportedSerialDrops;
+        serialLineLength = formatLog(notice, serialLine, LOG_LINE_SIZE);
+        reportedSerialDrops = drops;
+    }
+    else
+    {
+        // Prima i messaggi del ciclo di controllo, come per il server
+        SPSCQueue<LogMessage, LOG_QUEUE_SIZE> *queue = &controlSerialQueue;
+        const LogMessage *message = queue->front();
+        if (message == nullptr)
+        {
+            queue = &backgroundSerialQueue;
+            message = queue->front();
+        }
+        if (message == nullptr)
+            return false;
+
+        serialLineLength = formatLog(*message, serialLine, LOG_LINE_SIZE);
+        queue->pop();
+    }
+
+    serialLine[serialLineLength++] = '\r';
+    serialLine[serialLineLength++] = '\n';
+    serialLineWritten = 0;
+    return true;
+}
+
+void Logger::writeSerialLogs()
+{
+    // Solo lo spazio libero nel buffer della UART: la trasmissione procede da interrupt
+    while (serialLineWritten < serialLineLength || nextSerialLine())
+    {
+        const int room = Serial.availableForWrite();
+        if (room <= 0)
+            return;
+
+        const size_t remaining = serialLineLength - serialLineWritten;
+        const size_t n = remaining < static_cast<size_t>(room) ? remaining : static_cast<size_t>(room);
+        serialLineWritten += Serial.write(reinterpret_cast<const uint8_t *>(serialLine) + serialLineWritten, n);
+    }
+}
+
+void Logger::serialLogTask(void *param)
+{
+    Logger *logger = static_cast<Logger *>(param);
+    std::unique_lock<std::mutex> serial(logger->serialMutex, std::defer_lock);
+
+    while (true)
+    {
+        SerialCommands::getInstance().poll();
+        if (!serial.owns_lock())
+            serial.lock();
+        logger->writeSerialLogs();
+
+        // La UART viene ceduta solo tra una riga e l'altra, mai con una riga scritta a metà
+        if (logger->serialLineWritten == logger->serialLineLength)
+            serial.unlock();
+        vTaskDelay(LOG_SERIAL_PERIOD_MS / portTICK_PERIOD_MS);
+    }
+}
+
+void Logger::acquireSerial()
+{
+    serialMutex.lock();
+}
+
+void Logger::releaseSerial()
+{
+    serialMutex.unlock();
+}
+
+bool Logger::telemetryCommand(void *context, const char *arguments)
+{
+    static_cast<Logger *>(context)->configureTelemetry(arguments);
+    return true;
+}
+
+void Logger::configureTelemetry(const char *arguments)
+{
+    // "<canale> <divisore>" oppure "all <divisore>"
+    static_assert(TELEMETRY_CHANNEL_NAME_SIZE == 16, "Larghezza di %s da allineare al nome dei canali");
+    char name[TELEMETRY_CHANNEL_NAME_SIZE];
+    unsigned divider;
+    if (sscanf(arguments, "%15s %u", name, &divider) != 2 || divider > UINT8_MAX)
+    {
+        logEvent<LOG_ID::TELEMETRY_CHANNEL_UNKNOWN>();
+        return;
+    }
+
+    const bool all = strcmp(name, "all") == 0;
+    const int id = all ? 0 : channels.find(name);
+    if (id < 0)
+    {
+        logEvent<LOG_ID::TELEMETRY_CHANNEL_UNKNOWN>();
+        return;
+    }
+
+    const int last = all ? channels.size() - 1 : id;
+    for (int i = id; i <= last; ++i)
+    {
+        channels.setDivider(static_cast<uint8_t>(i), static_cast<uint8_t>(divider));
+        logEvent<LOG_ID::TELEMETRY_CHANNEL_SET>(static_cast<uint32_t>(i), divider);
+    }
+}
+
+void Logger::logTask(void *param)
+{
+    Logger *logger = static_cast<Logger *>(param);
+
+    while (true)
+    {
+        logger->reportDrops();
+        logger->reportUploadStats();
+
+        if (WiFiManager::getInstance().isServerActive())
+        {
+            // Invio dei log
+            logger->sendLogsToServer();
 
-            // Invio dei dati
+            // Invio dei dati accumulati dal ciclo precedente
             logger->sendDataToServer();
         }
 
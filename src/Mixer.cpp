@@ -0,0 +1,176 @@
+#include "Mixer.h"
+#include "AirframeConfig.h"
+#include "Logger.h"
+#include <math.h>
+
+using Airframe = ActiveAirframe::profile; ///< Profilo di velivolo selezionato.
+
+/**
+ * Funzione per limitare un valore all'interno di un intervallo.
+ */
+template <typename T>
+static inline T limit(T value, T min, T max)
+{
+    return (value < min) ? min : (value > max) ? max
+                                               : value;
+}
+
+/**
+ * Costruisce la configurazione di un servomotore.
+ */
+static MixerRule servo_rule(float x, float y, float z, float throttle)
+{
+    return {{x, y, z, throttle},
+            static_cast<int>(Airframe::servo_pwm.min),
+            static_cast<int>(Airframe::servo_pwm_neutral),
+            static_cast<int>(Airframe::servo_pwm.max),
+            0,
+            false};
+}
+
+/**
+ * Costruisce la configurazione di un motore (neutro al minimo).
+ */
+static MixerRule motor_rule(float x, float y, float z, float throttle)
+{
+    return {{x, y, z, throttle},
+            static_cast<int>(Airframe::esc_pwm.min),
+            static_cast<int>(Airframe::esc_pwm.min),
+            static_cast<int>(Airframe::esc_pwm.max),
+            0,
+            false};
+}
+
+Mixer::Mixer(MIXER_LAYOUT layout)
+    : input_min{Airframe::roll.min, Airframe::pitch.min, Airframe::yaw.min, Airframe::throttle.min},
+      input_max{Airframe::roll.max, Airframe::pitch.max, Airframe::yaw.max, Airframe::throttle.max}
+{
+    set_layout(layout);
+    Logger::getInstance().log(LogLevel::INFO, "Mixer setup complete.");
+}
+
+void Mixer::set_layout(MIXER_LAYOUT layout)
+{
+    // Uscite: 0 = canale X, 1 = canale Y, 2 = canale Z, 3 = ESC
+    switch (layout)
+    {
+    case MIXER_LAYOUT::ELEVON:
+        rules[0] = servo_rule(1, 1, 0, 0);  // Elevone sinistro
+        rules[1] = servo_rule(-1, 1, 0, 0); // Elevone destro
+        rules[2] = servo_rule(0, 0, 1, 0);  // Timone (se presente)
+        rules[3] = motor_rule(0, 0, 0, 1);
+        break;
+    case MIXER_LAYOUT::V_TAIL:
+        rules[0] = servo_rule(1, 0, 0, 0);  // Alettoni
+        rules[1] = servo_rule(0, 1, 1, 0);  // Ruddervator sinistro
+        rules[2] = servo_rule(0, 1, -1, 0); // Ruddervator destro
+        rules[3] = motor_rule(0, 0, 0, 1);
+        break;
+    case MIXER_LAYOUT::FLAPERON:
+        rules[0] = servo_rule(1, 0, 0, 0);  // Flaperone sinistro (flap tramite trim)
+        rules[1] = servo_rule(0, 1, 0, 0);  // Elevatore
+        rules[2] = servo_rule(-1, 0, 0, 0); // Flaperone destro (flap tramite trim)
+        rules[3] = motor_rule(0, 0, 0, 1);
+        break;
+    case MIXER_LAYOUT::DIFFERENTIAL_THRUST:
+        rules[0] = servo_rule(1, 0, 0, 0);                       // Alettoni
+        rules[1] = servo_rule(0, 1, 0, 0);                       // Elevatore
+        rules[2] = motor_rule(0, 0, -DIFFERENTIAL_THRUST_YAW, 1); // Motore sinistro
+        rules[3] = motor_rule(0, 0, DIFFERENTIAL_THRUST_YAW, 1);  // Motore destro
+        break;
+    case MIXER_LAYOUT::STANDARD:
+    default:
+        rules[0] = servo_rule(1, 0, 0, 0); // Alettoni
+        rules[1] = servo_rule(0, 1, 0, 0); // Elevatore
+        rules[2] = servo_rule(0, 0, 1, 0); // Timone
+        rules[3] = motor_rule(0, 0, 0, 1);
+        break;
+    }
+
+    for (size_t i = 0; i < MIXER_OUTPUTS; ++i)
+        precompute(i);
+}
+
+void Mixer::set_rule(size_t index, const MixerRule &rule)
+{
+    if (index >= MIXER_OUTPUTS)
+        return;
+    rules[index] = rule;
+    precompute(index);
+}
+
+void Mixer::set_trim(size_t index, int trim)
+{
+    if (index >= MIXER_OUTPUTS)
+        return;
+    rules[index].trim = trim;
+    precompute(index);
+}
+
+void Mixer::set_endpoints(size_t index, int pwm_min, int pwm_max)
+{
+    if (index >= MIXER_OUTPUTS)
+        return;
+    rules[index].pwm_min = pwm_min;
+    rules[index].pwm_max = pwm_max;
+    precompute(index);
+}
+
+void Mixer::set_reversed(size_t index, bool reversed)
+{
+    if (index >= MIXER_OUTPUTS)
+        return;
+    rules[index].reversed = reversed;
+    precompute(index);
+}
+
+void Mixer::precompute(size_t index)
+{
+    const MixerRule &rule = rules[index];
+
+    // Escursione massima attorno alla posizione neutra
+    float span = fmaxf(rule.pwm_max - rule.pwm_neutral, rule.pwm_neutral - rule.pwm_min);
+    float sign = rule.reversed ? -1.0f : 1.0f;
+    float constant = rule.pwm_neutral + rule.trim;
+
+    for (size_t j = 0; j < MIXER_INPUTS; ++j)
+    {
+        // Normalizzazione dell'ingresso: assi in [-1, 1], throttle in [0, 1]
+        float range = input_max[j] - input_min[j];
+        float scale, offset;
+        if (j == MIXER_INPUTS - 1)
+        {
+            scale = 1.0f / range;
+            offset = -input_min[j] / range;
+        }
+        else
+        {
+            scale = 2.0f / range;
+            offset = -(input_max[j] + input_min[j]) / range;
+        }
+
+        float gain = limit(rule.weight[j], -MIXER_MAX_WEIGHT, MIXER_MAX_WEIGHT) * sign * span;
+        coefficient[index][j] = static_cast<int32_t>(lroundf(gain * scale * 256.0f));
+        constant += gain * offset;
+    }
+
+    bias[index] = static_cast<int32_t>(lroundf(constant * 65536.0f));
+}
+
+void Mixer::mix(const Output &output, int pwm[MIXER_OUTPUTS]) const
+{
+    // Quantizza gli ingressi una sola volta per ciclo (Q8)
+    const float values[MIXER_INPUTS] = {output.x, output.y, output.z, output.throttle};
+    int32_t inputs[MIXER_INPUTS];
+    for (size_t j = 0; j < MIXER_INPUTS; ++j)
+        inputs[j] = static_cast<int32_t>(limit(values[j], input_min[j], input_max[j]) * 256.0f);
+
+    for (size_t i = 0; i < MIXER_OUTPUTS; ++i)
+    {
+        int32_t acc = bias[i];
+        for (size_t j = 0; j < MIXER_INPUTS; ++j)
+            acc += coefficient[i][j] * inputs[j];
+
+        pwm[i] = limit(static_cast<int>((acc + 32768) >> 16), rules[i].pwm_min, rules[i].pwm_max);
+    }
+}
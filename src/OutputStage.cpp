@@ -0,0 +1,50 @@
+#include "OutputStage.h"
+#include "Logger.h"
+
+OutputStage::OutputStage(Actuator &servo_x, Actuator &servo_y, Actuator &servo_z, Actuator &esc)
+    : actuators{&servo_x, &servo_y, &servo_z, &esc}, pending{}, stats{}
+{
+    Logger::getInstance().log(LogLevel::INFO, "Output stage setup complete.");
+}
+
+void OutputStage::stage(const int pwm[MIXER_OUTPUTS])
+{
+    for (size_t i = 0; i < MIXER_OUTPUTS; ++i)
+    {
+        pending[i] = actuators[i]->stage(pwm[i]);
+        if (pending[i])
+            stats.writes_issued++;
+        else
+            stats.writes_skipped++;
+    }
+}
+
+void OutputStage::commit()
+{
+    // I duty sono già convertiti in `stage`: nella sezione critica solo scritture dei registri
+    // LEDC, senza chiamate al driver. Ogni canale applica il nuovo valore al termine del periodo
+    // del proprio timer, quindi cambiano insieme solo i canali dello stesso timer (i servo tra
+    // loro); l'ESC, su un altro timer, segue il proprio periodo
+    portENTER_CRITICAL(&mux);
+    for (size_t i = 0; i < MIXER_OUTPUTS; ++i)
+    {
+        if (pending[i] && !actuators[i]->is_dshot())
+            actuators[i]->apply();
+    }
+    for (size_t i = 0; i < MIXER_OUTPUTS; ++i)
+    {
+        if (pending[i] && !actuators[i]->is_dshot())
+            actuators[i]->latch();
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // I frame DShot attendono la fine della trasmissione e restano fuori dalla sezione critica
+    for (size_t i = 0; i < MIXER_OUTPUTS; ++i)
+    {
+        if (pending[i] && actuators[i]->is_dshot())
+            actuators[i]->apply();
+        pending[i] = false;
+    }
+
+    stats.commits++;
+}
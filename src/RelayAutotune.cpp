@@ -0,0 +1,109 @@
+#include "RelayAutotune.h"
+#include <math.h>
+
+#define AUTOTUNE_SKIP_PERIODS 1 ///< Periodi iniziali scartati come transitorio.
+
+RelayAutotune::RelayAutotune(float amplitude, float hysteresis, int cycles, float timeout)
+    : amplitude(amplitude), hysteresis(hysteresis), cycles(cycles), timeout(timeout),
+      state(AUTOTUNE_STATE::IDLE), result{0, 0, 0, 0, 0}
+{
+    stop();
+}
+
+void RelayAutotune::start(float amplitude, float hysteresis)
+{
+    this->amplitude = amplitude;
+    this->hysteresis = hysteresis;
+    state = AUTOTUNE_STATE::RUNNING;
+    output = amplitude;
+    elapsed = 0;
+    last_rise = -1;
+    peak_max = -INFINITY;
+    peak_min = INFINITY;
+    periods = 0;
+    sum_period = 0;
+    sum_amplitude = 0;
+}
+
+void RelayAutotune::stop()
+{
+    state = AUTOTUNE_STATE::IDLE;
+    output = 0;
+}
+
+void RelayAutotune::complete_period()
+{
+    const float period = elapsed - last_rise;
+    const float half_swing = 0.5f * (peak_max - peak_min);
+
+    if (++periods <= AUTOTUNE_SKIP_PERIODS)
+        return;
+
+    sum_period += period;
+    sum_amplitude += half_swing;
+
+    if (periods < AUTOTUNE_SKIP_PERIODS + cycles)
+        return;
+
+    const float a = sum_amplitude / cycles;
+    const float tu = sum_period / cycles;
+
+    // Con isteresi l'errore commuta a ±ε: si corregge l'ampiezza della funzione descrittiva
+    const float a_eff = (a > hysteresis) ? sqrtf(a * a - hysteresis * hysteresis) : 0;
+    if (a_eff <= 0 || tu <= 0)
+    {
+        state = AUTOTUNE_STATE::FAILED;
+        output = 0;
+        return;
+    }
+
+    const float ku = 4.0f * amplitude / (static_cast<float>(M_PI) * a_eff);
+    const float kp = 0.6f * ku;
+
+    result.ku = ku;
+    result.tu = tu;
+    result.kp = kp;
+    result.ki = kp / (0.5f * tu);
+    result.kd = kp * (0.125f * tu);
+
+    state = AUTOTUNE_STATE::DONE;
+    output = 0;
+}
+
+float RelayAutotune::update(float error, float dt)
+{
+    if (state != AUTOTUNE_STATE::RUNNING)
+        return 0;
+
+    elapsed += dt;
+    if (elapsed > timeout)
+    {
+        state = AUTOTUNE_STATE::FAILED;
+        output = 0;
+        return 0;
+    }
+
+    if (error > peak_max)
+        peak_max = error;
+    if (error < peak_min)
+        peak_min = error;
+
+    // Relè con isteresi: commuta solo quando l'errore supera la soglia opposta
+    if (output < 0 && error > hysteresis)
+    {
+        output = amplitude;
+
+        // Ogni commutazione positiva chiude un periodo
+        if (last_rise >= 0)
+            complete_period();
+        last_rise = elapsed;
+        peak_max = error;
+        peak_min = error;
+    }
+    else if (output > 0 && error < -hysteresis)
+    {
+        output = -amplitude;
+    }
+
+    return output;
+}
@@ -0,0 +1,74 @@
+#include "SerialCommands.h"
+#include "Logger.h"
+#include <Arduino.h>
+#include <string.h>
+
+SerialCommands::SerialCommands()
+{
+    // Costruttore vuoto
+}
+
+SerialCommands &SerialCommands::getInstance()
+{
+    static SerialCommands instance;
+    return instance;
+}
+
+bool SerialCommands::add(const char *name, SerialCommandHandler handler, void *context)
+{
+    const uint8_t n = count.load(std::memory_order_relaxed);
+    if (n >= SERIAL_COMMAND_HANDLERS || name == nullptr || handler == nullptr || strchr(name, ' ') != nullptr)
+        return false;
+
+    entries[n] = {name, handler, context};
+    count.store(n + 1, std::memory_order_release);
+    return true;
+}
+
+void SerialCommands::poll()
+{
+    while (Serial.available() > 0)
+    {
+        const int c = Serial.read();
+        if (c < 0)
+            break;
+        if (c != '\n' && c != '\r')
+        {
+            if (length < sizeof(line) - 1)
+                line[length++] = static_cast<char>(c);
+            else
+                overflow = true;
+            continue;
+        }
+
+        line[length] = '\0';
+        if (overflow)
+            Logger::getInstance().logEvent<LOG_ID::SERIAL_COMMAND_UNKNOWN>();
+        else if (length > 0)
+            dispatch();
+        length = 0;
+        overflow = false;
+    }
+}
+
+void SerialCommands::dispatch()
+{
+    // "<nome> <argomenti>": il nome termina al primo spazio
+    char *arguments = strchr(line, ' ');
+    if (arguments != nullptr)
+        *arguments++ = '\0';
+    else
+        arguments = line + length;
+
+    const uint8_t n = count.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        if (strcmp(entries[i].name, line) == 0)
+        {
+            if (!entries[i].handler(entries[i].context, arguments))
+                Logger::getInstance().logEvent<LOG_ID::SERIAL_COMMAND_UNKNOWN>();
+            return;
+        }
+    }
+    Logger::getInstance().logEvent<LOG_ID::SERIAL_COMMAND_UNKNOWN>();
+}
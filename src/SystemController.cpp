@@ -1,24 +1,13 @@
 #include "SystemController.h"
+#include "AirframeConfig.h"
 #include "Logger.h"
 #include "prayers.h"
 #include <Arduino.h>
 
-/**
- * @brief Funzione generica per verificare se un valore è in un intervallo.
- */
-template <typename T, typename U, typename V>
-bool isInRange(T value, U min, V max)
-{
-    T lower = (min <= max) ? min : max;
-    T upper = (min <= max) ? max : min;
-
-    return value >= lower && value <= upper;
-}
-
 SystemController::SystemController() : state(CONTROLLER_STATE::DISARMED),
                                        assist_mode(ASSIST_MODE::MANUAL),
                                        controller_mode(CONTROLLER_MODE::STANDARD),
-                                       calibration_target(CALIBRATION_TARGET::X)
+                                       calibration_target(static_cast<CALIBRATION_TARGET>(TUNING_TARGET_AXIS))
 {
     // Inizializza gli stati del sistema
     error.IMU_ERROR = false;
@@ -30,38 +19,38 @@ void SystemController::start()
 {
     // Porta il sistema in stato armato
     state = CONTROLLER_STATE::ARMED;
-    Logger::getInstance().log(LogLevel::INFO, "Controller state set -> ARMED.");
+    Logger::getInstance().logEvent<LOG_ID::STATE_ARMED>();
 }
 
 void SystemController::stop()
 {
     // Porta il sistema in stato disarmato
     if (state == CONTROLLER_STATE::FAILSAFE)
-        Logger::getInstance().log(LogLevel::WARNING, "Failsafe mode released.");
+        Logger::getInstance().logEvent<LOG_ID::FAILSAFE_RELEASED>();
     state = CONTROLLER_STATE::DISARMED;
-    Logger::getInstance().log(LogLevel::INFO, "Controller state set -> DISARMED.");
+    Logger::getInstance().logEvent<LOG_ID::STATE_DISARMED>();
 }
 
 void SystemController::failSafe()
 {
     // Porta il sistema in stato di failsafe
     state = CONTROLLER_STATE::FAILSAFE;
-    Logger::getInstance().log(LogLevel::WARNING, "Controller state set -> FAILSAFE.");
+    Logger::getInstance().logEvent<LOG_ID::STATE_FAILSAFE>();
 }
 
 bool SystemController::check_disarm_conditions(ReceiverData &receiver_data)
 {
     // Verifica se le condizioni per disarmare il sistema sono soddisfatte
-    return isInRange(receiver_data.z, YAW_MAX, YAW_MAX - YAW_MAX * ARM_TOLERANCE * 0.01) &&
-           isInRange(receiver_data.x, ROLL_MIN, ROLL_MIN + ROLL_MAX * ARM_TOLERANCE * 0.01) &&
+    return ActiveAirframe::arming.yaw_disarm.contains(receiver_data.z) &&
+           ActiveAirframe::arming.roll_disarm.contains(receiver_data.x) &&
            (state == CONTROLLER_STATE::ARMED || state == CONTROLLER_STATE::FAILSAFE);
 }
 
 bool SystemController::check_arm_conditions(ReceiverData &receiver_data)
 {
     // Verifica se le condizioni per armare il sistema sono soddisfatte
-    return isInRange(receiver_data.z, YAW_MIN, YAW_MIN + YAW_MAX * ARM_TOLERANCE * 0.01) &&
-           isInRange(receiver_data.x, ROLL_MAX, ROLL_MAX - ROLL_MAX * ARM_TOLERANCE * 0.01) &&
+    return ActiveAirframe::arming.yaw_arm.contains(receiver_data.z) &&
+           ActiveAirframe::arming.roll_arm.contains(receiver_data.x) &&
            (state == CONTROLLER_STATE::DISARMED);
 }
 
@@ -78,21 +67,21 @@ void SystemController::check_errors()
     }
     else if (!error.IMU_ERROR && !error.RECEIVER_ERROR && state == CONTROLLER_STATE::FAILSAFE)
     {
-        Logger::getInstance().log(LogLevel::WARNING, "Failsafe mode released.");
+        Logger::getInstance().logEvent<LOG_ID::FAILSAFE_RELEASED>();
         state = CONTROLLER_STATE::ARMED;
     }
     else if (error.IMU_ERROR)
     {
-        Logger::getInstance().log(LogLevel::ERROR, "IMU error detected.");
+        Logger::getInstance().logEvent<LOG_ID::IMU_ERROR>();
         assist_mode = ASSIST_MODE::MANUAL;
-        Logger::getInstance().log(LogLevel::WARNING, "Assist mode set -> Manual");
+        Logger::getInstance().logEvent<LOG_ID::FAILSAFE_ASSIST_MANUAL>();
         failSafe();
     }
     else if (error.RECEIVER_ERROR && state == CONTROLLER_STATE::ARMED)
     {
-        Logger::getInstance().log(LogLevel::ERROR, "Receiver error detected.");
+        Logger::getInstance().logEvent<LOG_ID::RECEIVER_ERROR>();
         assist_mode = ASSIST_MODE::ATTITUDE_CONTROL;
-        Logger::getInstance().log(LogLevel::WARNING, "Assist mode set -> Attitude control");
+        Logger::getInstance().logEvent<LOG_ID::FAILSAFE_ASSIST_ATTITUDE>();
         failSafe();
     }
     error_prev.IMU_ERROR = error.IMU_ERROR;
@@ -102,8 +91,9 @@ void SystemController::check_errors()
 void SystemController::update_state(ReceiverData &receiver_data)
 {
     // Aggiorna lo stato del sistema in base alle condizioni di armamento e disarmo
-    if ((receiver_data.throttle >= THROTTLE_MIN && receiver_data.throttle <= THROTTLE_MIN + THROTTLE_MAX * ARM_TOLERANCE * 0.01) &&
-        -receiver_data.y >= PITCH_MIN && -receiver_data.y <= PITCH_MIN + PITCH_MAX * ARM_TOLERANCE * 0.01)
+    // Finestre degli stick precalcolate in compilazione
+    if (ActiveAirframe::arming.throttle_gate.contains(receiver_data.throttle) &&
+        ActiveAirframe::arming.pitch_gate.contains(-receiver_data.y))
     {
         if (check_disarm_conditions(receiver_data))
         {
@@ -129,12 +119,12 @@ void SystemController::update_modes(ReceiverData &receiver_data, bool imuSetupCo
         if (assist_mode != ASSIST_MODE::MANUAL)
         {
             assist_mode = ASSIST_MODE::MANUAL;
-            Logger::getInstance().log(LogLevel::WARNING, "IMU not set up. Assist mode set -> Manual");
+            Logger::getInstance().logEvent<LOG_ID::IMU_MISSING_ASSIST_MANUAL>();
         }
         if (controller_mode != CONTROLLER_MODE::STANDARD)
         {
             controller_mode = CONTROLLER_MODE::STANDARD;
-            Logger::getInstance().log(LogLevel::WARNING, "IMU not set up. Controller mode set -> Standard");
+            Logger::getInstance().logEvent<LOG_ID::IMU_MISSING_MODE_STANDARD>();
         }
         return;
     }
@@ -144,7 +134,7 @@ void SystemController::update_modes(ReceiverData &receiver_data, bool imuSetupCo
         int swa;
         int swb;
         ASSIST_MODE mode;
-        const char *message;
+        LOG_ID message;
     };
 
     struct ControllerModeMapping
@@ -152,30 +142,39 @@ void SystemController::update_modes(ReceiverData &receiver_data, bool imuSetupCo
         int swd;
         int swc;
         CONTROLLER_MODE mode;
-        const char *message;
+        LOG_ID message;
     };
 
     AssistModeMapping assist_modes[] = {
-        {0, -1, ASSIST_MODE::MANUAL, "Assist mode set -> Manual"},
-        {1, 0, ASSIST_MODE::GYRO_STABILIZED, "Assist mode set -> Gyro stabilized"},
-        {1, 1, ASSIST_MODE::ATTITUDE_CONTROL, "Assist mode set -> Attitude control"},
+#if LQR_ENABLED
+        {0, 1, ASSIST_MODE::LQR_CONTROL, LOG_ID::ASSIST_LQR_CONTROL},
+#endif
+        {0, -1, ASSIST_MODE::MANUAL, LOG_ID::ASSIST_MANUAL},
+        {1, 0, ASSIST_MODE::GYRO_STABILIZED, LOG_ID::ASSIST_GYRO_STABILIZED},
+        {1, 1, ASSIST_MODE::ATTITUDE_CONTROL, LOG_ID::ASSIST_ATTITUDE_CONTROL},
     };
 
     ControllerModeMapping controller_modes[] = {
-        {0, -1, CONTROLLER_MODE::STANDARD, "Controller mode set -> Standard"},
-        {1, 0, CONTROLLER_MODE::KP_CALIBRATION, "Controller mode set -> KP calibration"},
-        {1, 1, CONTROLLER_MODE::KI_CALIBRATION, "Controller mode set -> KI calibration"},
-        {1, 2, CONTROLLER_MODE::KD_CALIBRATION, "Controller mode set -> KD calibration"},
+#if AUTOTUNE_ENABLED
+        {0, 2, CONTROLLER_MODE::AUTOTUNE, LOG_ID::MODE_AUTOTUNE},
+#endif
+        {0, -1, CONTROLLER_MODE::STANDARD, LOG_ID::MODE_STANDARD},
+        {1, 0, CONTROLLER_MODE::KP_CALIBRATION, LOG_ID::MODE_KP_CALIBRATION},
+        {1, 1, CONTROLLER_MODE::KI_CALIBRATION, LOG_ID::MODE_KI_CALIBRATION},
+        {1, 2, CONTROLLER_MODE::KD_CALIBRATION, LOG_ID::MODE_KD_CALIBRATION},
     };
 
     for (const auto &mode : assist_modes)
     {
         if (receiver_data.swa == mode.swa &&
-            (mode.swb == -1 || receiver_data.swb == mode.swb) &&
-            assist_mode != mode.mode)
+            (mode.swb == -1 || receiver_data.swb == mode.swb))
         {
-            assist_mode = mode.mode;
-            Logger::getInstance().log(LogLevel::INFO, mode.message);
+            // La prima corrispondenza vince, anche se la modalità è già attiva
+            if (assist_mode != mode.mode)
+            {
+                assist_mode = mode.mode;
+                Logger::getInstance().logEvent(mode.message);
+            }
             break;
         }
     }
@@ -183,11 +182,14 @@ void SystemController::update_modes(ReceiverData &receiver_data, bool imuSetupCo
     for (const auto &mode : controller_modes)
     {
         if (receiver_data.swd == mode.swd &&
-            (mode.swc == -1 || receiver_data.swc == mode.swc) &&
-            controller_mode != mode.mode)
+            (mode.swc == -1 || receiver_data.swc == mode.swc))
         {
-            controller_mode = mode.mode;
-            Logger::getInstance().log(LogLevel::INFO, mode.message);
+            // La prima corrispondenza vince, anche se la modalità è già attiva
+            if (controller_mode != mode.mode)
+            {
+                controller_mode = mode.mode;
+                Logger::getInstance().logEvent(mode.message);
+            }
             break;
         }
     }
@@ -207,7 +209,7 @@ void SystemController::set_output(Output &output, ReceiverData &receiver_data, b
     {
         output = {ITSRAININGMAN, HALLELUJAH, ITSRAININGMAN, HEYMAN};
         if(!critical_error){
-            Logger::getInstance().log(LogLevel::ERROR, "Critical error detected. System halted. Prayers sent.");
+            Logger::getInstance().logEvent<LOG_ID::CRITICAL_ERROR>();
             critical_error = true;
         }
         return;
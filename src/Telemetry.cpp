@@ -0,0 +1,196 @@
+#include "Telemetry.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Fattori di quantizzazione per numero di decimali
+static const double scales[] = {1.0, 10.0, 100.0, 1000.0, 10000.0};
+
+// Aggiunge testo al buffer senza superarne la dimensione
+static void append(char *buffer, size_t size, size_t &length, const char *format, const char *text)
+{
+    if (length >= size)
+        return;
+    int written = snprintf(buffer + length, size - length, format, text);
+    if (written > 0)
+        length += static_cast<size_t>(written);
+}
+
+int TelemetryChannels::add(const char *name, size_t offset, TELEMETRY_COLUMN type, uint8_t decimals, uint8_t divider)
+{
+    const uint8_t id = count.load(std::memory_order_relaxed);
+    if (id >= TELEMETRY_MAX_CHANNELS || name == nullptr || strlen(name) >= TELEMETRY_CHANNEL_NAME_SIZE ||
+        offset % 4 != 0 || offset + 4 > sizeof(TelemetryRecord) ||
+        decimals >= sizeof(scales) / sizeof(scales[0]))
+        return -1;
+
+    channels[id] = {name, static_cast<uint16_t>(offset), type, type == TELEMETRY_COLUMN::FIXED ? decimals : static_cast<uint8_t>(0)};
+    dividers[id].store(divider, std::memory_order_relaxed);
+    count.store(id + 1, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
+    return id;
+}
+
+int TelemetryChannels::find(const char *name) const
+{
+    const uint8_t n = size();
+    for (uint8_t id = 0; id < n; ++id)
+        if (strcmp(channels[id].name, name) == 0)
+            return id;
+    return -1;
+}
+
+bool TelemetryChannels::setDivider(uint8_t id, uint8_t divider)
+{
+    if (id >= size())
+        return false;
+    dividers[id].store(divider, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+// Legge il valore a 32 bit di un canale dal record
+static inline uint32_t channel_bits(const TelemetryRecord &record, const TelemetryChannel &channel)
+{
+    uint32_t bits;
+    memcpy(&bits, reinterpret_cast<const char *>(&record) + channel.offset, sizeof(bits));
+    return bits;
+}
+
+size_t telemetry_format_header(const TelemetryChannels &channels, const char *startTimestamp, char *buffer, size_t size)
+{
+    size_t length = 0;
+    append(buffer, size, length, "[\"%s\"", startTimestamp);
+    const uint8_t n = channels.size();
+    for (uint8_t id = 0; id < n; ++id)
+        append(buffer, size, length, ",\"%s\"", channels.get(id).name);
+    append(buffer, size, length, "%s", "]");
+    return length < size ? length : size - 1;
+}
+
+size_t telemetry_format_record(const TelemetryChannels &channels, const TelemetryRecord &record, char *buffer, size_t size)
+{
+    size_t length = 0;
+    char value[32];
+
+    snprintf(value, sizeof(value), "%lu", static_cast<unsigned long>(record.cycle));
+    append(buffer, size, length, "[\"%s\"", value);
+
+    const uint8_t n = channels.size();
+    for (uint8_t id = 0; id < n; ++id)
+    {
+        const TelemetryChannel &channel = channels.get(id);
+        const uint32_t bits = channel_bits(record, channel);
+        if (channel.type == TELEMETRY_COLUMN::UNSIGNED)
+        {
+            snprintf(value, sizeof(value), "%lu", static_cast<unsigned long>(bits));
+        }
+        else
+        {
+            float v;
+            memcpy(&v, &bits, sizeof(v));
+            snprintf(value, sizeof(value), "%.*f", channel.decimals, v);
+        }
+        append(buffer, size, length, ",\"%s\"", value);
+    }
+    append(buffer, size, length, "%s", "]");
+    return length < size ? length : size - 1;
+}
+
+bool TelemetryEncoder::configure(const TelemetryChannels &registry)
+{
+    const uint16_t current = registry.getGeneration();
+    if (channels == &registry && current == generation)
+        return false;
+
+    channels = &registry;
+    generation = current;
+    count = registry.size();
+    for (uint8_t id = 0; id < count; ++id)
+        dividers[id] = registry.getDivider(id);
+    reset();
+    return true;
+}
+
+size_t TelemetryEncoder::formatSchema(uint8_t *buffer, size_t size) const
+{
+    size_t length = 0;
+    if (size < 3)
+        return 0;
+    memcpy(buffer, &generation, sizeof(generation));
+    length += sizeof(generation);
+    buffer[length++] = count;
+
+    for (uint8_t id = 0; id < count; ++id)
+    {
+        const TelemetryChannel &channel = channels->get(id);
+        const size_t nameSize = strlen(channel.name) + 1;
+        if (size - length < 3 + nameSize)
+            return 0;
+        buffer[length++] = static_cast<uint8_t>(channel.type);
+        buffer[length++] = channel.decimals;
+        buffer[length++] = dividers[id];
+        memcpy(buffer + length, channel.name, nameSize);
+        length += nameSize;
+    }
+    return length;
+}
+
+void TelemetryEncoder::reset()
+{
+    memset(previous, 0, sizeof(previous));
+}
+
+// Arrotonda all'intero più vicino saturando a 32 bit; NaN diventa 0.
+// Il prodotto in double è esatto e lrint arrotonda al pari: stesso risultato di "%.*f".
+static inline int32_t quantize(float v, double scale)
+{
+    const double x = v * scale;
+    if (x >= 2147483647.0)
+        return INT32_MAX;
+    if (x <= -2147483648.0)
+        return INT32_MIN;
+    if (x != x)
+        return 0;
+    return static_cast<int32_t>(lrint(x));
+}
+
+// Scrive la differenza dal valore precedente come varint zig-zag (7 bit per byte)
+static inline uint8_t *put_delta(uint8_t *out, uint32_t value, uint32_t &previous)
+{
+    const int32_t delta = static_cast<int32_t>(value - previous);
+    previous = value;
+    uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+    while (zigzag >= 0x80)
+    {
+        *out++ = static_cast<uint8_t>(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(zigzag);
+    return out;
+}
+
+size_t TelemetryEncoder::encode(const TelemetryRecord &record, uint8_t *buffer)
+{
+    uint8_t *out = buffer;
+    out = put_delta(out, record.cycle, previous[0]);
+
+    // Solo i canali previsti nel ciclo: il decodificatore li ricava dal ciclo appena letto
+    for (uint8_t id = 0; id < count; ++id)
+    {
+        const uint8_t divider = dividers[id];
+        if (divider == 0 || (divider > 1 && record.cycle % divider != 0))
+            continue;
+
+        const TelemetryChannel &channel = channels->get(id);
+        uint32_t value = channel_bits(record, channel);
+        if (channel.type == TELEMETRY_COLUMN::FIXED)
+        {
+            float v;
+            memcpy(&v, &value, sizeof(v));
+            value = static_cast<uint32_t>(quantize(v, scales[channel.decimals]));
+        }
+        out = put_delta(out, value, previous[id + 1]);
+    }
+    return static_cast<size_t>(out - buffer);
+}
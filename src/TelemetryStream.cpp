@@ -0,0 +1,55 @@
+#include "TelemetryStream.h"
+#include <string.h>
+
+TelemetryStream::TelemetryStream() : length(0), count(0), sequence(0)
+{
+}
+
+void TelemetryStream::begin(TELEMETRY_FRAME type, const void *prefix, size_t prefixSize)
+{
+    TelemetryFrameHeader header = {{'T', 'L'}, TELEMETRY_FRAME_VERSION, static_cast<uint8_t>(type), 0, 0, 0};
+    memcpy(frame, &header, sizeof(header));
+    length = sizeof(header);
+    count = 0;
+
+    if (prefix != nullptr && prefixSize <= sizeof(frame) - length)
+    {
+        memcpy(frame + length, prefix, prefixSize);
+        length += prefixSize;
+    }
+}
+
+bool TelemetryStream::append(const void *data, size_t size)
+{
+    if (length == 0 || size > sizeof(frame) - length)
+        return false;
+    memcpy(frame + length, data, size);
+    length += size;
+    count++;
+    return true;
+}
+
+size_t TelemetryStream::send(const char *address, uint16_t port)
+{
+    if (count == 0 || address == nullptr)
+        return 0;
+
+    // Sequenza, conteggio e lunghezza vengono scritti solo alla chiusura del datagramma
+    TelemetryFrameHeader header;
+    memcpy(&header, frame, sizeof(header));
+    header.sequence = sequence;
+    header.count = count;
+    header.length = static_cast<uint16_t>(length - sizeof(header));
+    memcpy(frame, &header, sizeof(header));
+
+    // La sequenza avanza anche se l'invio fallisce: il buco segnala la perdita a terra
+    sequence++;
+    const size_t sent = length;
+    count = 0;
+    length = 0;
+
+    if (!udp.beginPacket(address, port))
+        return 0;
+    udp.write(frame, sent);
+    return udp.endPacket() ? sent : 0;
+}
@@ -28,7 +28,7 @@ void WiFiManager::discoverServer(const char *serverName)
     {
         if (serviceFound)
         {
-            Logger::getInstance().log(LogLevel::WARNING, "No service found.");
+            Logger::getInstance().logEvent<LOG_ID::SERVICE_NOT_FOUND>();
             serviceFound = false;
         }
     }
@@ -36,7 +36,7 @@ void WiFiManager::discoverServer(const char *serverName)
     {
         if (!serviceFound)
         {
-            Logger::getInstance().log(LogLevel::INFO, "Service found.");
+            Logger::getInstance().logEvent<LOG_ID::SERVICE_FOUND>();
             serviceFound = true;
         }
         for (int i = 0; i < n; ++i)
@@ -51,7 +51,7 @@ void WiFiManager::discoverServer(const char *serverName)
 
                 if (!serverOk)
                 {
-                    Logger::getInstance().log(LogLevel::INFO, "Server found.");
+                    Logger::getInstance().logEvent<LOG_ID::SERVER_FOUND>();
                     serverOk = true;
                 }
                 this->serverSet = true;
@@ -60,7 +60,7 @@ void WiFiManager::discoverServer(const char *serverName)
         }
         if (serverOk)
         {
-            Logger::getInstance().log(LogLevel::WARNING, "Target server not found.");
+            Logger::getInstance().logEvent<LOG_ID::SERVER_NOT_FOUND>();
             serverOk = false;
         }
     }
@@ -122,35 +122,35 @@ void WiFiManager::WiFiConnectionTask(void *param)
         if (WiFi.status() != WL_CONNECTED)
         {
             if (manager->wifiConnected)
-                Logger::getInstance().log(LogLevel::WARNING, "WiFi connection lost.");
+                Logger::getInstance().logEvent<LOG_ID::WIFI_LOST>();
 
             manager->wifiConnected = false;
 
-            Logger::getInstance().log(LogLevel::WARNING, "Attempting to connect to WiFi...");
+            Logger::getInstance().logEvent<LOG_ID::WIFI_CONNECTING>();
             WiFi.begin(manager->ssid, manager->password);
             while (WiFi.status() != WL_CONNECTED)
                 ;
             // Configura il time NTP
-            Logger::getInstance().log(LogLevel::INFO, "Synchronizing time with NTP server...");
+            Logger::getInstance().logEvent<LOG_ID::TIME_SYNCHRONIZING>();
             configTime(0, 0, "pool.ntp.org");
             while (time(nullptr) < 24 * 3600)
             {
                 delay(100); // Aspetta che l'ora venga sincronizzata
             }
-            Logger::getInstance().log(LogLevel::INFO, "Time synchronized.");
+            Logger::getInstance().logEvent<LOG_ID::TIME_SYNCHRONIZED>();
 
             // Avvia il mDNS
             if (!MDNS.begin("esp32"))
             {
-                Logger::getInstance().log(LogLevel::ERROR, "Error starting mDNS.");
+                Logger::getInstance().logEvent<LOG_ID::MDNS_FAILED>();
             }
             else
             {
-                Logger::getInstance().log(LogLevel::INFO, "mDNS responder started.");
+                Logger::getInstance().logEvent<LOG_ID::MDNS_STARTED>();
             }
 
             manager->wifiConnected = true;
-            Logger::getInstance().log(LogLevel::INFO, "Connected to WiFi.");
+            Logger::getInstance().logEvent<LOG_ID::WIFI_CONNECTED>();
         }
     }
 }
@@ -195,7 +195,7 @@ void WiFiManager::serverCheckTask(void *param)
             if (manager->serverStatus)
             {
                 manager->serverStatus = false;
-                Logger::getInstance().log(LogLevel::WARNING, "WiFi not connected. Skipping server check.");
+                Logger::getInstance().logEvent<LOG_ID::SERVER_CHECK_SKIPPED>();
             }
         }
         else
@@ -209,7 +209,7 @@ void WiFiManager::serverCheckTask(void *param)
                     if (!manager->serverStatus)
                     {
                         manager->serverStatus = true;
-                        Logger::getInstance().log(LogLevel::INFO, "Connection to server established.");
+                        Logger::getInstance().logEvent<LOG_ID::SERVER_CONNECTED>();
                     }
                 }
                 else
@@ -217,7 +217,7 @@ void WiFiManager::serverCheckTask(void *param)
                     if (manager->serverStatus)
                     {
                         manager->serverStatus = false;
-                        Logger::getInstance().log(LogLevel::WARNING, "Connection to server failed.");
+                        Logger::getInstance().logEvent<LOG_ID::SERVER_CONNECTION_FAILED>();
                     }
                 }
             }
@@ -0,0 +1,51 @@
+/**
+ * @file CycleCounter.h
+ * @brief Contatore di cicli per i benchmark su host.
+ */
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Legge il contatore di cicli della CPU.
+ *
+ * Su x86 usa il TSC; sulle altre architetture ricade sui nanosecondi di `steady_clock`.
+ */
+inline uint64_t cycle_count()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/**
+ * @brief Misura il minimo dei cicli di `fn` su più ripetizioni.
+ *
+ * Il minimo scarta interruzioni e cambi di contesto dell'host.
+ */
+template <typename Fn>
+uint64_t min_cycles(Fn &&fn, int repetitions)
+{
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < repetitions; ++r)
+    {
+        uint64_t start = cycle_count();
+        fn();
+        uint64_t elapsed = cycle_count() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+#endif // CYCLE_COUNTER_H
@@ -0,0 +1,53 @@
+/**
+ * @file TestSupport.h
+ * @brief Macro minime di verifica per i test su host.
+ */
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cmath>
+#include <cstdio>
+
+static int test_failures = 0; ///< Numero di verifiche fallite nel test corrente.
+
+/**
+ * @brief Verifica una condizione e registra il fallimento senza interrompere il test.
+ */
+#define CHECK(cond)                                                                       \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(cond))                                                                      \
+        {                                                                                 \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);          \
+            test_failures++;                                                              \
+        }                                                                                 \
+    } while (0)
+
+/**
+ * @brief Verifica che due valori differiscano al più di `tol`.
+ */
+#define CHECK_NEAR(a, b, tol)                                                             \
+    do                                                                                    \
+    {                                                                                     \
+        double check_a_ = (a), check_b_ = (b);                                            \
+        if (!(std::fabs(check_a_ - check_b_) <= (tol)))                                   \
+        {                                                                                 \
+            std::printf("%s:%d: check failed: %s = %g, %s = %g (tol %g)\n", __FILE__,     \
+                        __LINE__, #a, check_a_, #b, check_b_, (double)(tol));             \
+            test_failures++;                                                              \
+        }                                                                                 \
+    } while (0)
+
+/**
+ * @brief Stampa l'esito e restituisce il codice di uscita per CTest.
+ */
+inline int test_result(const char *name)
+{
+    if (test_failures == 0)
+        std::printf("%s: all checks passed\n", name);
+    else
+        std::printf("%s: %d check(s) failed\n", name, test_failures);
+    return test_failures == 0 ? 0 : 1;
+}
+
+#endif // TEST_SUPPORT_H
@@ -0,0 +1,130 @@
+/**
+ * @file ibus_cycles.cpp
+ * @brief Soglia di regressione sul costo per byte del parser IBUS nel caso peggiore.
+ *
+ * Misura cicli per byte e lavoro per byte (`ReceiverStats::maxWorkPerRead`) su flussi
+ * validi e avversari, letti a blocchi come fa `Receiver::read`, e fallisce se il caso
+ * peggiore supera `IBUS_MAX_CYCLES_PER_BYTE` o `IBUS_MAX_WORK_PER_BYTE`.
+ */
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "IBusParser.h"
+#include "CycleCounter.h"
+#include "TestSupport.h"
+
+#ifndef IBUS_MAX_CYCLES_PER_BYTE
+#define IBUS_MAX_CYCLES_PER_BYTE 120
+#endif
+
+#ifndef IBUS_MAX_WORK_PER_BYTE
+#define IBUS_MAX_WORK_PER_BYTE 40
+#endif
+
+static const size_t MAX_CHUNK = 3 * IBusParser::PACKET_SIZE; ///< Come `Receiver::MAX_BYTES_PER_READ`.
+static const size_t STREAM_SIZE = 4096;                     ///< Byte per flusso misurato.
+static const int REPETITIONS = 200;                         ///< Ripetizioni per la misura del minimo.
+
+using Stream = std::vector<uint8_t>;
+
+static Stream packet(uint16_t value, bool corrupt)
+{
+    Stream p = {IBusParser::HEADER_1, IBusParser::HEADER_2};
+    for (int i = 0; i < 14; ++i)
+    {
+        p.push_back(value & 0xFF);
+        p.push_back(value >> 8);
+    }
+    uint16_t checksum = 0xFFFF;
+    for (uint8_t b : p)
+        checksum -= b;
+    if (corrupt)
+        checksum ^= 1;
+    p.push_back(checksum & 0xFF);
+    p.push_back(checksum >> 8);
+    return p;
+}
+
+static Stream repeat(const Stream &pattern)
+{
+    Stream s;
+    while (s.size() < STREAM_SIZE)
+        s.insert(s.end(), pattern.begin(), pattern.end());
+    s.resize(STREAM_SIZE);
+    return s;
+}
+
+struct Result
+{
+    double cyclesPerByte;
+    double workPerByte;
+};
+
+static Result measure(const Stream &stream)
+{
+    ReceiverStats stats{};
+    uint64_t cycles = min_cycles(
+        [&]()
+        {
+            IBusParser parser;
+            ReceiverData data{};
+            for (size_t offset = 0; offset < stream.size(); offset += MAX_CHUNK)
+            {
+                size_t n = stream.size() - offset < MAX_CHUNK ? stream.size() - offset : MAX_CHUNK;
+                parser.parse(stream.data() + offset, n, data);
+            }
+            stats = parser.getStats();
+        },
+        REPETITIONS);
+    return {static_cast<double>(cycles) / stream.size(),
+            static_cast<double>(stats.maxWorkPerRead) / stats.maxBytesPerRead};
+}
+
+int main()
+{
+    // Un pacchetto valido seguito da uno con checksum errato: entrambi i rami del parser
+    Stream mixed = packet(1500, false);
+    Stream bad = packet(1500, true);
+    mixed.insert(mixed.end(), bad.begin(), bad.end());
+
+    // Header validi ogni 31 byte: ogni verifica fallisce e lascia quasi un pacchetto da spostare
+    Stream shifted = packet(1500, true);
+    shifted.pop_back();
+
+    std::mt19937 rng(26);
+    Stream noise(STREAM_SIZE);
+    for (uint8_t &b : noise)
+        b = rng();
+
+    const struct
+    {
+        const char *name;
+        Stream stream;
+    } cases[] = {
+        {"valid", repeat(packet(1500, false))},
+        {"valid+bad_checksum", repeat(mixed)},
+        {"bad_checksum", repeat(packet(1500, true))},
+        {"header_every_31", repeat(shifted)},
+        {"header_flood", repeat({IBusParser::HEADER_1, IBusParser::HEADER_2})},
+        {"header_1_flood", repeat({IBusParser::HEADER_1})},
+        {"random", noise},
+    };
+
+    double worstCycles = 0.0;
+    double worstWork = 0.0;
+    for (const auto &c : cases)
+    {
+        Result r = measure(c.stream);
+        std::printf("%-20s %8.1f cycles/byte %6.1f work/byte\n", c.name, r.cyclesPerByte, r.workPerByte);
+        if (r.cyclesPerByte > worstCycles)
+            worstCycles = r.cyclesPerByte;
+        if (r.workPerByte > worstWork)
+            worstWork = r.workPerByte;
+    }
+
+    std::printf("worst case: %.1f cycles/byte (limit %d), %.1f work/byte (limit %d)\n", worstCycles,
+                IBUS_MAX_CYCLES_PER_BYTE, worstWork, IBUS_MAX_WORK_PER_BYTE);
+    CHECK(worstCycles <= IBUS_MAX_CYCLES_PER_BYTE);
+    CHECK(worstWork <= IBUS_MAX_WORK_PER_BYTE);
+    return test_result("ibus_cycles");
+}
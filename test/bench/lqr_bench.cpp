@@ -0,0 +1,290 @@
+/**
+ * @file lqr_bench.cpp
+ * @brief Costo, saturazione e risposta in anello chiuso del regolatore `LQRController`.
+ *
+ * Il kernel in singola precisione viene confrontato con un riferimento in doppia precisione
+ * sugli stessi stati, sia nei valori sia nel costo per aggiornamento. La risposta in anello
+ * chiuso usa il modello da cui sono stati calcolati i guadagni: i parametri vengono letti dalla
+ * riga "Modello:" di `LQRGains.h` e discretizzati (ZOH) come in `tools/lqr_gains.py`, così il
+ * test segue il file generato senza copiarne i valori.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "CycleCounter.h"
+#include "FlightControllerConfig.h"
+#include "LQRController.h"
+#include "TestSupport.h"
+
+static const int STATES_COUNT = 4096;  ///< Stati casuali per la misura del costo.
+static const int REPETITIONS = 50;     ///< Ripetizioni per la misura del minimo.
+static const double SETTLE_TIME = 1.0; ///< Tempo di assestamento richiesto (s).
+static const double SETTLE_BAND = 0.2; ///< Banda di assestamento dell'errore di assetto (gradi).
+
+/**
+ * Riferimento in doppia precisione di u = -K (x - x_ref), con lo stesso limite.
+ * Fuori linea come il kernel, compilato in un'unità di traduzione separata.
+ */
+__attribute__((noinline)) static void reference_update(const float state[LQR_STATES], const float reference[LQR_STATES],
+                                                       double limit, double output[LQR_INPUTS])
+{
+    for (int i = 0; i < LQR_INPUTS; ++i)
+    {
+        double u = 0;
+        for (int j = 0; j < LQR_STATES; ++j)
+            u -= double(LQR_GAINS[i][j]) * (double(state[j]) - double(reference[j]));
+        output[i] = u > limit ? limit : (u < -limit ? -limit : u);
+    }
+}
+
+/**
+ * Legge i parametri del modello dalla riga "Modello:" dell'header generato.
+ */
+static std::map<std::string, double> read_model()
+{
+    std::map<std::string, double> model;
+    FILE *file = fopen(LQR_GAINS_HEADER, "r");
+    if (file == nullptr)
+        return model;
+    char line[512];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        const char *start = strstr(line, "Modello:");
+        if (start == nullptr)
+            continue;
+        char *cursor = const_cast<char *>(start) + strlen("Modello:");
+        char name[32];
+        double value;
+        int consumed;
+        while (sscanf(cursor, " %31[^=]=%lf%n", name, &value, &consumed) == 2)
+        {
+            model[name] = value;
+            cursor += consumed;
+            if (*cursor == ',')
+                cursor++;
+        }
+        break;
+    }
+    fclose(file);
+    return model;
+}
+
+typedef std::vector<std::vector<double>> Matrix;
+
+static Matrix multiply(const Matrix &a, const Matrix &b)
+{
+    Matrix c(a.size(), std::vector<double>(b[0].size(), 0.0));
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t k = 0; k < b.size(); ++k)
+            for (size_t j = 0; j < b[0].size(); ++j)
+                c[i][j] += a[i][k] * b[k][j];
+    return c;
+}
+
+/**
+ * Modello continuo di `tools/lqr_gains.py` discretizzato (ZOH) con l'esponenziale della
+ * matrice aumentata [[A, B], [0, 0]] dt.
+ */
+static void discrete_model(std::map<std::string, double> &p, Matrix &ad, Matrix &bd)
+{
+    const int n = LQR_STATES, m = LQR_INPUTS;
+    Matrix aug(n + m, std::vector<double>(n + m, 0.0));
+    const double dt = p["dt"];
+    for (int i = 0; i < 3; ++i)
+        aug[i][3 + i] = dt;
+    aug[3][3] = p["Lp"] * dt;
+    aug[3][5] = p["Lr"] * dt;
+    aug[3][n + 0] = p["La"] * dt;
+    aug[3][n + 2] = p["Lrud"] * dt;
+    aug[4][1] = p["Mtheta"] * dt;
+    aug[4][4] = p["Mq"] * dt;
+    aug[4][n + 1] = p["Me"] * dt;
+    aug[5][3] = p["Np"] * dt;
+    aug[5][5] = p["Nr"] * dt;
+    aug[5][n + 0] = p["Na"] * dt;
+    aug[5][n + 2] = p["Nrud"] * dt;
+
+    Matrix result(n + m, std::vector<double>(n + m, 0.0)), term = result;
+    for (int i = 0; i < n + m; ++i)
+        result[i][i] = term[i][i] = 1.0;
+    for (int k = 1; k < 20; ++k)
+    {
+        term = multiply(term, aug);
+        for (auto &row : term)
+            for (double &v : row)
+                v /= k;
+        for (int i = 0; i < n + m; ++i)
+            for (int j = 0; j < n + m; ++j)
+                result[i][j] += term[i][j];
+    }
+
+    ad.assign(n, std::vector<double>(n));
+    bd.assign(n, std::vector<double>(m));
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+            ad[i][j] = result[i][j];
+        for (int j = 0; j < m; ++j)
+            bd[i][j] = result[i][n + j];
+    }
+}
+
+static void test_clamping()
+{
+    const LQRController lqr(LQR_GAINS, LQR_OUTPUT_LIMIT);
+    const float reference[LQR_STATES] = {};
+    float output[LQR_INPUTS];
+    double expected[LQR_INPUTS];
+
+    // Scostamenti grandi: ogni asse con un guadagno diretto satura esattamente al limite
+    const float large_positive[LQR_STATES] = {100, 100, 100, 0, 0, 0};
+    lqr.update(large_positive, reference, output);
+    for (int i = 0; i < LQR_INPUTS; ++i)
+        CHECK(output[i] == -LQR_OUTPUT_LIMIT);
+    const float large_negative[LQR_STATES] = {-100, -100, -100, 0, 0, 0};
+    lqr.update(large_negative, reference, output);
+    for (int i = 0; i < LQR_INPUTS; ++i)
+        CHECK(output[i] == LQR_OUTPUT_LIMIT);
+
+    // Scostamento dal riferimento, non dallo zero
+    const float state[LQR_STATES] = {3, -2, 1, 10, -5, 4};
+    const float shifted[LQR_STATES] = {4, -1, 2, 12, -3, 6};
+    const float offset[LQR_STATES] = {1, 1, 1, 2, 2, 2};
+    float direct[LQR_INPUTS];
+    lqr.update(state, reference, direct);
+    lqr.update(shifted, offset, output);
+    for (int i = 0; i < LQR_INPUTS; ++i)
+        CHECK_NEAR(output[i], direct[i], 1e-4);
+
+    // Stati casuali: uguale al riferimento in doppia precisione, saturazione inclusa
+    std::mt19937 rng(39);
+    std::uniform_real_distribution<float> attitude(-30, 30), rate(-300, 300);
+    double worst = 0;
+    int saturated = 0;
+    for (int n = 0; n < 100000; ++n)
+    {
+        const float x[LQR_STATES] = {attitude(rng), attitude(rng), attitude(rng), rate(rng), rate(rng), rate(rng)};
+        lqr.update(x, reference, output);
+        reference_update(x, reference, LQR_OUTPUT_LIMIT, expected);
+        for (int i = 0; i < LQR_INPUTS; ++i)
+        {
+            worst = std::fmax(worst, std::fabs(output[i] - expected[i]));
+            saturated += std::fabs(expected[i]) == LQR_OUTPUT_LIMIT;
+            CHECK(std::fabs(output[i]) <= LQR_OUTPUT_LIMIT);
+        }
+    }
+    std::printf("float kernel vs double reference: max difference %.3g, %d saturated outputs\n", worst, saturated);
+    CHECK(worst <= 1e-5 * LQR_OUTPUT_LIMIT);
+    CHECK(saturated > 0);
+}
+
+static void test_closed_loop()
+{
+    std::map<std::string, double> model = read_model();
+    const char *required[] = {"dt", "Lp", "Lr", "Mq", "Mtheta", "Np", "Nr", "La", "Lrud", "Me", "Na", "Nrud"};
+    for (const char *name : required)
+    {
+        if (model.count(name) == 0)
+        {
+            std::printf("model parameter %s missing from %s\n", name, LQR_GAINS_HEADER);
+            CHECK(false);
+            return;
+        }
+    }
+
+    Matrix ad, bd;
+    discrete_model(model, ad, bd);
+    const LQRController lqr(LQR_GAINS, LQR_OUTPUT_LIMIT);
+    const float reference[LQR_STATES] = {};
+
+    // Errore iniziale di assetto, velocità nulle
+    double x[LQR_STATES] = {10, -5, 3, 0, 0, 0};
+    const double dt = model["dt"];
+    const int steps = static_cast<int>(3.0 / dt);
+    double settled_at = -1, peak_command = 0;
+    for (int k = 0; k < steps; ++k)
+    {
+        const float state[LQR_STATES] = {float(x[0]), float(x[1]), float(x[2]), float(x[3]), float(x[4]), float(x[5])};
+        float u[LQR_INPUTS];
+        lqr.update(state, reference, u);
+        for (int i = 0; i < LQR_INPUTS; ++i)
+            peak_command = std::fmax(peak_command, std::fabs(u[i]));
+
+        double next[LQR_STATES];
+        for (int i = 0; i < LQR_STATES; ++i)
+        {
+            next[i] = 0;
+            for (int j = 0; j < LQR_STATES; ++j)
+                next[i] += ad[i][j] * x[j];
+            for (int j = 0; j < LQR_INPUTS; ++j)
+                next[i] += bd[i][j] * u[j];
+        }
+        std::memcpy(x, next, sizeof(x));
+
+        // Istante dopo il quale l'errore di assetto resta nella banda
+        const bool inside = std::fabs(x[0]) < SETTLE_BAND && std::fabs(x[1]) < SETTLE_BAND && std::fabs(x[2]) < SETTLE_BAND;
+        if (!inside)
+            settled_at = -1;
+        else if (settled_at < 0)
+            settled_at = (k + 1) * dt;
+    }
+    std::printf("closed loop from (10, -5, 3) deg: settled within %.2f deg at %.2f s, peak command %.1f\n",
+                SETTLE_BAND, settled_at, peak_command);
+    CHECK(settled_at >= 0 && settled_at <= SETTLE_TIME);
+    CHECK(peak_command <= LQR_OUTPUT_LIMIT);
+}
+
+static void test_cost()
+{
+    const LQRController lqr(LQR_GAINS, LQR_OUTPUT_LIMIT);
+    std::mt19937 rng(40);
+    std::uniform_real_distribution<float> attitude(-30, 30), rate(-300, 300);
+    std::vector<float> states(STATES_COUNT * LQR_STATES);
+    for (size_t i = 0; i < states.size(); ++i)
+        states[i] = (i % LQR_STATES) < 3 ? attitude(rng) : rate(rng);
+    const float reference[LQR_STATES] = {};
+    std::vector<float> out_float(STATES_COUNT * LQR_INPUTS);
+    std::vector<double> out_double(STATES_COUNT * LQR_INPUTS);
+
+    auto run_float = [&]() {
+        for (int n = 0; n < STATES_COUNT; ++n)
+            lqr.update(&states[n * LQR_STATES], reference, &out_float[n * LQR_INPUTS]);
+    };
+    auto run_double = [&]() {
+        for (int n = 0; n < STATES_COUNT; ++n)
+            reference_update(&states[n * LQR_STATES], reference, LQR_OUTPUT_LIMIT, &out_double[n * LQR_INPUTS]);
+    };
+
+    const double float_cycles = static_cast<double>(min_cycles(run_float, REPETITIONS)) / STATES_COUNT;
+    const double double_cycles = static_cast<double>(min_cycles(run_double, REPETITIONS)) / STATES_COUNT;
+
+    double best_ns = 1e30;
+    for (int r = 0; r < REPETITIONS; ++r)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        run_float();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        best_ns = std::fmin(best_ns, std::chrono::duration<double, std::nano>(elapsed).count() / STATES_COUNT);
+    }
+
+    std::printf("LQRController::update (float): %.1f cycles, %.1f ns per update\n", float_cycles, best_ns);
+    std::printf("double reference:               %.1f cycles per update (%.2fx)\n", double_cycles,
+                double_cycles / float_cycles);
+
+    // Il kernel in float non deve costare più del riferimento in doppia precisione; margine
+    // ampio per il rumore di misura dell'host su un kernel di poche decine di cicli
+    CHECK(float_cycles <= 1.5 * double_cycles);
+}
+
+int main()
+{
+    test_clamping();
+    test_closed_loop();
+    test_cost();
+    return test_result("lqr_bench");
+}
@@ -0,0 +1,121 @@
+/**
+ * @file pid_scalar_bench.cpp
+ * @brief Confronto tra `AxisPID3<float>` e il riferimento `AxisPID3<double>`.
+ *
+ * Verifica che il calcolo in singola precisione segua il riferimento in doppia entro
+ * `PID_FLOAT_TOLERANCE` su una traiettoria con saturazioni e cambi di setpoint, e riporta
+ * il costo per ciclo dei due tipi. Sull'host la doppia precisione è in hardware: il
+ * risparmio del float si misura sull'ESP32-S3, dove `double` è emulato via software.
+ */
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "AxisPID3.h"
+#include "CycleCounter.h"
+#include "TestSupport.h"
+
+#ifndef PID_FLOAT_TOLERANCE
+#define PID_FLOAT_TOLERANCE 1e-4 ///< Scarto massimo ammesso rispetto al riferimento, relativo al limite dell'output.
+#endif
+
+static const int CYCLES = 20000;   ///< Cicli di controllo simulati (200 s a 100 Hz).
+static const double DT = 0.01;     ///< Periodo del loop (s).
+static const int REPETITIONS = 20; ///< Ripetizioni per la misura del minimo.
+
+struct Sample
+{
+    double error[3];
+    double measurement[3];
+    double setpoint[3];
+};
+
+static std::vector<Sample> make_trajectory()
+{
+    std::mt19937 rng(31);
+    std::normal_distribution<double> noise(0.0, 0.5);
+    std::vector<Sample> samples(CYCLES);
+    for (int n = 0; n < CYCLES; ++n)
+    {
+        double t = n * DT;
+        for (int i = 0; i < 3; ++i)
+        {
+            // Gradini di setpoint ogni 5 s e una misura che li insegue con rumore
+            double setpoint = ((n / 500 + i) % 3 - 1) * 60.0;
+            double measurement = setpoint * (1.0 - std::exp(-(n % 500) * DT * 2.0)) + 5.0 * std::sin(t * (1.0 + i)) + noise(rng);
+            samples[n].setpoint[i] = setpoint;
+            samples[n].measurement[i] = measurement;
+            samples[n].error[i] = setpoint - measurement;
+        }
+    }
+    return samples;
+}
+
+template <typename T>
+static AxisPID3<T> make_pid()
+{
+    return AxisPID3<T>({{2.0, 1.5, 1.0}, {0.5, 0.4, 0.3}, {0.05, 0.04, 0.02}, {0.1, 0.1, 0.1}},
+                       static_cast<T>(MAX_INTEGRAL_GYRO), static_cast<T>(PID_OUTPUT_LIMIT_GYRO));
+}
+
+/**
+ * Esegue la traiettoria e restituisce le uscite.
+ */
+template <typename T>
+static void run(AxisPID3<T> &pid, const std::vector<Sample> &samples, std::vector<T> &outputs)
+{
+    const AxisGains3<T> offsets = {};
+    const T dt = static_cast<T>(DT);
+    const T inv_dt = static_cast<T>(1.0 / DT);
+    for (int n = 0; n < CYCLES; ++n)
+    {
+        T e[3], m[3], sp[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            e[i] = static_cast<T>(samples[n].error[i]);
+            m[i] = static_cast<T>(samples[n].measurement[i]);
+            sp[i] = static_cast<T>(samples[n].setpoint[i]);
+        }
+        pid.update(e, m, sp, dt, inv_dt, offsets, &outputs[3 * n]);
+    }
+}
+
+template <typename T>
+static double cycles_per_update(const std::vector<Sample> &samples)
+{
+    std::vector<T> outputs(3 * CYCLES);
+    uint64_t best = min_cycles(
+        [&]()
+        {
+            AxisPID3<T> pid = make_pid<T>();
+            run(pid, samples, outputs);
+        },
+        REPETITIONS);
+    return static_cast<double>(best) / CYCLES;
+}
+
+int main()
+{
+    const std::vector<Sample> samples = make_trajectory();
+
+    AxisPID3<float> pid_float = make_pid<float>();
+    AxisPID3<double> pid_double = make_pid<double>();
+    std::vector<float> out_float(3 * CYCLES);
+    std::vector<double> out_double(3 * CYCLES);
+    run(pid_float, samples, out_float);
+    run(pid_double, samples, out_double);
+
+    double max_diff = 0.0;
+    for (int k = 0; k < 3 * CYCLES; ++k)
+        max_diff = std::fmax(max_diff, std::fabs(out_float[k] - out_double[k]));
+    const double tolerance = PID_FLOAT_TOLERANCE * PID_OUTPUT_LIMIT_GYRO;
+
+    double cost_float = cycles_per_update<float>(samples);
+    double cost_double = cycles_per_update<double>(samples);
+
+    std::printf("float vs double: max output difference %.3g (limit %.3g)\n", max_diff, tolerance);
+    std::printf("float:  %.1f cycles per 3-axis update\n", cost_float);
+    std::printf("double: %.1f cycles per 3-axis update\n", cost_double);
+    CHECK(max_diff <= tolerance);
+    return test_result("pid_scalar_bench");
+}
@@ -0,0 +1,311 @@
+/**
+ * @file telemetry_encoder_bench.cpp
+ * @brief Rapporto di compressione, correttezza e costo di `TelemetryEncoder` su un volo sintetico.
+ *
+ * I canali sono quelli registrati dall'aereo (`TELEMETRY_CHANNEL_TABLE`). Le righe vengono
+ * codificate a datagrammi come fa il task di invio (`reset` a ogni datagramma), decodificate con
+ * un decodificatore scritto dalla specifica e confrontate con i valori quantizzati. Lo schema e i
+ * primi datagrammi, con le righe attese nella vista testuale, vengono scritti in `SAMPLES_FILE`
+ * per il confronto con il decodificatore del server (`test/telemetry_roundtrip.py`). Il test
+ * fallisce se i byte per riga superano `TELEMETRY_MAX_BYTES_PER_ROW` o se la codifica costa più di
+ * `TELEMETRY_MAX_ENCODE_RATIO` volte la conversione in testo della stessa riga (misurate nello
+ * stesso processo, per non dipendere dalla velocità dell'host).
+ */
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Telemetry.h"
+#include "TelemetryChannelTable.h"
+#include "CycleCounter.h"
+#include "TestSupport.h"
+
+#ifndef TELEMETRY_MAX_BYTES_PER_ROW
+#define TELEMETRY_MAX_BYTES_PER_ROW 40
+#endif
+
+#ifndef TELEMETRY_MAX_ENCODE_RATIO
+#define TELEMETRY_MAX_ENCODE_RATIO 0.25
+#endif
+
+static const int ROWS = 20000;                          ///< Righe del volo sintetico.
+static const size_t FRAME_PAYLOAD = TELEMETRY_FRAME_BYTES - sizeof(TelemetryFrameHeader) -
+                                    sizeof(uint16_t); ///< Righe di un datagramma DELTA, dopo la generazione.
+static const int REPETITIONS = 20;                      ///< Ripetizioni per la misura del minimo.
+static const char *SAMPLES_FILE = "telemetry_samples.txt"; ///< Datagrammi e righe attese per il server.
+static const size_t SAMPLE_FRAMES = 4;                     ///< Datagrammi di dati scritti in `SAMPLES_FILE`.
+
+/**
+ * Registra i canali come `Aircraft::register_telemetry_channels`.
+ */
+static void register_channels(TelemetryChannels &registry)
+{
+    for (const TelemetryChannelSpec &channel : TELEMETRY_CHANNEL_TABLE)
+        CHECK(registry.add(channel.name, channel.offset, channel.type, TELEMETRY_CHANNEL_DECIMALS, channel.divider) >= 0);
+}
+
+/**
+ * Volo sintetico a 100 Hz: stick a gradini, assetto e velocità angolari lisce con rumore del sensore.
+ */
+static std::vector<TelemetryRecord> synthetic_flight()
+{
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0, 1);
+    std::vector<TelemetryRecord> records(ROWS);
+    for (int i = 0; i < ROWS; ++i)
+    {
+        TelemetryRecord &r = records[i];
+        const float t = i * 0.01f;
+        r = {};
+        r.cycle = i;
+        r.timestamp_us = 1000000u + i * 10000u + (i % 7);
+        r.flags = TELEMETRY_IMU_VALID | TELEMETRY_RECEIVER_VALID | ((i % 50) ? TELEMETRY_RPM_VALID : 0);
+        r.imu.gyro = {20 * std::sin(t) + 0.5f * noise(rng), 10 * std::cos(0.7f * t) + 0.5f * noise(rng), 0.3f * noise(rng)};
+        r.imu.accel = {0.1f * noise(rng), 0.1f * noise(rng), 9.81f + 0.2f * noise(rng)};
+        const float a = 0.2f * std::sin(0.3f * t);
+        r.imu.quat = {std::cos(a), 0.6f * std::sin(a), 0.8f * std::sin(a), 0};
+        r.imu.vel = 12 + 0.01f * (i % 5);
+        const float stick = std::floor(30 * std::sin(0.5f * t));
+        r.receiver = {stick, 0.5f * stick, 55, 0, 1, 0, 2, 1, 0, 0};
+        r.output = {0.8f * stick + 0.1f * noise(rng), 0.4f * stick, 0, 55};
+        r.rpm = 8000 + 200 * std::sin(t) + 5 * noise(rng);
+    }
+    // Valori limite: NaN, saturazione e arrotondamento vicino a zero
+    records[123].imu.gyro.x = NAN;
+    records[130].rpm = 1e12f; // Ciclo in cui il canale RPM è previsto
+    records[125].output.x = -0.0004999f;
+    return records;
+}
+
+/**
+ * Decodificatore dalla specifica di `TelemetryEncoder`: ciclo e canali previsti, varint zig-zag cumulati.
+ */
+struct Decoder
+{
+    std::vector<uint8_t> dividers;
+    std::vector<uint32_t> previous;
+
+    explicit Decoder(const TelemetryChannels &registry) : previous(registry.size() + 1, 0)
+    {
+        for (uint8_t id = 0; id < registry.size(); ++id)
+            dividers.push_back(registry.getDivider(id));
+    }
+
+    void reset() { std::fill(previous.begin(), previous.end(), 0); }
+
+    static uint32_t varint(const uint8_t *&in)
+    {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            const uint8_t b = *in++;
+            value |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                break;
+        }
+        return value;
+    }
+
+    static uint32_t apply(uint32_t zigzag, uint32_t &previous)
+    {
+        const int32_t delta = static_cast<int32_t>((zigzag >> 1) ^ (0u - (zigzag & 1)));
+        previous += static_cast<uint32_t>(delta);
+        return previous;
+    }
+
+    // Decodifica una riga; `values[id]` resta invariato per i canali non previsti nel ciclo
+    uint32_t row(const uint8_t *&in, std::vector<uint32_t> &values, std::vector<bool> &present)
+    {
+        const uint32_t cycle = apply(varint(in), previous[0]);
+        for (size_t id = 0; id < dividers.size(); ++id)
+        {
+            present[id] = dividers[id] != 0 && (dividers[id] == 1 || cycle % dividers[id] == 0);
+            if (present[id])
+                values[id] = apply(varint(in), previous[id + 1]);
+        }
+        return cycle;
+    }
+};
+
+/**
+ * Valore atteso di un canale: bit grezzi per UNSIGNED, intero arrotondato per FIXED.
+ */
+static uint32_t expected_value(const TelemetryRecord &record, const TelemetryChannel &channel)
+{
+    uint32_t bits;
+    std::memcpy(&bits, reinterpret_cast<const char *>(&record) + channel.offset, sizeof(bits));
+    if (channel.type == TELEMETRY_COLUMN::UNSIGNED)
+        return bits;
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    const double x = v * std::pow(10.0, channel.decimals);
+    if (x != x)
+        return 0;
+    if (x >= 2147483647.0)
+        return static_cast<uint32_t>(INT32_MAX);
+    if (x <= -2147483648.0)
+        return static_cast<uint32_t>(INT32_MIN);
+    return static_cast<uint32_t>(static_cast<int32_t>(std::nearbyint(x)));
+}
+
+/**
+ * Codifica tutte le righe a datagrammi; restituisce i datagrammi (solo payload).
+ */
+static std::vector<std::vector<uint8_t>> encode_frames(TelemetryEncoder &encoder, const std::vector<TelemetryRecord> &records,
+                                                       std::vector<uint16_t> &counts)
+{
+    std::vector<std::vector<uint8_t>> frames(1);
+    counts.assign(1, 0);
+    uint8_t row[TELEMETRY_ENCODED_MAX];
+    encoder.reset();
+    for (const TelemetryRecord &record : records)
+    {
+        size_t size = encoder.encode(record, row);
+        if (frames.back().size() + size > FRAME_PAYLOAD)
+        {
+            frames.emplace_back();
+            counts.push_back(0);
+            encoder.reset();
+            size = encoder.encode(record, row);
+        }
+        frames.back().insert(frames.back().end(), row, row + size);
+        counts.back()++;
+    }
+    return frames;
+}
+
+/**
+ * Scrive un datagramma completo (header e payload) in esadecimale.
+ */
+static void write_datagram(FILE *file, TELEMETRY_FRAME type, uint32_t sequence, uint16_t count,
+                           const std::vector<uint8_t> &payload)
+{
+    const TelemetryFrameHeader header = {{'T', 'L'}, TELEMETRY_FRAME_VERSION, static_cast<uint8_t>(type), sequence,
+                                         count, static_cast<uint16_t>(payload.size())};
+    std::vector<uint8_t> datagram(reinterpret_cast<const uint8_t *>(&header),
+                                  reinterpret_cast<const uint8_t *>(&header) + sizeof(header));
+    datagram.insert(datagram.end(), payload.begin(), payload.end());
+    std::fprintf(file, "datagram ");
+    for (uint8_t b : datagram)
+        std::fprintf(file, "%02x", b);
+    std::fprintf(file, "\n");
+}
+
+/**
+ * Scrive lo schema, i primi datagrammi DELTA e le righe che il server deve ricavarne.
+ *
+ * Formato: una riga `datagram <esadecimale>` per datagramma, seguita da una riga `row <csv>`
+ * per riga attesa (ciclo, poi i canali abilitati; vuoti quelli non previsti nel ciclo).
+ */
+static bool write_samples(const TelemetryEncoder &encoder, const TelemetryChannels &registry,
+                          const std::vector<TelemetryRecord> &records,
+                          const std::vector<std::vector<uint8_t>> &frames, const std::vector<uint16_t> &counts)
+{
+    FILE *file = std::fopen(SAMPLES_FILE, "w");
+    if (file == nullptr)
+        return false;
+
+    uint32_t sequence = 0;
+    std::vector<uint8_t> schema(TELEMETRY_SCHEMA_BYTES);
+    schema.resize(encoder.formatSchema(schema.data(), schema.size()));
+    write_datagram(file, TELEMETRY_FRAME::SCHEMA, sequence++, 0, schema);
+
+    const uint16_t generation = encoder.getGeneration();
+    size_t next = 0;
+    for (size_t f = 0; f < SAMPLE_FRAMES && f < frames.size(); ++f)
+    {
+        std::vector<uint8_t> payload(reinterpret_cast<const uint8_t *>(&generation),
+                                     reinterpret_cast<const uint8_t *>(&generation) + sizeof(generation));
+        payload.insert(payload.end(), frames[f].begin(), frames[f].end());
+        write_datagram(file, TELEMETRY_FRAME::DELTA, sequence++, counts[f], payload);
+
+        for (uint16_t n = 0; n < counts[f]; ++n, ++next)
+        {
+            const TelemetryRecord &record = records[next];
+            std::fprintf(file, "row %u", record.cycle);
+            for (uint8_t id = 0; id < registry.size(); ++id)
+            {
+                const uint8_t divider = registry.getDivider(id);
+                if (divider == 0)
+                    continue;
+                if (record.cycle % divider != 0)
+                {
+                    std::fprintf(file, ",");
+                    continue;
+                }
+                const TelemetryChannel &channel = registry.get(id);
+                const uint32_t value = expected_value(record, channel);
+                if (channel.type == TELEMETRY_COLUMN::UNSIGNED)
+                    std::fprintf(file, ",%u", value);
+                else
+                    std::fprintf(file, ",%.*f", channel.decimals,
+                                 static_cast<int32_t>(value) / std::pow(10.0, channel.decimals));
+            }
+            std::fprintf(file, "\n");
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+int main()
+{
+    TelemetryChannels registry;
+    register_channels(registry);
+    TelemetryEncoder encoder;
+    CHECK(encoder.configure(registry));
+
+    const std::vector<TelemetryRecord> records = synthetic_flight();
+    std::vector<uint16_t> counts;
+    const std::vector<std::vector<uint8_t>> frames = encode_frames(encoder, records, counts);
+
+    // Round trip: ogni datagramma si decodifica da solo e restituisce i valori quantizzati
+    Decoder decoder(registry);
+    std::vector<uint32_t> values(registry.size());
+    std::vector<bool> present(registry.size());
+    size_t payload = 0, next = 0, mismatches = 0;
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        decoder.reset();
+        const uint8_t *in = frames[f].data();
+        for (uint16_t n = 0; n < counts[f]; ++n, ++next)
+        {
+            const TelemetryRecord &record = records[next];
+            mismatches += decoder.row(in, values, present) != record.cycle;
+            for (uint8_t id = 0; id < registry.size(); ++id)
+                if (present[id])
+                    mismatches += values[id] != expected_value(record, registry.get(id));
+        }
+        CHECK(in == frames[f].data() + frames[f].size());
+        payload += frames[f].size();
+    }
+    CHECK(next == records.size());
+    CHECK(mismatches == 0);
+    CHECK(write_samples(encoder, registry, records, frames, counts));
+
+    // Dimensioni: binario grezzo, testo JSON e righe codificate (header dei datagrammi inclusi)
+    char text[TELEMETRY_TEXT_SIZE];
+    size_t json = 0;
+    for (const TelemetryRecord &record : records)
+        json += telemetry_format_record(registry, record, text, sizeof(text)) + 1;
+    const double wire = double(payload + frames.size() * sizeof(TelemetryFrameHeader)) / ROWS;
+    const double raw = double(sizeof(TelemetryRecord)) + double(sizeof(TelemetryFrameHeader)) / TELEMETRY_FRAME_RECORDS;
+    std::printf("bytes/row: encoded %.1f, raw %.1f, json %.1f (%.1fx and %.1fx smaller), %.1f rows/datagram\n", wire, raw,
+                double(json) / ROWS, raw / wire, double(json) / ROWS / wire, double(ROWS) / frames.size());
+    CHECK(wire <= TELEMETRY_MAX_BYTES_PER_ROW);
+
+    // Costo: codifica di tutte le righe contro la conversione in testo delle stesse righe
+    volatile size_t sink = 0;
+    const uint64_t encode_cycles = min_cycles([&] {
+        std::vector<uint16_t> c;
+        sink += encode_frames(encoder, records, c).size();
+    }, REPETITIONS);
+    const uint64_t text_cycles = min_cycles([&] {
+        for (const TelemetryRecord &record : records)
+            sink += telemetry_format_record(registry, record, text, sizeof(text));
+    }, REPETITIONS / 4);
+    const double ratio = double(encode_cycles) / double(text_cycles);
+    std::printf("cycles/row: encode %.0f, json %.0f (ratio %.3f, limit %.2f)\n", double(encode_cycles) / ROWS,
+                double(text_cycles) / ROWS, ratio, TELEMETRY_MAX_ENCODE_RATIO);
+    CHECK(ratio <= TELEMETRY_MAX_ENCODE_RATIO);
+
+    return test_result("telemetry_encoder_bench");
+}
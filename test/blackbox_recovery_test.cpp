@@ -0,0 +1,265 @@
+/**
+ * @file blackbox_recovery_test.cpp
+ * @brief Test del blackbox su host: recupero dopo un'interruzione, memoria piena, comandi.
+ *
+ * La memoria è il file di `BlackboxStorage` con semantica NOR. Il primo avvio gira in un
+ * processo figlio che registra una sessione completa, ne inizia una seconda e termina con
+ * `_exit` a sessione aperta, come un reset in volo: le scritture già eseguite restano nel
+ * file, il blocco in composizione non ha header. Il secondo avvio deve ricostruire il blocco
+ * interrotto, e ogni ciclo scritto deve ritrovarsi nei blocchi validi con CRC corretto.
+ * I comandi passano da `SerialCommands`, come dal task della seriale.
+ */
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include "Blackbox.h"
+#include "Logger.h"
+#include "SerialCommands.h"
+#include "TestSupport.h"
+
+static const int FIRST_SESSION = 101; ///< Cicli armati della sessione chiusa (più il ciclo del disarmo).
+static const int CRASH_SESSION = 76;  ///< Cicli armati della sessione interrotta.
+
+/**
+ * Blocco letto dalla memoria.
+ */
+struct DecodedBlock
+{
+    BlackboxBlockHeader header;
+    std::vector<BlackboxRecord> records;
+};
+
+// CRC-32 di riferimento (zlib), bit per bit
+static uint32_t reference_crc32(const uint8_t *data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return ~crc;
+}
+
+/**
+ * Legge i blocchi con header valido dall'immagine della memoria; conta quelli con CRC errato.
+ */
+static std::vector<DecodedBlock> decode(const std::string &image, int &bad_crc)
+{
+    std::vector<DecodedBlock> blocks;
+    bad_crc = 0;
+    for (size_t offset = 0; offset + BLACKBOX_BLOCK_SIZE <= image.size(); offset += BLACKBOX_BLOCK_SIZE)
+    {
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(image.data()) + offset;
+        DecodedBlock block;
+        memcpy(&block.header, data, sizeof(block.header));
+        if (memcmp(block.header.magic, "BBX1", 4) != 0)
+            continue;
+        if (block.header.record_size != sizeof(BlackboxRecord) || block.header.count > BLACKBOX_RECORDS_PER_BLOCK ||
+            reference_crc32(data + sizeof(BlackboxRecord), block.header.count * sizeof(BlackboxRecord)) !=
+                block.header.crc)
+        {
+            bad_crc++;
+            continue;
+        }
+        block.records.resize(block.header.count);
+        memcpy(block.records.data(), data + sizeof(BlackboxRecord), block.header.count * sizeof(BlackboxRecord));
+        blocks.push_back(block);
+    }
+    return blocks;
+}
+
+static std::string read_image()
+{
+    std::string image;
+    FILE *file = fopen(BLACKBOX_STORAGE, "rb");
+    if (file == nullptr)
+        return image;
+    char chunk[BLACKBOX_SECTOR_SIZE];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        image.append(chunk, n);
+    fclose(file);
+    return image;
+}
+
+static BlackboxRecord make_record(bool armed, uint32_t t)
+{
+    BlackboxRecord record = {};
+    record.telemetry.timestamp_us = t * 1000;
+    record.telemetry.imu.vel = t * 0.5f;
+    record.state = static_cast<int8_t>(armed ? CONTROLLER_STATE::ARMED : CONTROLLER_STATE::DISARMED);
+    record.loop_us = 900 + t % 7;
+    return record;
+}
+
+/**
+ * Simula il ciclo di controllo e il task di scrittura, che gira ogni due cicli.
+ */
+static void fly(Blackbox &blackbox, int cycles, bool disarm, uint32_t &t)
+{
+    for (int i = 0; i < cycles; ++i)
+    {
+        blackbox.record(make_record(true, t++));
+        if (i % 2)
+            blackbox.update();
+    }
+    if (disarm)
+        blackbox.record(make_record(false, t++));
+    blackbox.update();
+}
+
+/**
+ * Invia una riga di comandi come il task della seriale, poi esegue un passo del task di scrittura.
+ */
+static void send(Blackbox &blackbox, const char *commands)
+{
+    Serial.input += commands;
+    SerialCommands::getInstance().poll();
+    blackbox.update();
+}
+
+/**
+ * Primo avvio, nel processo figlio: sessione completa, poi reset a sessione aperta.
+ */
+static void first_boot()
+{
+    Blackbox &blackbox = Blackbox::getInstance();
+    if (!blackbox.begin())
+        _exit(2);
+    for (int i = 0; i < 8; ++i)
+        blackbox.update(); // Preparazione da disarmati
+    uint32_t t = 0;
+    fly(blackbox, FIRST_SESSION, true, t);
+    blackbox.update();
+    fly(blackbox, CRASH_SESSION, false, t);
+    _exit(blackbox.getStats().errors == 0 ? 0 : 3);
+}
+
+/**
+ * Verifica che ogni sessione sia una sequenza continua di cicli da 0.
+ */
+static void check_sessions(const std::vector<DecodedBlock> &blocks, uint32_t sessions, const uint32_t *expected,
+                           const bool *recovered)
+{
+    for (uint32_t s = 1; s <= sessions; ++s)
+    {
+        uint32_t cycles = 0;
+        bool contiguous = true, any_recovered = false;
+        for (const DecodedBlock &block : blocks)
+        {
+            if (block.header.session != s)
+                continue;
+            any_recovered = any_recovered || (block.header.flags & BLACKBOX_BLOCK_RECOVERED);
+            for (const BlackboxRecord &record : block.records)
+                contiguous = contiguous && record.telemetry.cycle == cycles++;
+        }
+        std::printf("session %u: %u cycles%s\n", s, cycles, any_recovered ? " (recovered)" : "");
+        CHECK(contiguous);
+        CHECK(cycles == expected[s - 1]);
+        CHECK(any_recovered == recovered[s - 1]);
+    }
+}
+
+int main()
+{
+    remove(BLACKBOX_STORAGE);
+
+    const pid_t child = fork();
+    if (child == 0)
+        first_boot();
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    // Della sessione interrotta sopravvivono i blocchi chiusi e le pagine complete del blocco aperto
+    const size_t open_records = CRASH_SESSION % BLACKBOX_RECORDS_PER_BLOCK;
+    const size_t flushed_records = ((open_records + 1) * sizeof(BlackboxRecord) -
+                                    (open_records + 1) * sizeof(BlackboxRecord) % BLACKBOX_PAGE_SIZE) /
+                                       sizeof(BlackboxRecord) - 1;
+    const uint32_t crash_survivors = static_cast<uint32_t>(CRASH_SESSION - open_records + flushed_records);
+
+    // Secondo avvio: ricostruzione del blocco interrotto
+    Blackbox &blackbox = Blackbox::getInstance();
+    Logger &logger = Logger::getInstance();
+    blackbox.startBlackboxTask();
+    CHECK(logger.count(LOG_ID::BLACKBOX_STATUS) == 1);
+    CHECK(logger.count(LOG_ID::BLACKBOX_RECOVERED) == 1);
+    const BlackboxStats &stats = blackbox.getStats();
+    const size_t first_blocks = (FIRST_SESSION + 1 + BLACKBOX_RECORDS_PER_BLOCK - 1) / BLACKBOX_RECORDS_PER_BLOCK;
+    const size_t crash_blocks = (CRASH_SESSION + BLACKBOX_RECORDS_PER_BLOCK - 1) / BLACKBOX_RECORDS_PER_BLOCK;
+    CHECK(stats.session == 2);
+    CHECK(stats.used == (first_blocks + crash_blocks) * BLACKBOX_BLOCK_SIZE);
+
+    int bad_crc;
+    std::vector<DecodedBlock> blocks = decode(read_image(), bad_crc);
+    CHECK(bad_crc == 0);
+    CHECK(blocks.size() == first_blocks + crash_blocks);
+    const uint32_t before_fill[] = {FIRST_SESSION + 1, crash_survivors};
+    const bool recovered_before_fill[] = {false, true};
+    check_sessions(blocks, 2, before_fill, recovered_before_fill);
+    CHECK(blocks.front().records.back().state == static_cast<int8_t>(CONTROLLER_STATE::ARMED));
+    CHECK(blocks[first_blocks - 1].records.back().state == static_cast<int8_t>(CONTROLLER_STATE::DISARMED));
+
+    // Terza sessione più lunga della memoria libera: i record in eccesso sono contati come persi
+    for (int i = 0; i < 8; ++i)
+        blackbox.update();
+    const size_t total_blocks = BLACKBOX_HOST_SIZE / BLACKBOX_BLOCK_SIZE;
+    CHECK(stats.prepared == BLACKBOX_HOST_SIZE);
+    const uint32_t fill_cycles = 3000;
+    const uint32_t fill_capacity =
+        static_cast<uint32_t>((total_blocks - first_blocks - crash_blocks) * BLACKBOX_RECORDS_PER_BLOCK);
+    uint32_t t = 0;
+    fly(blackbox, fill_cycles / 2, false, t);
+
+    // Da armati i comandi vengono rifiutati, senza attendere il disarmo
+    send(blackbox, "blackbox info\nblackbox erase\nblackbox format\n");
+    CHECK(logger.count(LOG_ID::BLACKBOX_BUSY) == 2);
+    CHECK(logger.count(LOG_ID::SERIAL_COMMAND_UNKNOWN) == 1);
+    fly(blackbox, fill_cycles - fill_cycles / 2, true, t);
+    CHECK(logger.count(LOG_ID::BLACKBOX_INFO) == 0);
+    CHECK(logger.count(LOG_ID::BLACKBOX_ERASE_STARTED) == 0);
+    std::printf("fill: %u records, %u lost, %u blocks, %zu of %u bytes\n", stats.records, stats.lost, stats.blocks,
+                stats.used, BLACKBOX_HOST_SIZE);
+    CHECK(stats.records == fill_capacity);
+    CHECK(stats.lost == fill_cycles + 1 - fill_capacity);
+    CHECK(stats.used == BLACKBOX_HOST_SIZE);
+    CHECK(stats.errors == 0);
+
+    blocks = decode(read_image(), bad_crc);
+    CHECK(bad_crc == 0);
+    CHECK(blocks.size() == total_blocks);
+    const uint32_t after_fill[] = {FIRST_SESSION + 1, crash_survivors, fill_capacity};
+    const bool recovered_after_fill[] = {false, true, false};
+    check_sessions(blocks, 3, after_fill, recovered_after_fill);
+
+    // Dump: intestazione, blocchi identici alla memoria, chiusura
+    const std::string image = read_image();
+    send(blackbox, "blackbox info\nblackbox dump\n");
+    char header[48];
+    snprintf(header, sizeof(header), "BLACKBOX DUMP %u %u\r\n", static_cast<unsigned>(total_blocks),
+             static_cast<unsigned>(BLACKBOX_BLOCK_SIZE));
+    CHECK(logger.count(LOG_ID::BLACKBOX_INFO) == 1);
+    CHECK(Serial.output == header + image + "BLACKBOX END\r\n");
+    CHECK(logger.serialAcquired == 1 && !logger.serialOwned);
+
+    // Cancellazione in background, poi una nuova sessione dall'inizio della memoria
+    send(blackbox, "blackbox erase\n");
+    CHECK(logger.count(LOG_ID::BLACKBOX_ERASE_STARTED) == 1);
+    for (int i = 0; i < 2 * static_cast<int>(total_blocks); ++i)
+        blackbox.update();
+    CHECK(stats.prepared == BLACKBOX_HOST_SIZE);
+    CHECK(read_image() == std::string(BLACKBOX_HOST_SIZE, '\xFF'));
+    fly(blackbox, 40, true, t);
+    blocks = decode(read_image(), bad_crc);
+    CHECK(blocks.size() == 2);
+    CHECK(blocks.front().header.session == 4);
+    CHECK(blocks.front().records.front().telemetry.cycle == 0);
+
+    remove(BLACKBOX_STORAGE);
+    return test_result("blackbox_recovery_test");
+}
@@ -0,0 +1,148 @@
+/**
+ * @file dshot_test.cpp
+ * @brief Test della codifica dei frame DShot e della decodifica GCR della telemetria eRPM.
+ *
+ * La risposta di telemetria viene generata da un codificatore indipendente scritto dalla
+ * specifica (periodo -> eee mmmmmmmmm + CRC -> GCR 4b/5b -> transizioni della linea) e
+ * decodificata con le funzioni di `DShot.h`.
+ */
+#include <random>
+#include <vector>
+#include "DShot.h"
+#include "TestSupport.h"
+
+static const uint32_t BIT_TICKS = 53; ///< Durata di un bit di telemetria in tick (valore arbitrario).
+
+/**
+ * Codifica un periodo elettrico nella risposta a 21 bit (bit di start incluso).
+ */
+static uint32_t encode_telemetry(uint32_t exponent, uint32_t mantissa, bool corrupt_crc)
+{
+    static const uint8_t gcr_encode[16] = {0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17,
+                                           0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F};
+    uint32_t payload = (exponent << 9) | mantissa;
+    uint32_t crc = ~(payload ^ (payload >> 4) ^ (payload >> 8)) & 0x0F;
+    if (corrupt_crc)
+        crc ^= 0x01;
+    uint32_t frame = (payload << 4) | crc;
+
+    uint32_t gcr = 0;
+    for (int i = 3; i >= 0; --i)
+        gcr = (gcr << 5) | gcr_encode[(frame >> (4 * i)) & 0x0F];
+    return (1UL << 20) | gcr;
+}
+
+/**
+ * Converte il valore a 21 bit nelle durate dei livelli della linea: ogni bit a 1 è una
+ * transizione, quindi ogni livello dura quanto l'1 che lo apre più gli 0 che lo seguono.
+ */
+static std::vector<uint32_t> to_durations(uint32_t value, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> jitter(-(int)BIT_TICKS / 2 + 1, (int)BIT_TICKS / 2 - 1);
+    std::vector<uint32_t> durations;
+    uint32_t run = 0;
+    for (int bit = DSHOT_TELEMETRY_BITS - 1; bit >= 0; --bit)
+    {
+        if ((value >> bit) & 1)
+        {
+            if (run > 0)
+                durations.push_back(run * BIT_TICKS + jitter(rng));
+            run = 0;
+        }
+        run++;
+    }
+    // L'ultimo livello resta stabile fino al ritorno della linea a riposo
+    durations.push_back((run + 3) * BIT_TICKS);
+    return durations;
+}
+
+static void test_frame_crc()
+{
+    // Esempio dalla specifica: throttle 1046 senza telemetria
+    CHECK(dshot_make_frame(1046, false, false) == 0x82C6);
+    CHECK(dshot_make_frame(1046, false, true) == 0x82C9);
+    CHECK(dshot_make_frame(DSHOT_CMD_MOTOR_STOP, false, false) == 0x0000);
+
+    // Lo XOR dei quattro nibble è 0 in modalità normale e 0xF in modalità bidirezionale
+    for (uint16_t value = 0; value <= DSHOT_THROTTLE_MAX; ++value)
+    {
+        for (int telemetry = 0; telemetry < 2; ++telemetry)
+        {
+            for (int bidirectional = 0; bidirectional < 2; ++bidirectional)
+            {
+                uint16_t frame = dshot_make_frame(value, telemetry, bidirectional);
+                uint16_t nibbles = (frame ^ (frame >> 4) ^ (frame >> 8) ^ (frame >> 12)) & 0x0F;
+                CHECK(nibbles == (bidirectional ? 0x0F : 0x00));
+                CHECK((frame >> 5) == value);
+                CHECK(((frame >> 4) & 1) == telemetry);
+            }
+        }
+    }
+}
+
+static void test_throttle_mapping()
+{
+    CHECK(dshot_throttle_from_pwm(900, 1000, 2000) == DSHOT_CMD_MOTOR_STOP);
+    CHECK(dshot_throttle_from_pwm(1000, 1000, 2000) == DSHOT_CMD_MOTOR_STOP);
+    CHECK(dshot_throttle_from_pwm(1001, 1000, 2000) >= DSHOT_THROTTLE_MIN);
+    CHECK(dshot_throttle_from_pwm(2000, 1000, 2000) == DSHOT_THROTTLE_MAX);
+    CHECK(dshot_throttle_from_pwm(2100, 1000, 2000) == DSHOT_THROTTLE_MAX);
+
+    uint16_t previous = 0;
+    for (int pwm = 1000; pwm <= 2000; ++pwm)
+    {
+        uint16_t value = dshot_throttle_from_pwm(pwm, 1000, 2000);
+        CHECK(value >= previous);
+        previous = value;
+    }
+}
+
+static void test_gcr_round_trip()
+{
+    std::mt19937 rng(28);
+    for (uint32_t exponent = 0; exponent < 8; ++exponent)
+    {
+        for (uint32_t mantissa = 1; mantissa < 512; ++mantissa)
+        {
+            if (exponent == 7 && mantissa == 0x1FF)
+                continue; // 0x0FFF indica il motore fermo
+            uint32_t period_us = mantissa << exponent;
+            uint32_t expected = (60000000UL + period_us / 2) / period_us;
+            std::vector<uint32_t> durations = to_durations(encode_telemetry(exponent, mantissa, false), rng);
+
+            uint32_t raw = 0;
+            CHECK(dshot_decode_runs(durations.data(), durations.size(), BIT_TICKS, raw));
+            CHECK(dshot_decode_erpm(raw) == expected);
+        }
+    }
+}
+
+static void test_gcr_invalid()
+{
+    // Motore fermo: periodo 0x0FFF
+    CHECK(dshot_decode_erpm(encode_telemetry(7, 0x1FF, false)) == 0);
+
+    // CRC errato
+    CHECK(dshot_decode_erpm(encode_telemetry(3, 100, true)) == DSHOT_ERPM_INVALID);
+
+    // Simbolo GCR non valido (00000) nel nibble meno significativo
+    CHECK(dshot_decode_erpm(encode_telemetry(3, 100, false) & ~0x1FUL) == DSHOT_ERPM_INVALID);
+
+    // Periodo nullo
+    CHECK(dshot_decode_erpm(encode_telemetry(0, 0, false)) == DSHOT_ERPM_INVALID);
+
+    // Durate più corte di mezzo bit e risposte troncate
+    uint32_t raw = 0;
+    const uint32_t glitch[] = {BIT_TICKS, BIT_TICKS / 4, BIT_TICKS};
+    CHECK(!dshot_decode_runs(glitch, 3, BIT_TICKS, raw));
+    CHECK(!dshot_decode_runs(glitch, 0, BIT_TICKS, raw));
+}
+
+int main()
+{
+    test_frame_crc();
+    test_throttle_mapping();
+    test_gcr_round_trip();
+    test_gcr_invalid();
+    return test_result("dshot_test");
+}
@@ -0,0 +1,159 @@
+/**
+ * @file fast_math_test.cpp
+ * @brief Verifica degli errori massimi documentati in `FastMath.h` su tutto il dominio dichiarato.
+ *
+ * Il riferimento è libm in doppia precisione. I domini vengono percorsi con passo fisso, più
+ * fitto dove la riduzione di `fast_sincos` cambia quadrante, e `fast_rsqrt` viene verificata
+ * su tutti i float di due binadi consecutive: la stima iniziale dipende solo dalla parità
+ * dell'esponente, quindi l'errore relativo si ripete con periodo due.
+ */
+#include <cstring>
+#include "FastMath.h"
+#include "TestSupport.h"
+
+static const double SINCOS_MAX_ERROR = 1.0e-7; ///< Errore assoluto documentato di `fast_sincos`.
+static const double ATAN2_MAX_ERROR = 1.2e-5;  ///< Errore assoluto documentato di `fast_atan2`.
+static const double RSQRT_MAX_ERROR = 4.8e-6;  ///< Errore relativo documentato di `fast_rsqrt`.
+static const double SINCOS_DOMAIN = 1000;      ///< Ampiezza del dominio documentato di `fast_sincos` (rad).
+
+static double sincos_error(float x)
+{
+    float s, c;
+    fast_sincos(x, s, c);
+    const double es = std::fabs(s - std::sin(double(x)));
+    const double ec = std::fabs(c - std::cos(double(x)));
+    return es > ec ? es : ec;
+}
+
+static void test_sincos()
+{
+    double worst = 0;
+    float worst_x = 0;
+
+    // Tutto il dominio con passo fisso
+    const int steps = 10000000;
+    for (int i = 0; i <= steps; ++i)
+    {
+        const float x = float(-SINCOS_DOMAIN + 2 * SINCOS_DOMAIN * i / steps);
+        const double e = sincos_error(x);
+        if (e > worst)
+            worst = e, worst_x = x;
+    }
+
+    // Tutti i float vicini ai confini dei quadranti ((2k+1)π/4), dove la riduzione cambia ramo
+    for (int k = -20; k <= 20; ++k)
+    {
+        float x = float((2 * k + 1) * M_PI / 4);
+        for (int j = 0; j < 4096; ++j)
+            x = std::nextafter(x, -INFINITY);
+        for (int j = 0; j < 8192; ++j, x = std::nextafter(x, INFINITY))
+        {
+            const double e = sincos_error(x);
+            if (e > worst)
+                worst = e, worst_x = x;
+        }
+    }
+
+    // Valori piccoli: il seno deve restare accurato in termini relativi
+    double worst_small = 0;
+    for (float x = 1e-30f; x < 1e-2f; x *= 1.001f)
+    {
+        float s, c;
+        fast_sincos(x, s, c);
+        const double rel = std::fabs(s - std::sin(double(x))) / std::sin(double(x));
+        worst_small = rel > worst_small ? rel : worst_small;
+    }
+
+    std::printf("fast_sincos: max abs error %.3g at x = %.9g, max rel error of sin below 1e-2: %.3g\n", worst,
+                worst_x, worst_small);
+    CHECK(worst <= SINCOS_MAX_ERROR);
+    CHECK(worst_small <= 1.2e-7);
+}
+
+static double atan2_error(float y, float x)
+{
+    return std::fabs(fast_atan2(y, x) - std::atan2(double(y), double(x)));
+}
+
+static void test_atan2()
+{
+    double worst = 0;
+
+    // Direzioni sul cerchio, a più raggi: l'errore dipende solo dall'angolo
+    const int steps = 2000000;
+    const float radii[] = {1e-30f, 1e-3f, 1.0f, 1e3f, 1e30f};
+    for (float r : radii)
+    {
+        for (int i = 0; i < steps; ++i)
+        {
+            const double angle = -M_PI + 2 * M_PI * i / steps;
+            const double e = atan2_error(float(r * std::sin(angle)), float(r * std::cos(angle)));
+            worst = e > worst ? e : worst;
+        }
+    }
+
+    // Semiassi e zeri con segno
+    const float special[][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1},
+                                {-0.0f, -1}, {-0.0f, 1}, {-1, -0.0f}, {1, -0.0f}};
+    for (const auto &p : special)
+    {
+        const double e = atan2_error(p[0], p[1]);
+        worst = e > worst ? e : worst;
+    }
+
+    std::printf("fast_atan2: max abs error %.3g\n", worst);
+    CHECK(worst <= ATAN2_MAX_ERROR);
+    CHECK(fast_atan2(0.0f, 0.0f) == 0.0f);
+}
+
+static double rsqrt_error(float x)
+{
+    const double exact = 1.0 / std::sqrt(double(x));
+    return std::fabs(fast_rsqrt(x) - exact) / exact;
+}
+
+static void test_rsqrt()
+{
+    double worst = 0;
+    float worst_x = 0;
+
+    // Tutti i float di [1, 4): esponente pari e dispari
+    uint32_t first, last;
+    const float one = 1.0f, four = 4.0f;
+    std::memcpy(&first, &one, sizeof(first));
+    std::memcpy(&last, &four, sizeof(last));
+    for (uint32_t bits = first; bits < last; ++bits)
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        const double e = rsqrt_error(x);
+        if (e > worst)
+            worst = e, worst_x = x;
+    }
+
+    // Tutti gli esponenti normalizzati, con mantissa campionata
+    double worst_range = 0;
+    for (uint32_t exponent = 1; exponent < 255; ++exponent)
+    {
+        for (uint32_t mantissa = 0; mantissa < (1u << 23); mantissa += 4099)
+        {
+            const uint32_t bits = (exponent << 23) | mantissa;
+            float x;
+            std::memcpy(&x, &bits, sizeof(x));
+            const double e = rsqrt_error(x);
+            worst_range = e > worst_range ? e : worst_range;
+        }
+    }
+
+    std::printf("fast_rsqrt: max rel error %.3g at x = %.9g, over all exponents %.3g\n", worst, worst_x, worst_range);
+    CHECK(worst <= RSQRT_MAX_ERROR);
+    CHECK(worst_range <= RSQRT_MAX_ERROR);
+}
+
+int main()
+{
+    test_sincos();
+    test_atan2();
+    test_rsqrt();
+    return test_result("fast_math_test");
+}
@@ -0,0 +1,106 @@
+/**
+ * @file fuzz_driver.cpp
+ * @brief Driver per i target di fuzzing quando libFuzzer non è disponibile.
+ *
+ * Riesegue i file del corpus passati da riga di comando (file o directory) e poi
+ * applica mutazioni pseudo-casuali deterministiche al corpus, per `-runs=N` iterazioni.
+ * Con Clang gli stessi target vengono collegati a libFuzzer e questo file non è usato.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+using Input = std::vector<uint8_t>;
+
+static void load(const std::filesystem::path &path, std::vector<Input> &corpus)
+{
+    if (std::filesystem::is_directory(path))
+    {
+        for (const auto &entry : std::filesystem::directory_iterator(path))
+            load(entry.path(), corpus);
+        return;
+    }
+    std::ifstream file(path, std::ios::binary);
+    corpus.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Applica una mutazione casuale: bit flip, byte casuale, inserimento,
+ *        cancellazione, inserimento di un header o unione con un altro ingresso.
+ */
+static Input mutate(const Input &base, const std::vector<Input> &corpus, std::mt19937 &rng)
+{
+    static const uint8_t header[] = {0x20, 0x40};
+    Input out = base;
+    int mutations = 1 + rng() % 4;
+    for (int m = 0; m < mutations; ++m)
+    {
+        size_t pos = out.empty() ? 0 : rng() % out.size();
+        switch (rng() % 6)
+        {
+        case 0:
+            if (!out.empty())
+                out[pos] ^= 1u << (rng() % 8);
+            break;
+        case 1:
+            if (!out.empty())
+                out[pos] = rng();
+            break;
+        case 2:
+            out.insert(out.begin() + pos, static_cast<uint8_t>(rng()));
+            break;
+        case 3:
+            if (!out.empty())
+                out.erase(out.begin() + pos, out.begin() + pos + 1 + rng() % (out.size() - pos));
+            break;
+        case 4:
+            out.insert(out.begin() + pos, header, header + 1 + rng() % 2);
+            break;
+        default:
+        {
+            const Input &other = corpus[rng() % corpus.size()];
+            size_t from = other.empty() ? 0 : rng() % other.size();
+            out.insert(out.begin() + pos, other.begin() + from, other.end());
+            break;
+        }
+        }
+    }
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    long runs = 0;
+    std::vector<Input> corpus;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "-runs=", 6) == 0)
+            runs = std::strtol(argv[i] + 6, nullptr, 10);
+        else if (argv[i][0] != '-')
+            load(argv[i], corpus);
+    }
+
+    for (const Input &input : corpus)
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    std::printf("Replayed %zu corpus inputs\n", corpus.size());
+
+    if (corpus.empty())
+        corpus.emplace_back();
+
+    std::mt19937 rng(0x1B05);
+    for (long r = 0; r < runs; ++r)
+    {
+        Input input = mutate(corpus[rng() % corpus.size()], corpus, rng);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    std::printf("Executed %ld mutated inputs\n", runs);
+    return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file ibus_parser_fuzz.cpp
+ * @brief Target di fuzzing per `IBusParser`.
+ *
+ * Il primo byte dell'input sceglie la dimensione dei blocchi passati al parser, come
+ * letture successive dalla UART; i byte restanti sono il flusso ricevuto.
+ */
+#include <cstdlib>
+#include "IBusParser.h"
+#include "AirframeConfig.h"
+
+/// Byte massimi letti dalla UART in una chiamata (come `Receiver::MAX_BYTES_PER_READ`).
+static const size_t MAX_CHUNK = 3 * IBusParser::PACKET_SIZE;
+
+/// Lavoro massimo per byte: copia, riallineamento, verifica del pacchetto e nuovo riallineamento.
+static const size_t MAX_WORK_PER_BYTE = 3 * IBusParser::PACKET_SIZE + 1;
+
+static void require(bool condition)
+{
+    if (!condition)
+        abort();
+}
+
+static void check_channels(const ReceiverData &data)
+{
+    const float values[IBusParser::CHANNELS] = {data.x, data.y, data.throttle, data.z, data.swa,
+                                                data.swb, data.swc, data.swd, data.vra, data.vrb};
+    for (int i = 0; i < IBusParser::CHANNELS; ++i)
+        require(ActiveAirframe::receiver[i].digital.contains(values[i]));
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *input, size_t size)
+{
+    if (size == 0)
+        return 0;
+
+    const size_t chunk = input[0] % MAX_CHUNK + 1;
+    const uint8_t *stream = input + 1;
+    const size_t length = size - 1;
+
+    IBusParser parser;
+    ReceiverData data{};
+    for (size_t offset = 0; offset < length; offset += chunk)
+    {
+        size_t n = length - offset < chunk ? length - offset : chunk;
+        ReceiverData decoded{};
+        if (parser.parse(stream + offset, n, decoded))
+        {
+            check_channels(decoded);
+            data = decoded;
+        }
+        require(parser.pending() < IBusParser::PACKET_SIZE);
+    }
+
+    const ReceiverStats &stats = parser.getStats();
+    require(stats.bytesRead == length);
+    require(stats.bytesDiscarded + stats.packetsValid * IBusParser::PACKET_SIZE + parser.pending() <= length);
+    require(stats.maxBytesPerRead <= chunk);
+    require(stats.maxWorkPerRead <= MAX_WORK_PER_BYTE * stats.maxBytesPerRead);
+    (void)data;
+    return 0;
+}
@@ -0,0 +1,51 @@
+"""
+Genera il corpus iniziale per il target di fuzzing di IBusParser.
+
+Ogni file contiene un byte che sceglie la dimensione dei blocchi passati al parser
+(valore % 96 + 1) seguito dal flusso IBUS.
+"""
+
+import os
+import struct
+
+CORPUS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus", "ibus")
+
+
+def packet(channels, corrupt_checksum=False):
+    """Costruisce un pacchetto IBUS da 32 byte con 14 canali."""
+    channels = list(channels) + [1500] * (14 - len(channels))
+    body = bytes([0x20, 0x40]) + b"".join(struct.pack("<H", c & 0xFFFF) for c in channels)
+    checksum = (0xFFFF - sum(body)) & 0xFFFF
+    if corrupt_checksum:
+        checksum ^= 0x0001
+    return body + struct.pack("<H", checksum)
+
+
+def main():
+    neutral = packet([1500, 1500, 1000, 1500, 1000, 1000, 1000, 1000, 1500, 1500])
+    extremes = packet([1000, 2000, 2000, 1000, 2000, 1500, 2000, 1000, 1000, 2000])
+    out_of_range = packet([900, 2100, 0, 3000, 1000, 1000, 1000, 1000, 1500, 1500])
+    negative = packet([0x8000, 1500, 1000, 1500])
+
+    seeds = {
+        "valid_single": bytes([95]) + neutral,
+        "valid_stream_byte_by_byte": bytes([0]) + neutral + extremes + neutral,
+        "valid_stream_uneven_chunks": bytes([12]) + extremes * 4,
+        "bad_checksum_then_valid": bytes([95]) + packet([1500] * 10, True) + neutral,
+        "noise_then_valid": bytes([31]) + bytes(range(0x41, 0x80)) + neutral,
+        "header_flood": bytes([95]) + bytes([0x20, 0x40]) * 96,
+        "header_1_flood": bytes([7]) + bytes([0x20]) * 192,
+        "truncated": bytes([95]) + neutral[:20] + extremes,
+        "out_of_range": bytes([95]) + out_of_range,
+        "negative_channel": bytes([95]) + negative + neutral,
+        "embedded_header": bytes([3]) + neutral[:10] + neutral + neutral[10:],
+    }
+
+    os.makedirs(CORPUS_DIR, exist_ok=True)
+    for name, data in seeds.items():
+        with open(os.path.join(CORPUS_DIR, name), "wb") as f:
+            f.write(data)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,137 @@
+/**
+ * @file input_shaper_test.cpp
+ * @brief Test dell'InputShaper: tabella delle curve, simmetria, saturazione e filtro dei setpoint.
+ *
+ * La tabella interpola linearmente f(n) = rate · (expo · n³ + (1 - expo) · n) su
+ * `INPUT_SHAPER_LUT_SIZE` segmenti: l'errore massimo è |f''| · h² / 8 con h = 1 / LUT_SIZE,
+ * cioè 6 · rate · expo · h² / 8 a stick completo (0.26 gradi/s a 360 gradi/s con expo 1).
+ * Il filtro verificato dipende da `INPUT_SMOOTHING`, per cui lo stesso test viene compilato
+ * una volta per modalità.
+ */
+#include <cmath>
+#include "InputShaper.h"
+#include "TestSupport.h"
+
+static const float EXPO[3] = {1.0f, 0.5f, 0.0f};
+static const float RATE[3] = {360.0f, 200.0f, 90.0f};
+
+static double analytic(int axis, double stick)
+{
+    double n = std::fabs(stick) / INPUT_STICK_MAX;
+    if (n > 1)
+        n = 1;
+    const double value = RATE[axis] * (EXPO[axis] * n * n * n + (1.0 - EXPO[axis]) * n);
+    return stick < 0 ? -value : value;
+}
+
+/**
+ * Errore della tabella rispetto alla curva analitica, su tutta l'escursione.
+ */
+static void test_table(const InputShaper &shaper)
+{
+    const double h = 1.0 / INPUT_SHAPER_LUT_SIZE;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        double max_error = 0;
+        for (int i = -90000; i <= 90000; ++i)
+        {
+            const float stick = i * (INPUT_STICK_MAX / 90000.0f);
+            max_error = std::fmax(max_error, std::fabs(shaper.shape(axis, stick) - analytic(axis, stick)));
+        }
+        const double bound = 6.0 * RATE[axis] * EXPO[axis] * h * h / 8.0;
+        std::printf("axis %d: expo %.1f rate %.0f, max table error %.4f (bound %.4f)\n", axis, EXPO[axis],
+                    RATE[axis], max_error, bound);
+        CHECK(max_error <= bound + 1e-5 * RATE[axis]);
+    }
+    CHECK(6.0 * 360.0 * h * h / 8.0 <= 0.265);
+}
+
+/**
+ * Curve dispari: f(-s) = -f(s) esattamente, con f(0) = 0.
+ */
+static void test_symmetry(const InputShaper &shaper)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        CHECK(shaper.shape(axis, 0.0f) == 0.0f);
+        for (float stick = 0.0f; stick <= INPUT_STICK_MAX + 10; stick += 0.37f)
+            CHECK(shaper.shape(axis, -stick) == -shaper.shape(axis, stick));
+    }
+}
+
+/**
+ * Oltre `INPUT_STICK_MAX` il setpoint resta quello a stick completo.
+ */
+static void test_saturation(const InputShaper &shaper)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        CHECK_NEAR(shaper.shape(axis, INPUT_STICK_MAX), RATE[axis], 1e-4);
+        const float stick[] = {INPUT_STICK_MAX + 0.01f, INPUT_STICK_MAX * 1.5f, 1000.0f, INFINITY};
+        for (float s : stick)
+        {
+            CHECK(shaper.shape(axis, s) == shaper.shape(axis, INPUT_STICK_MAX));
+            CHECK(shaper.shape(axis, -s) == -shaper.shape(axis, INPUT_STICK_MAX));
+        }
+    }
+}
+
+/**
+ * Risposta del filtro a un gradino di 45 gradi/s sull'asse lineare, a 1 kHz e a 100 Hz.
+ */
+static void test_smoothing(InputShaper &shaper)
+{
+    const float centered[3] = {0, 0, 0};
+    const float stick[3] = {0, 0, INPUT_STICK_MAX / 2.0f};
+    const float target = 45.0f;
+    float setpoint[3];
+
+    const float dt = 0.001f;
+    shaper.reset(centered);
+#if INPUT_SMOOTHING == INPUT_SMOOTHING_INTERPOLATE
+    // Rampa lineare di INPUT_FRAME_INTERVAL_MS cicli, poi il valore del frame
+    const int steps = INPUT_FRAME_INTERVAL_MS;
+    for (int i = 1; i <= steps + 3; ++i)
+    {
+        shaper.update(stick, dt, setpoint);
+        if (i < steps)
+            CHECK_NEAR(setpoint[2], target * i / steps, 1e-4);
+        else
+            CHECK(setpoint[2] == target);
+    }
+    std::printf("interpolate: %.0f deg/s step over %d cycles of %.0f ms\n", target, steps, dt * 1000);
+
+    // Con un ciclo più lungo di un frame la rampa si riduce a un solo passo
+    shaper.reset(centered);
+    shaper.update(stick, 0.01f, setpoint);
+    CHECK(setpoint[2] == target);
+#elif INPUT_SMOOTHING == INPUT_SMOOTHING_PT1
+    // Primo ordine: dopo un ciclo k · gradino, dopo una costante di tempo circa il 63%
+    const double rc = 1.0 / (2.0 * M_PI * INPUT_SMOOTHING_CUTOFF_HZ);
+    const double k = dt / (rc + dt);
+    const int tau_cycles = static_cast<int>(rc / dt + 0.5);
+    for (int i = 1; i <= tau_cycles; ++i)
+    {
+        shaper.update(stick, dt, setpoint);
+        CHECK_NEAR(setpoint[2], target * (1.0 - std::pow(1.0 - k, i)), 1e-3);
+    }
+    std::printf("pt1: %.1f%% of the step after %d cycles (tau %.1f ms)\n", setpoint[2] * 100 / target, tau_cycles,
+                rc * 1000);
+    CHECK(setpoint[2] > 0.6f * target && setpoint[2] < 0.66f * target);
+#else
+    // Nessun filtro: il setpoint è la curva
+    shaper.update(stick, dt, setpoint);
+    CHECK(setpoint[2] == target);
+    CHECK(setpoint[0] == 0.0f && setpoint[1] == 0.0f);
+#endif
+}
+
+int main()
+{
+    InputShaper shaper(EXPO, RATE);
+    test_table(shaper);
+    test_symmetry(shaper);
+    test_saturation(shaper);
+    test_smoothing(shaper);
+    return test_result("input_shaper_test");
+}
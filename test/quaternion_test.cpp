@@ -0,0 +1,224 @@
+/**
+ * @file quaternion_test.cpp
+ * @brief Test di accuratezza delle funzioni di `Quaternions.h`.
+ *
+ * Ogni funzione viene confrontata con un'implementazione di riferimento in doppia precisione
+ * scritta dalla definizione (composizione asse-angolo con libm, prodotto q v q*), su ingressi
+ * casuali riproducibili. Le tolleranze valgono sia con `FAST_MATH` sia con le funzioni di libm.
+ */
+#include <algorithm>
+#include <random>
+#include "Quaternions.h"
+#include "TestSupport.h"
+
+static const int SAMPLES = 200000;          ///< Campioni casuali per verifica.
+static const double FLOAT_TOLERANCE = 1e-6; ///< Tolleranza sulle componenti unitarie in singola precisione.
+static const double RSQRT_TOLERANCE = 5e-6; ///< Errore relativo massimo documentato di `fast_rsqrt`, arrotondato.
+
+/**
+ * Quaternione in doppia precisione per i riferimenti.
+ */
+struct RefQuaternion
+{
+    double w, x, y, z;
+};
+
+static RefQuaternion ref_multiply(const RefQuaternion &a, const RefQuaternion &b)
+{
+    return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+}
+
+static RefQuaternion ref_axis_angle(int axis_index, double angle_deg)
+{
+    const double half = 0.5 * angle_deg * M_PI / 180.0;
+    RefQuaternion q = {std::cos(half), 0, 0, 0};
+    (&q.x)[axis_index] = std::sin(half);
+    return q;
+}
+
+static RefQuaternion to_ref(const Quaternion &q)
+{
+    return {q.w, q.x, q.y, q.z};
+}
+
+static double max_difference(const Quaternion &q, const RefQuaternion &r)
+{
+    return std::max({std::fabs(q.w - r.w), std::fabs(q.x - r.x), std::fabs(q.y - r.y), std::fabs(q.z - r.z)});
+}
+
+static double norm(const Quaternion &q)
+{
+    return std::sqrt(double(q.w) * q.w + double(q.x) * q.x + double(q.y) * q.y + double(q.z) * q.z);
+}
+
+static Quaternion random_unit(std::mt19937 &rng)
+{
+    std::normal_distribution<float> gauss(0, 1);
+    Quaternion q = {gauss(rng), gauss(rng), gauss(rng), gauss(rng)};
+    const double n = norm(q);
+    return {float(q.w / n), float(q.x / n), float(q.y / n), float(q.z / n)};
+}
+
+static void test_from_euler()
+{
+    // Forma chiusa contro la composizione q_x(roll) ⊗ q_y(pitch) ⊗ q_z(yaw)
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> angle(-180, 180);
+    double worst = 0, worst_norm = 0;
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        const float roll = angle(rng), pitch = angle(rng), yaw = angle(rng);
+        Quaternion q;
+        quaternion_from_euler(roll, pitch, yaw, q);
+        const RefQuaternion r = ref_multiply(ref_multiply(ref_axis_angle(0, roll), ref_axis_angle(1, pitch)),
+                                             ref_axis_angle(2, yaw));
+        worst = std::max(worst, max_difference(q, r));
+        worst_norm = std::max(worst_norm, std::fabs(norm(q) - 1));
+    }
+    std::printf("from_euler: max component error %.2e, max norm error %.2e\n", worst, worst_norm);
+    CHECK(worst <= FLOAT_TOLERANCE);
+    CHECK(worst_norm <= FLOAT_TOLERANCE);
+
+    // Asse-angolo sui tre assi standard
+    double worst_axis = 0;
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        const int a = i % 3;
+        const float deg = angle(rng);
+        Quaternion q;
+        quaternion_from_axis_angle(axis[a], deg, q);
+        worst_axis = std::max(worst_axis, max_difference(q, ref_axis_angle(a, deg)));
+    }
+    std::printf("from_axis_angle: max component error %.2e\n", worst_axis);
+    CHECK(worst_axis <= FLOAT_TOLERANCE);
+}
+
+static void test_normalize()
+{
+    // Norme da 1e-3 a 1e3: il risultato deve essere unitario e parallelo all'ingresso
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> exponent(-3, 3);
+    double worst_norm = 0, worst_direction = 0;
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        const Quaternion unit = random_unit(rng);
+        const float scale = std::pow(10.0f, exponent(rng));
+        Quaternion q = {unit.w * scale, unit.x * scale, unit.y * scale, unit.z * scale};
+        quaternion_normalize(q);
+        worst_norm = std::max(worst_norm, std::fabs(norm(q) - 1));
+        worst_direction = std::max(worst_direction, max_difference(q, to_ref(unit)));
+    }
+    std::printf("normalize: max norm error %.2e, max component error %.2e\n", worst_norm, worst_direction);
+    CHECK(worst_norm <= RSQRT_TOLERANCE);
+    CHECK(worst_direction <= RSQRT_TOLERANCE);
+
+    // Il quaternione nullo resta invariato
+    Quaternion zero = {0, 0, 0, 0};
+    quaternion_normalize(zero);
+    CHECK(zero.w == 0 && zero.x == 0 && zero.y == 0 && zero.z == 0);
+}
+
+static void test_rotate()
+{
+    // Forma vettoriale contro il prodotto completo q ⊗ (0, v) ⊗ q*
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> component(-100, 100);
+    double worst = 0;
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        const Quaternion q = random_unit(rng);
+        const Euler v = {component(rng), component(rng), component(rng)};
+        const Euler rotated = quaternion_rotate(q, v);
+
+        const RefQuaternion r = to_ref(q);
+        const RefQuaternion ref = ref_multiply(ref_multiply(r, {0, v.x, v.y, v.z}), {r.w, -r.x, -r.y, -r.z});
+        const double length = std::sqrt(double(vector_dot(v, v)));
+        worst = std::max({worst, std::fabs(rotated.x - ref.x) / length, std::fabs(rotated.y - ref.y) / length,
+                          std::fabs(rotated.z - ref.z) / length});
+    }
+    std::printf("rotate: max relative error %.2e\n", worst);
+    CHECK(worst <= 4 * FLOAT_TOLERANCE);
+}
+
+static void test_error()
+{
+    // q_e ⊗ q = ±q_d, con w ≥ 0 (rotazione più breve)
+    std::mt19937 rng(4);
+    double worst = 0;
+    bool shortest = true;
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        const Quaternion desired = random_unit(rng), actual = random_unit(rng);
+        Quaternion error;
+        quaternion_error(desired, actual, error);
+        shortest = shortest && error.w >= 0;
+
+        const RefQuaternion back = ref_multiply(to_ref(error), to_ref(actual));
+        const double sign = (back.w * desired.w + back.x * desired.x + back.y * desired.y + back.z * desired.z) < 0 ? -1 : 1;
+        worst = std::max(worst, max_difference(desired, {sign * back.w, sign * back.x, sign * back.y, sign * back.z}));
+    }
+    std::printf("error: max reconstruction error %.2e\n", worst);
+    CHECK(shortest);
+    CHECK(worst <= 4 * FLOAT_TOLERANCE);
+
+    // Attitudini coincidenti: errore identità
+    const Quaternion q = {0.5f, 0.5f, -0.5f, 0.5f};
+    Quaternion error;
+    quaternion_error(q, q, error);
+    CHECK_NEAR(error.w, 1, FLOAT_TOLERANCE);
+    CHECK_NEAR(error.x, 0, FLOAT_TOLERANCE);
+}
+
+static void test_error_rate()
+{
+    // Derivata analitica contro la differenza finita centrata dell'errore, con
+    // q(t ± h) = q ⊗ exp(±½ ω h) calcolato in doppia precisione
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> rate(-500, 500);
+    const double h = 1e-4;
+    double worst = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const Quaternion desired = random_unit(rng), actual = random_unit(rng);
+        const Euler gyro = {rate(rng), rate(rng), rate(rng)};
+
+        Quaternion analytic;
+        quaternion_error_rate(desired, actual, gyro, analytic);
+
+        const double wx = gyro.x * M_PI / 180, wy = gyro.y * M_PI / 180, wz = gyro.z * M_PI / 180;
+        const double speed = std::sqrt(wx * wx + wy * wy + wz * wz);
+        const double half = 0.5 * speed * h;
+        const double s = speed > 0 ? std::sin(half) / speed : 0;
+        const RefQuaternion forward = ref_multiply(to_ref(actual), {std::cos(half), wx * s, wy * s, wz * s});
+        const RefQuaternion backward = ref_multiply(to_ref(actual), {std::cos(half), -wx * s, -wy * s, -wz * s});
+
+        // Stesso emisfero scelto da quaternion_error nel punto centrale
+        const RefQuaternion d = to_ref(desired);
+        const RefQuaternion e_center = ref_multiply(d, to_ref(quaternion_conjugate(actual)));
+        const double sign = e_center.w < 0 ? -1 : 1;
+        const RefQuaternion e_forward = ref_multiply(d, {forward.w, -forward.x, -forward.y, -forward.z});
+        const RefQuaternion e_backward = ref_multiply(d, {backward.w, -backward.x, -backward.y, -backward.z});
+        const RefQuaternion numeric = {sign * (e_forward.w - e_backward.w) / (2 * h),
+                                       sign * (e_forward.x - e_backward.x) / (2 * h),
+                                       sign * (e_forward.y - e_backward.y) / (2 * h),
+                                       sign * (e_forward.z - e_backward.z) / (2 * h)};
+
+        // Errore relativo al modulo della derivata, |q̇_e| = |ω| / 2
+        worst = std::max(worst, max_difference(analytic, numeric) / std::max(0.5 * speed, 1e-3));
+    }
+    std::printf("error_rate: max relative error %.2e\n", worst);
+    CHECK(worst <= 1e-5);
+}
+
+int main()
+{
+    test_from_euler();
+    test_normalize();
+    test_rotate();
+    test_error();
+    test_error_rate();
+    return test_result("quaternion_test");
+}
@@ -0,0 +1,144 @@
+/**
+ * @file relay_autotune_test.cpp
+ * @brief Test dell'identificazione a relè su un impianto del primo ordine con ritardo (FOPDT).
+ *
+ * Per G(s) = K e^{-Ls} / (τs + 1) il punto critico si ricava in forma chiusa: ωu risolve
+ * ωL + atan(ωτ) = π, Tu = 2π/ωu e Ku = sqrt(1 + ωu²τ²) / K. L'esperimento deve ritrovare Tu
+ * con buona precisione; Ku è stimato con la funzione descrittiva, che trascura le armoniche
+ * superiori e lo sottostima di qualche decina di punti percentuali su questo impianto.
+ * L'ampiezza del relè è scelta perché l'oscillazione sia molto più ampia dell'isteresi, che
+ * altrimenti sposta il punto identificato verso periodi più lunghi.
+ */
+#include <cmath>
+#include <random>
+#include <vector>
+#include "RelayAutotune.h"
+#include "TestSupport.h"
+
+static const double PI = 3.14159265358979323846;
+
+/**
+ * Impianto FOPDT discretizzato con Eulero in avanti e ritardo a campioni interi.
+ */
+struct FopdtPlant
+{
+    double gain;
+    double tau;
+    double dt;
+    std::vector<double> delay; ///< Ingressi in attesa di raggiungere l'impianto.
+    size_t head = 0;
+    double y = 0;
+
+    FopdtPlant(double gain, double tau, double delay_s, double dt)
+        : gain(gain), tau(tau), dt(dt), delay(static_cast<size_t>(delay_s / dt + 0.5), 0.0) {}
+
+    double step(double u)
+    {
+        double delayed = u;
+        if (!delay.empty())
+        {
+            delayed = delay[head];
+            delay[head] = u;
+            head = (head + 1) % delay.size();
+        }
+        y += dt * (gain * delayed - y) / tau;
+        return y;
+    }
+};
+
+/**
+ * Punto critico teorico dell'impianto FOPDT (Newton su ωL + atan(ωτ) = π).
+ */
+static void critical_point(double gain, double tau, double delay, double &ku, double &tu)
+{
+    double w = 1;
+    for (int i = 0; i < 50; ++i)
+    {
+        double f = w * delay + std::atan(w * tau) - PI;
+        double df = delay + tau / (1 + w * w * tau * tau);
+        w -= f / df;
+    }
+    tu = 2 * PI / w;
+    ku = std::sqrt(1 + w * w * tau * tau) / gain;
+}
+
+/**
+ * Esegue l'esperimento a setpoint nullo; `noise` è l'ampiezza del rumore uniforme sulla misura.
+ */
+static AUTOTUNE_STATE run_experiment(RelayAutotune &tuner, FopdtPlant &plant, double noise, double max_time)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> jitter(-noise, noise);
+    double y = 0;
+    for (double t = 0; t < max_time && tuner.get_state() == AUTOTUNE_STATE::RUNNING; t += plant.dt)
+    {
+        float u = tuner.update(static_cast<float>(-(y + jitter(rng))), static_cast<float>(plant.dt));
+        y = plant.step(u);
+    }
+    return tuner.get_state();
+}
+
+static void test_identification(double gain, double tau, double delay)
+{
+    const double dt = 0.0005; // Passo fine rispetto a Tu: la discretizzazione aggiunge ritardo
+    double ku, tu;
+    critical_point(gain, tau, delay, ku, tu);
+
+    // Oscillazione attesa di ampiezza circa 0.5: a = 4d / (π Ku)
+    const float amplitude = static_cast<float>(0.5 * PI * ku / 4);
+    FopdtPlant plant(gain, tau, delay, dt);
+    RelayAutotune tuner(amplitude, 0.01f, 4, 30);
+    tuner.start(amplitude, 0.01f);
+    CHECK(run_experiment(tuner, plant, 0, 60) == AUTOTUNE_STATE::DONE);
+
+    const AutotuneResult &result = tuner.get_result();
+    std::printf("K=%g tau=%g L=%g: Ku %.3f (true %.3f), Tu %.4f (true %.4f)\n", gain, tau, delay,
+                result.ku, ku, result.tu, tu);
+    CHECK_NEAR(result.tu, tu, 0.05 * tu);
+    CHECK_NEAR(result.ku, ku, 0.25 * ku);
+
+    // Regole di Ziegler-Nichols applicate alla stima
+    CHECK_NEAR(result.kp, 0.6 * result.ku, 1e-3 * result.kp);
+    CHECK_NEAR(result.ki, 2 * result.kp / result.tu, 1e-3 * result.ki);
+    CHECK_NEAR(result.kd, result.kp * result.tu / 8, 1e-3 * result.kd);
+}
+
+static void test_noise_below_hysteresis()
+{
+    // Rumore inferiore all'isteresi: niente commutazioni spurie, stesso periodo
+    const double gain = 2, tau = 0.3, delay = 0.05;
+    double ku, tu;
+    critical_point(gain, tau, delay, ku, tu);
+
+    FopdtPlant plant(gain, tau, delay, 0.002);
+    const float amplitude = static_cast<float>(PI * ku / 4);
+    RelayAutotune tuner(amplitude, 0.05f, 4, 30);
+    tuner.start(amplitude, 0.05f);
+    CHECK(run_experiment(tuner, plant, 0.02, 60) == AUTOTUNE_STATE::DONE);
+    CHECK_NEAR(tuner.get_result().tu, tu, 0.10 * tu);
+}
+
+static void test_timeout_and_stop()
+{
+    // Un impianto che non risponde non oscilla: l'esperimento deve fallire allo scadere del timeout
+    FopdtPlant dead(0, 0.3, 0.05, 0.002);
+    RelayAutotune tuner(1, 0.01f, 4, 2);
+    tuner.start(1, 0.01f);
+    CHECK(run_experiment(tuner, dead, 0, 10) == AUTOTUNE_STATE::FAILED);
+
+    // Dopo stop() il relè non comanda più nulla
+    tuner.start(1, 0.01f);
+    CHECK(tuner.get_state() == AUTOTUNE_STATE::RUNNING);
+    tuner.stop();
+    CHECK(tuner.get_state() == AUTOTUNE_STATE::IDLE);
+    CHECK(tuner.update(1, 0.002f) == 0);
+}
+
+int main()
+{
+    test_identification(2, 0.3, 0.05);
+    test_identification(0.5, 0.1, 0.02);
+    test_noise_below_hysteresis();
+    test_timeout_and_stop();
+    return test_result("relay_autotune_test");
+}
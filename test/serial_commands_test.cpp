@@ -0,0 +1,79 @@
+/**
+ * @file serial_commands_test.cpp
+ * @brief Test del lettore dei comandi seriali: instradamento, argomenti, righe non valide.
+ */
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include "Logger.h"
+#include "SerialCommands.h"
+#include "TestSupport.h"
+
+/**
+ * Comandi ricevuti da un gestore di prova.
+ */
+struct Recorder
+{
+    std::vector<std::string> arguments;
+    bool accept = true; ///< Valore restituito dal gestore.
+};
+
+static bool record_command(void *context, const char *arguments)
+{
+    Recorder *recorder = static_cast<Recorder *>(context);
+    recorder->arguments.push_back(arguments);
+    return recorder->accept;
+}
+
+static size_t unknown()
+{
+    return Logger::getInstance().count(LOG_ID::SERIAL_COMMAND_UNKNOWN);
+}
+
+int main()
+{
+    SerialCommands &commands = SerialCommands::getInstance();
+    Recorder first, second;
+    CHECK(commands.add("first", record_command, &first));
+    CHECK(commands.add("second", record_command, &second));
+    CHECK(!commands.add("with space", record_command, &first));
+
+    // Nome fino al primo spazio, il resto come argomenti; \r\n e righe vuote ignorati
+    Serial.input = "first a b\r\nsecond\n\nfirst  x\n";
+    commands.poll();
+    CHECK(first.arguments.size() == 2);
+    CHECK(first.arguments[0] == "a b");
+    CHECK(first.arguments[1] == " x");
+    CHECK(second.arguments.size() == 1);
+    CHECK(second.arguments[0].empty());
+    CHECK(unknown() == 0);
+
+    // Una riga può arrivare in più letture
+    Serial.input += "sec";
+    commands.poll();
+    CHECK(second.arguments.size() == 1);
+    Serial.input += "ond 5\n";
+    commands.poll();
+    CHECK(second.arguments.size() == 2 && second.arguments[1] == "5");
+
+    // Comando sconosciuto, argomenti rifiutati dal gestore, prefisso di un nome registrato
+    second.accept = false;
+    Serial.input += "third 1\nsecond bad\nfir\n";
+    commands.poll();
+    CHECK(unknown() == 3);
+    CHECK(second.arguments.size() == 3);
+
+    // Una riga troppo lunga viene scartata per intero, senza eseguirne l'inizio
+    Serial.input += "first " + std::string(SERIAL_COMMAND_SIZE, 'y') + "\nfirst ok\n";
+    commands.poll();
+    CHECK(unknown() == 4);
+    CHECK(first.arguments.size() == 3 && first.arguments[2] == "ok");
+
+    // Registro pieno
+    Recorder extra;
+    for (int i = 2; i < SERIAL_COMMAND_HANDLERS; ++i)
+        CHECK(commands.add("extra", record_command, &extra));
+    CHECK(!commands.add("overflow", record_command, &extra));
+
+    return test_result("serial_commands_test");
+}
@@ -0,0 +1,247 @@
+/**
+ * @file spsc_queue_test.cpp
+ * @brief Test della coda SPSC: ordine, overflow, accesso sul posto e concorrenza.
+ *
+ * I casi a singolo thread coprono i limiti dell'interfaccia (indici oltre la capacità, coda
+ * piena, `prepare` senza `commit`, `peek` e `pop` oltre la dimensione, capacità 0). La prova
+ * con due thread fa girare produttore e consumatore in parallelo: compilata con
+ * ThreadSanitizer, verifica anche che gli ordinamenti di memoria pubblichino gli elementi.
+ */
+#include <thread>
+#include "SPSCQueue.h"
+#include "TestSupport.h"
+
+#ifndef SPSC_STRESS_ITEMS
+#define SPSC_STRESS_ITEMS 1000000 ///< Elementi prodotti nella prova con due thread.
+#endif
+
+/**
+ * Elemento più grande di una parola, per rilevare letture di slot scritti a metà.
+ */
+struct Item
+{
+    uint32_t sequence;
+    uint32_t check; ///< Complemento di `sequence`.
+};
+
+/**
+ * Gli indici crescono oltre la capacità: l'ordine FIFO resta corretto per molti giri.
+ */
+static void test_wrap_around()
+{
+    SPSCQueue<uint32_t, 8> queue;
+    uint32_t next_in = 0, next_out = 0;
+    for (int round = 0; round < 1000; ++round)
+    {
+        const int burst = 1 + round % 8;
+        for (int i = 0; i < burst; ++i)
+            CHECK(queue.push(next_in++));
+        CHECK(queue.size() == static_cast<size_t>(burst));
+        uint32_t value;
+        while (queue.pop(value))
+            CHECK(value == next_out++);
+    }
+    CHECK(next_out == next_in);
+    CHECK(next_in > 100 * queue.capacity());
+    CHECK(queue.getDropped() == 0);
+}
+
+/**
+ * Con la coda piena il nuovo elemento viene scartato e contato; i vecchi restano intatti.
+ */
+static void test_full()
+{
+    SPSCQueue<uint32_t, 4> queue;
+    for (uint32_t i = 0; i < 4; ++i)
+        CHECK(queue.push(i));
+    CHECK(!queue.push(100));
+    CHECK(queue.prepare() == nullptr);
+    CHECK(queue.getDropped() == 2);
+    CHECK(queue.size() == 4);
+    CHECK(queue.getHighWater() == 4);
+
+    uint32_t value;
+    for (uint32_t i = 0; i < 4; ++i)
+        CHECK(queue.pop(value) && value == i);
+    CHECK(!queue.pop(value));
+
+    // Liberato uno slot, l'inserimento riprende
+    CHECK(queue.push(5));
+    CHECK(queue.front() != nullptr && *queue.front() == 5);
+    CHECK(queue.getDropped() == 2);
+}
+
+/**
+ * Uno slot preparato e non pubblicato resta invisibile al consumatore e viene riusato.
+ */
+static void test_prepare_without_commit()
+{
+    SPSCQueue<uint32_t, 4> queue;
+    uint32_t *slot = queue.prepare();
+    CHECK(slot != nullptr);
+    *slot = 7;
+    CHECK(queue.size() == 0);
+    CHECK(queue.front() == nullptr);
+    CHECK(queue.peek(0) == nullptr);
+
+    uint32_t *again = queue.prepare();
+    CHECK(again == slot);
+    *again = 8;
+    queue.commit();
+    CHECK(queue.size() == 1);
+    CHECK(*queue.front() == 8);
+    CHECK(queue.getDropped() == 0);
+}
+
+/**
+ * `peek` oltre la dimensione restituisce nullptr, `pop(n)` rimuove al più gli elementi presenti.
+ */
+static void test_peek_and_pop_bounds()
+{
+    SPSCQueue<uint32_t, 8> queue;
+    for (uint32_t i = 0; i < 5; ++i)
+        queue.push(10 + i);
+    for (size_t i = 0; i < 5; ++i)
+        CHECK(queue.peek(i) != nullptr && *queue.peek(i) == 10 + i);
+    CHECK(queue.peek(5) == nullptr);
+    CHECK(queue.peek(8) == nullptr);
+    CHECK(queue.peek(static_cast<size_t>(-1)) == nullptr);
+
+    queue.pop(static_cast<size_t>(2));
+    CHECK(queue.size() == 3 && *queue.front() == 12);
+    queue.pop(static_cast<size_t>(100));
+    CHECK(queue.size() == 0 && queue.front() == nullptr);
+    queue.pop();
+    CHECK(queue.size() == 0);
+
+    // Dopo lo svuotamento gli indici restano allineati
+    CHECK(queue.push(20));
+    CHECK(queue.size() == 1 && *queue.peek(0) == 20);
+}
+
+/**
+ * Senza memoria la coda ha capacità 0 e scarta ogni elemento; capacità non valide vengono rifiutate.
+ */
+static void test_attach()
+{
+    SPSCRing<uint32_t> ring;
+    CHECK(ring.capacity() == 0);
+    CHECK(!ring.push(1));
+    CHECK(ring.prepare() == nullptr);
+    CHECK(ring.getDropped() == 2);
+    CHECK(ring.front() == nullptr && ring.peek(0) == nullptr && ring.size() == 0);
+
+    uint32_t memory[16];
+    CHECK(!ring.attach(memory, 3));
+    CHECK(!ring.attach(memory, 1));
+    CHECK(!ring.attach(nullptr, 4));
+    CHECK(ring.attach(memory, 16));
+    CHECK(ring.capacity() == 16 && ring.getDropped() == 0);
+    for (uint32_t i = 0; i < 10; ++i)
+        CHECK(ring.push(i));
+    CHECK(ring.getHighWater() == 10);
+
+    // Tornando a capacità 0 gli elementi e le statistiche vengono azzerati
+    CHECK(ring.attach(nullptr, 0));
+    CHECK(ring.size() == 0 && ring.getHighWater() == 0);
+    CHECK(!ring.push(1));
+    CHECK(ring.getDropped() == 1);
+}
+
+/**
+ * Il massimo riempimento segue il picco, non il riempimento corrente.
+ */
+static void test_high_water()
+{
+    SPSCQueue<uint32_t, 16> queue;
+    const int fills[] = {3, 1, 9, 4, 16, 2};
+    size_t peak = 0;
+    for (int fill : fills)
+    {
+        for (int i = 0; i < fill; ++i)
+            queue.push(i);
+        peak = peak > static_cast<size_t>(fill) ? peak : static_cast<size_t>(fill);
+        CHECK(queue.getHighWater() == peak);
+        queue.pop(static_cast<size_t>(fill));
+    }
+    CHECK(queue.push(0) && queue.size() == 1);
+    CHECK(queue.getHighWater() == 16);
+}
+
+/**
+ * Produttore e consumatore in due thread: ogni elemento arriva una volta, in ordine e
+ * integro, oppure viene contato come scartato.
+ */
+static void test_two_threads()
+{
+    static SPSCQueue<Item, 64> queue;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < SPSC_STRESS_ITEMS; ++i)
+        {
+            // Con la coda piena l'elemento è perso; il produttore cede il processore per
+            // lasciar lavorare il consumatore, come il ciclo di controllo tra due periodi
+            if (i & 1)
+            {
+                if (!queue.push({i, ~i}))
+                    std::this_thread::yield();
+                continue;
+            }
+            Item *slot = queue.prepare();
+            if (slot == nullptr)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            slot->sequence = i;
+            slot->check = ~i;
+            queue.commit();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t received = 0, out_of_order = 0, torn = 0;
+    int64_t last = -1;
+    while (true)
+    {
+        const bool finished = done.load(std::memory_order_acquire);
+        // Lettura sul posto di un gruppo, poi rimozione in blocco
+        const size_t batch = queue.size();
+        for (size_t i = 0; i < batch; ++i)
+        {
+            const Item *item = queue.peek(i);
+            if (item->check != ~item->sequence)
+                torn++;
+            if (static_cast<int64_t>(item->sequence) <= last)
+                out_of_order++;
+            last = item->sequence;
+            received++;
+        }
+        queue.pop(batch);
+        if (finished && queue.size() == 0)
+            break;
+        if (batch == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    std::printf("two threads: %u received, %u dropped, high water %u of %zu\n", received, queue.getDropped(),
+                queue.getHighWater(), queue.capacity());
+    CHECK(torn == 0);
+    CHECK(out_of_order == 0);
+    CHECK(received + queue.getDropped() == SPSC_STRESS_ITEMS);
+    CHECK(queue.getHighWater() <= queue.capacity());
+}
+
+int main()
+{
+    test_wrap_around();
+    test_full();
+    test_prepare_without_commit();
+    test_peek_and_pop_bounds();
+    test_attach();
+    test_high_water();
+    test_two_threads();
+    return test_result("spsc_queue_test");
+}
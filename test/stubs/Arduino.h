@@ -0,0 +1,42 @@
+/**
+ * @file Arduino.h
+ * @brief Sostituto minimo del core Arduino per i test su host.
+ *
+ * Fornisce solo la seriale usata dai moduli sotto test: i byte in ingresso vengono letti da
+ * `input`, quelli inviati vengono accumulati in `output`.
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class HostSerial
+{
+public:
+    std::string input;    ///< Byte da ricevere.
+    size_t position = 0;  ///< Byte di `input` già letti.
+    std::string output;   ///< Byte inviati.
+
+    int available() const { return static_cast<int>(input.size() - position); }
+
+    int read() { return position < input.size() ? static_cast<uint8_t>(input[position++]) : -1; }
+
+    size_t write(const uint8_t *data, size_t size)
+    {
+        output.append(reinterpret_cast<const char *>(data), size);
+        return size;
+    }
+
+    size_t println(const char *text)
+    {
+        output.append(text);
+        output.append("\r\n");
+        return output.size();
+    }
+};
+
+inline HostSerial Serial; ///< Seriale sostitutiva.
+
+#endif // ARDUINO_H
@@ -0,0 +1,49 @@
+/**
+ * @file Logger.h
+ * @brief Logger sostitutivo per i test su host.
+ *
+ * Ha la stessa interfaccia del `Logger` del firmware usata dai moduli sotto test, senza code,
+ * task e rete: conta i messaggi della tabella e ricorda l'ultimo testo libero.
+ */
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include "LogMessages.h"
+
+class Logger
+{
+public:
+    size_t events[static_cast<size_t>(LOG_ID::COUNT)] = {}; ///< Messaggi ricevuti, per identificativo.
+    std::string lastText;                                    ///< Ultimo messaggio in testo libero.
+    size_t serialAcquired = 0;                               ///< Chiamate ad `acquireSerial`.
+    bool serialOwned = false;                                ///< La seriale è presa per una scrittura diretta.
+
+    static Logger &getInstance()
+    {
+        static Logger instance;
+        return instance;
+    }
+
+    void log(LogLevel, const std::string &message, bool = true) { lastText = message; }
+
+    template <LOG_ID Id, typename... Args>
+    void logEvent(Args...) { events[static_cast<size_t>(Id)]++; }
+
+    void logEvent(LOG_ID id) { events[static_cast<size_t>(id)]++; }
+
+    void acquireSerial()
+    {
+        serialAcquired++;
+        serialOwned = true;
+    }
+
+    void releaseSerial() { serialOwned = false; }
+
+    /**
+     * @brief Restituisce quante volte è stato emesso un messaggio.
+     */
+    size_t count(LOG_ID id) const { return events[static_cast<size_t>(id)]; }
+};
+
+#endif // LOGGER_H
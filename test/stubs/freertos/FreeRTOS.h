@@ -0,0 +1,18 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Tipi di FreeRTOS usati dai moduli sotto test su host.
+ */
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+
+#define pdPASS 1
+#define portTICK_PERIOD_MS 1
+
+#endif // FREERTOS_H
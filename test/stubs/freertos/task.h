@@ -0,0 +1,20 @@
+/**
+ * @file task.h
+ * @brief Task di FreeRTOS sostituiti per i test su host.
+ *
+ * Nessun task viene creato: i test chiamano direttamente le funzioni di aggiornamento.
+ */
+#ifndef FREERTOS_TASK_H
+#define FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *, uint32_t, void *, UBaseType_t,
+                                          TaskHandle_t *, BaseType_t)
+{
+    return pdPASS;
+}
+
+inline void vTaskDelay(TickType_t) {}
+
+#endif // FREERTOS_TASK_H
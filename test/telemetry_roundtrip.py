@@ -0,0 +1,58 @@
+"""
+Confronto tra la codifica della telemetria del firmware e il decodificatore del server.
+
+Legge il file scritto da test/bench/telemetry_encoder_bench.cpp: righe `datagram <esadecimale>`
+(uno schema, poi datagrammi DELTA), ciascuna seguita dalle righe `row <csv>` che il server deve
+ricavarne. I datagrammi passano da server/telemetry_stream.py (`decode_schema`, `decode_delta`)
+come in ricezione; il test fallisce alla prima riga diversa.
+
+    python3 test/telemetry_roundtrip.py telemetry_samples.txt
+"""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "server"))
+
+import telemetry_stream  # noqa: E402
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("Uso: telemetry_roundtrip.py <file dei campioni>")
+
+    decoder = telemetry_stream.StreamDecoder()
+    decoded, expected = [], []
+    schemas = frames = 0
+    with open(sys.argv[1], encoding="ascii") as f:
+        for number, line in enumerate(f, start=1):
+            kind, _, value = line.rstrip("\n").partition(" ")
+            if kind == "datagram":
+                frame_type, _, items = decoder.decode_frame(bytes.fromhex(value))
+                if frame_type == telemetry_stream.FRAME_SCHEMA:
+                    schemas += 1
+                elif frame_type == telemetry_stream.FRAME_DELTA:
+                    if items is None:
+                        sys.exit(f"riga {number}: datagramma DELTA senza schema")
+                    decoded.extend(",".join(row) for row in items)
+                    frames += 1
+                else:
+                    sys.exit(f"riga {number}: tipo di datagramma inatteso {frame_type}")
+            elif kind == "row":
+                expected.append(value)
+            else:
+                sys.exit(f"riga {number}: voce sconosciuta {kind!r}")
+
+    if schemas != 1 or frames == 0:
+        sys.exit(f"{schemas} schemi e {frames} datagrammi DELTA: campioni incompleti")
+    for i, (got, want) in enumerate(zip(decoded, expected)):
+        if got != want:
+            sys.exit(f"riga decodificata {i} diversa:\n  server:   {got}\n  firmware: {want}")
+    if len(decoded) != len(expected):
+        sys.exit(f"{len(decoded)} righe decodificate, {len(expected)} attese")
+
+    print(f"telemetry_roundtrip: {len(decoded)} rows in {frames} datagrams match")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+"""
+Lettura e decodifica del blackbox del controller di volo.
+
+Il blackbox registra un record per ciclo di controllo in blocchi da 4096 byte (vedi
+include/Blackbox.h): header nel primo slot (magic "BBX1", sessione, conteggio, dimensione
+del record, CRC-32, flag), poi fino a 31 record da 128 byte.
+
+Comandi:
+    python3 tools/blackbox.py read --port /dev/ttyACM0 --output volo.bin
+        invia `blackbox dump` sulla seriale (da disarmati) e salva i blocchi (richiede pyserial)
+    python3 tools/blackbox.py decode volo.bin --output volo.csv [--session N]
+        verifica i blocchi e scrive un CSV con una riga per ciclo
+
+`decode` accetta sia il dump della seriale sia un'immagine della partizione o il file usato
+su host al posto della flash. I blocchi sono allineati a 4096 byte: quelli cancellati (header
+a 0xFF) vengono saltati, qualsiasi altro blocco con magic, header o CRC non validi è un errore
+e la decodifica termina senza scrivere il CSV. Durante il dump il firmware sospende i log
+sulla seriale, quindi un blocco non valido indica una trasmissione o una memoria corrotta.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import zlib
+
+BLOCK_SIZE = 4096
+BLOCK_MAGIC = b"BBX1"
+BLOCK_RECOVERED = 0x01
+
+HEADER = struct.Struct("<4sIHHII")
+# TelemetryRecord (timestamp, ciclo, IMU, ricevitore, output, RPM, flag), poi durata del
+# ciclo, record scartati, stato, modalità di assistenza, modalità di controllo, errori
+RECORD = struct.Struct("<II11f10f4ffIIIbBBB")
+
+VALUES = ["G_X", "G_Y", "G_Z", "Ac_X", "Ac_Y", "Ac_Z", "Q_W", "Q_X", "Q_Y", "Q_Z", "V",
+          "x", "y", "throttle", "z", "swa", "swb", "swc", "swd", "vra", "vrb",
+          "out_x", "out_y", "out_z", "out_throttle", "RPM"]
+COLUMNS = (["session", "cycle", "t_us", "flags"] + VALUES +
+           ["loop_us", "dropped", "state", "assist_mode", "controller_mode", "errors"])
+
+
+def find_blocks(data):
+    """Restituisce i blocchi validi come lista di (sessione, flag, record decodificati) e gli errori."""
+    if len(data) % BLOCK_SIZE:
+        return [], [f"dimensione di {len(data)} byte non multipla di un blocco ({BLOCK_SIZE} byte)"]
+
+    blocks, errors = [], []
+    for offset in range(0, len(data), BLOCK_SIZE):
+        if data[offset:offset + HEADER.size] == b"\xff" * HEADER.size:
+            continue  # Blocco cancellato
+        magic, session, count, record_size, crc, flags = HEADER.unpack_from(data, offset)
+        start = offset + RECORD.size
+        end = start + count * RECORD.size
+        if magic != BLOCK_MAGIC:
+            errors.append(f"blocco a {offset}: magic non valido")
+        elif record_size != RECORD.size or not 0 < count < BLOCK_SIZE // RECORD.size:
+            errors.append(f"blocco a {offset}: header non valido ({count} record da {record_size} byte)")
+        elif zlib.crc32(data[start:end]) != crc:
+            errors.append(f"blocco a {offset}: CRC errato")
+        else:
+            records = [RECORD.unpack_from(data, start + i * RECORD.size) for i in range(count)]
+            blocks.append((session, flags, records))
+    return blocks, errors
+
+
+def record_row(session, fields):
+    """Converte un record nella riga del CSV."""
+    timestamp_us, cycle = fields[0], fields[1]
+    values = fields[2:28]
+    flags, loop_us, dropped, state, assist_mode, controller_mode, errors = fields[28:]
+    return ([session, cycle, timestamp_us, flags] + [f"{v:.3f}" for v in values] +
+            [loop_us, dropped, state, assist_mode, controller_mode, errors])
+
+
+def decode(args):
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    blocks, errors = find_blocks(data)
+    if errors:
+        for error in errors:
+            print(error, file=sys.stderr)
+        sys.exit(f"{args.input}: {len(errors)} errori, dump o memoria corrotti")
+    if args.session is not None:
+        blocks = [b for b in blocks if b[0] == args.session]
+
+    # Riepilogo per sessione: cicli mancanti (record scartati o blocchi persi) e durata massima del ciclo
+    summary = {}
+    rows = 0
+    with open(args.output, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(COLUMNS)
+        for session, flags, records in blocks:
+            s = summary.setdefault(session, {"records": 0, "missing": 0, "recovered": 0, "max_loop_us": 0,
+                                             "last_cycle": None})
+            s["recovered"] += bool(flags & BLOCK_RECOVERED)
+            for fields in records:
+                cycle, loop_us = fields[1], fields[29]
+                if s["last_cycle"] is not None and cycle > s["last_cycle"] + 1:
+                    s["missing"] += cycle - s["last_cycle"] - 1
+                s["last_cycle"] = cycle
+                s["records"] += 1
+                s["max_loop_us"] = max(s["max_loop_us"], loop_us)
+                writer.writerow(record_row(session, fields))
+                rows += 1
+
+    for session, s in sorted(summary.items()):
+        print(f"Sessione {session}: {s['records']} record, {s['missing']} cicli mancanti, "
+              f"ciclo più lungo {s['max_loop_us']} µs, {s['recovered']} blocchi ricostruiti")
+    print(f"{len(blocks)} blocchi, {rows} righe scritte in {args.output}")
+
+
+def read(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial non installato: pip install pyserial")
+
+    with serial.Serial(args.port, args.baud, timeout=args.timeout) as port:
+        port.reset_input_buffer()
+        port.write(b"blackbox dump\n")
+
+        # Attende l'intestazione "BLACKBOX DUMP <blocchi> <dimensione>"
+        while True:
+            line = port.readline()
+            if not line:
+                sys.exit("Nessuna risposta dal controller (disarmato e blackbox attivo?)")
+            if line.startswith(b"BLACKBOX DUMP"):
+                blocks, block_size = (int(v) for v in line.split()[2:4])
+                break
+
+        # I blocchi sono binari: si legge fino al marcatore di chiusura, che segue almeno `expected` byte
+        expected = blocks * block_size
+        end = b"BLACKBOX END"
+        data = bytearray()
+        while data.find(end, expected) < 0:
+            chunk = port.read(port.in_waiting or 1)
+            if not chunk:
+                break
+            data += chunk
+            print(f"\r{min(len(data), expected) * 100 // max(1, expected)}%", end="", file=sys.stderr)
+        print(file=sys.stderr)
+
+    marker = data.find(end, expected)
+    if marker < 0:
+        sys.exit(f"Dump incompleto: {len(data)} di {expected} byte, manca la chiusura")
+    data = data[:marker]
+    if len(data) != expected:
+        sys.exit(f"Dump non valido: {len(data)} byte invece di {expected}")
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print(f"{len(data)} byte salvati in {args.output} ({blocks} blocchi attesi)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Lettura e decodifica del blackbox del controller di volo.")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    read_parser = commands.add_parser("read", help="Scarica i blocchi dalla seriale.")
+    read_parser.add_argument("--port", required=True, help="Porta seriale del controller.")
+    read_parser.add_argument("--baud", type=int, default=115200, help="Velocità della seriale.")
+    read_parser.add_argument("--timeout", type=float, default=5.0, help="Timeout di lettura (s).")
+    read_parser.add_argument("--output", required=True, help="File binario di destinazione.")
+    read_parser.set_defaults(handler=read)
+
+    decode_parser = commands.add_parser("decode", help="Converte i blocchi in CSV.")
+    decode_parser.add_argument("input", help="Dump della seriale, immagine della partizione o file host.")
+    decode_parser.add_argument("--output", required=True, help="File CSV di destinazione.")
+    decode_parser.add_argument("--session", type=int, help="Decodifica solo la sessione indicata.")
+    decode_parser.set_defaults(handler=decode)
+
+    args = parser.parse_args()
+    args.handler(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,232 @@
+"""
+Generatore dei guadagni LQR per il controller di volo.
+
+Calcola offline la matrice K del regolatore u = -K (x - x_ref) a partire da un modello
+linearizzato della dinamica angolare del velivolo e scrive include/LQRGains.h.
+
+Stato x (6): errore di assetto in gradi (rollio, beccheggio, imbardata) e velocità angolari
+in gradi/s (p, q, r). Ingressi u (3): comandi degli assi X, Y, Z nelle unità dell'output del
+controller (±90).
+
+Il modello è discretizzato alla frequenza del loop e K si ottiene iterando l'equazione di
+Riccati discreta. Lo script usa solo la libreria standard.
+
+Uso:
+    python3 tools/lqr_gains.py                      # modello predefinito
+    python3 tools/lqr_gains.py --model modello.json --output include/LQRGains.h
+"""
+
+import argparse
+import json
+import os
+
+# Modello predefinito di un velivolo da addestramento (derivate per unità di stato/comando).
+# I valori vanno identificati sul velivolo reale (log di volo, autotuning a relè).
+DEFAULT_MODEL = {
+    "dt": 0.01,  # Periodo del loop (s)
+    # Smorzamenti e accoppiamenti delle velocità angolari (1/s)
+    "Lp": -8.0, "Lr": 1.5,     # Rollio: smorzamento, accoppiamento dallo yaw
+    "Mq": -6.0, "Mtheta": -4.0,  # Beccheggio: smorzamento, rigidezza statica
+    "Np": -0.8, "Nr": -2.0,    # Imbardata: accoppiamento dal rollio, smorzamento
+    # Efficacia dei comandi ((gradi/s²) per unità di comando)
+    "La": 12.0, "Lrud": 1.0,   # Alettoni e timone sul rollio
+    "Me": 10.0,                # Equilibratore sul beccheggio
+    "Na": -1.2, "Nrud": 6.0,   # Imbardata inversa degli alettoni, timone sullo yaw
+    # Pesi (regola di Bryson: 1 / valore massimo accettabile²)
+    "max_attitude_error": 10.0,  # gradi
+    "max_rate": 90.0,            # gradi/s
+    "max_command": 60.0,         # unità di comando
+}
+
+STATES = 6
+INPUTS = 3
+
+
+def zeros(rows, cols):
+    return [[0.0] * cols for _ in range(rows)]
+
+
+def identity(n):
+    m = zeros(n, n)
+    for i in range(n):
+        m[i][i] = 1.0
+    return m
+
+
+def mul(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(len(b))) for j in range(len(b[0]))] for i in range(len(a))]
+
+
+def add(a, b):
+    return [[a[i][j] + b[i][j] for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def sub(a, b):
+    return [[a[i][j] - b[i][j] for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def scale(a, k):
+    return [[v * k for v in row] for row in a]
+
+
+def transpose(a):
+    return [list(col) for col in zip(*a)]
+
+
+def inverse(a):
+    # Gauss-Jordan con pivot parziale
+    n = len(a)
+    m = [row[:] + ident for row, ident in zip(a, identity(n))]
+    for col in range(n):
+        pivot = max(range(col, n), key=lambda r: abs(m[r][col]))
+        if abs(m[pivot][col]) < 1e-12:
+            raise ValueError("Matrice singolare")
+        m[col], m[pivot] = m[pivot], m[col]
+        p = m[col][col]
+        m[col] = [v / p for v in m[col]]
+        for r in range(n):
+            if r != col:
+                f = m[r][col]
+                m[r] = [vr - f * vc for vr, vc in zip(m[r], m[col])]
+    return [row[n:] for row in m]
+
+
+def continuous_model(p):
+    """Restituisce le matrici A (6x6) e B (6x3) del modello continuo."""
+    a = zeros(STATES, STATES)
+    b = zeros(STATES, INPUTS)
+    # Cinematica: derivata dell'assetto = velocità angolare
+    for i in range(3):
+        a[i][3 + i] = 1.0
+    # Dinamica del rollio
+    a[3][3] = p["Lp"]
+    a[3][5] = p["Lr"]
+    b[3][0] = p["La"]
+    b[3][2] = p["Lrud"]
+    # Dinamica del beccheggio
+    a[4][1] = p["Mtheta"]
+    a[4][4] = p["Mq"]
+    b[4][1] = p["Me"]
+    # Dinamica dell'imbardata
+    a[5][3] = p["Np"]
+    a[5][5] = p["Nr"]
+    b[5][0] = p["Na"]
+    b[5][2] = p["Nrud"]
+    return a, b
+
+
+def discretize(a, b, dt, terms=20):
+    """Discretizzazione esatta (ZOH) con l'esponenziale della matrice aumentata [[A, B], [0, 0]]."""
+    n, m = len(a), len(b[0])
+    aug = zeros(n + m, n + m)
+    for i in range(n):
+        for j in range(n):
+            aug[i][j] = a[i][j] * dt
+        for j in range(m):
+            aug[i][n + j] = b[i][j] * dt
+    result = identity(n + m)
+    term = identity(n + m)
+    for k in range(1, terms):
+        term = scale(mul(term, aug), 1.0 / k)
+        result = add(result, term)
+    ad = [row[:n] for row in result[:n]]
+    bd = [row[n:] for row in result[:n]]
+    return ad, bd
+
+
+def dlqr(ad, bd, q, r, iterations=20000, tolerance=1e-10):
+    """Risolve l'equazione di Riccati discreta per iterazione e restituisce K (3x6)."""
+    p = [row[:] for row in q]
+    bt = transpose(bd)
+    at = transpose(ad)
+    for _ in range(iterations):
+        btp = mul(bt, p)
+        k = mul(inverse(add(r, mul(btp, bd))), mul(btp, ad))
+        p_next = add(q, mul(mul(at, p), sub(ad, mul(bd, k))))
+        delta = max(abs(p_next[i][j] - p[i][j]) for i in range(len(p)) for j in range(len(p)))
+        p = p_next
+        if delta < tolerance:
+            break
+    btp = mul(bt, p)
+    return mul(inverse(add(r, mul(btp, bd))), mul(btp, ad))
+
+
+def closed_loop_radius(ad, bd, k, iterations=2000):
+    """Stima del raggio spettrale di A - BK con il metodo delle potenze (< 1 se stabile)."""
+    acl = sub(ad, mul(bd, k))
+    v = [[1.0] for _ in range(len(acl))]
+    norm = 1.0
+    for _ in range(iterations):
+        w = mul(acl, v)
+        norm = max(abs(x[0]) for x in w) or 1e-30
+        v = [[x[0] / norm] for x in w]
+    return norm
+
+
+def write_header(path, k, model, radius):
+    rows = ",\n".join(
+        "    {" + ", ".join(f"{v:.6f}f" for v in row) + "}" for row in k)
+    params = ", ".join(f"{key}={value}" for key, value in model.items())
+    content = f"""/**
+ * @file LQRGains.h
+ * @brief Guadagni del regolatore LQR, generati da tools/lqr_gains.py. Non modificare a mano.
+ *
+ * Modello: {params}
+ * Raggio spettrale stimato in anello chiuso: {radius:.4f}
+ */
+
+#ifndef LQR_GAINS_H
+#define LQR_GAINS_H
+
+#define LQR_STATES 6 ///< Stati: errore di assetto (X, Y, Z, gradi) e velocità angolari (X, Y, Z, gradi/s).
+#define LQR_INPUTS 3 ///< Ingressi: comandi degli assi X, Y, Z.
+
+/**
+ * @brief Matrice dei guadagni K (ingressi × stati) del regolatore u = -K (x - x_ref).
+ */
+inline constexpr float LQR_GAINS[LQR_INPUTS][LQR_STATES] = {{
+{rows}}};
+
+#endif // LQR_GAINS_H
+"""
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(content)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description="Genera i guadagni LQR del controller di volo.")
+    parser.add_argument("--model", help="File JSON con i parametri del modello (sovrascrive i predefiniti).")
+    parser.add_argument("--output", default=os.path.join(root, "include", "LQRGains.h"), help="Header da generare.")
+    args = parser.parse_args()
+
+    model = dict(DEFAULT_MODEL)
+    if args.model:
+        with open(args.model, encoding="utf-8") as f:
+            model.update(json.load(f))
+
+    a, b = continuous_model(model)
+    ad, bd = discretize(a, b, model["dt"])
+
+    qa = 1.0 / model["max_attitude_error"] ** 2
+    qr = 1.0 / model["max_rate"] ** 2
+    ru = 1.0 / model["max_command"] ** 2
+    q = zeros(STATES, STATES)
+    for i in range(3):
+        q[i][i] = qa
+        q[3 + i][3 + i] = qr
+    r = scale(identity(INPUTS), ru)
+
+    k = dlqr(ad, bd, q, r)
+    radius = closed_loop_radius(ad, bd, k)
+    if radius >= 1.0:
+        raise SystemExit(f"Anello chiuso instabile (raggio spettrale {radius:.4f})")
+
+    write_header(args.output, k, model, radius)
+    print(f"Guadagni scritti in {args.output} (raggio spettrale {radius:.4f})")
+    for row in k:
+        print("  " + "  ".join(f"{v:9.4f}" for v in row))
+
+
+if __name__ == "__main__":
+    main()